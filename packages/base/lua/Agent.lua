@@ -158,7 +158,14 @@ Agent_ = {
 		end
 
 		if cell[placement] then
-			cell[placement]:add(self)
+			local agents = cell[placement].agents
+			local native = agents.placement_
+
+			if native then
+				native.agents[native.cObj_:enter(self, agents.index_)] = self
+			else
+				cell[placement]:add(self)
+			end
 		else
 			customError("Placement '"..placement.."' was not found in the Cell.")
 		end
@@ -355,6 +362,17 @@ Agent_ = {
 		self.cell = nil
 
 		local ags = cell[placement].agents
+		local native = ags.placement_
+
+		if native then
+			local slot = native.cObj_:leave(self)
+
+			if slot then
+				native.agents[slot] = nil
+			end
+
+			return true
+		end
 
 		if getn(ags) == 0 then
 			return true
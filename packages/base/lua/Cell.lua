@@ -288,10 +288,22 @@ Cell_ = {
 	-- print(cell.past.value)
 	-- @see CellularSpace:synchronize
 	synchronize = function(self)
-		self.past = {}
+		local past = self.past
+
+		if getmetatable(past) then -- attributes stored natively by the CellularSpace
+			self.cObj_:synchronize()
+
+			for k in pairs(past) do
+				if k ~= "cObj_" then past[k] = nil end
+			end
+		else
+			past = {}
+			self.past = past
+		end
+
 		for k, v in pairs(self) do
 			if not belong(k, {"past", "cObj_", "x", "y", "geom"}) then
-				self.past[k] = v
+				past[k] = v
 			end
 		end
 
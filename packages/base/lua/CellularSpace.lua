@@ -385,6 +385,8 @@ end
 
 local function checkCsv(self)
 	defaultTableValue(self, "sep", ",")
+	optionalTableArgument(self, "select", "table")
+	optionalTableArgument(self, "progress", "function")
 end
 
 local function checkPGM(self)
@@ -464,23 +466,15 @@ local function loadCsv(self)
 
 	self.cells = {}
 	self.cObj_:clear()
-	local file = self.file
-	local data = file:readTable(self.sep)
-	local cellIdCounter = 0
+
+	-- the file is parsed in C++, which also adds a sequential id to each row
+	local data = self.cObj_:readCsv(self.file.filename, self.sep, self.select, self.progress, true)
 	for i = 1, #data do
-		cellIdCounter = cellIdCounter + 1
-		data[i].id = tostring(cellIdCounter)
-		local cell = Cell(data[i])
-		self:add(cell)
-		self.cObj_:addCell(cell.x, cell.y, cell.cObj_)
+		self:add(Cell(data[i]))
 	end
-	return
 end
 
 local function loadPGM(self)
-	local i = 0
-	local j = 0
-
 	if self.yMin == nil then self.yMin = 100000 end
 	if self.xMin == nil then self.xMin = 100000 end
 	if self.xMax == nil then self.xMax = -self.xMin end
@@ -489,44 +483,23 @@ local function loadPGM(self)
 	self.cells = {}
 	self.cObj_:clear()
 
-	local file = self.file
-	local pgm = {}
-
-	pgm.comments = {}
-	pgm.type = file:read(self.sep)[1]
+	local pgm = self.cObj_:readPgm(self.file.filename, self.sep)
 
 	verify(pgm.type == "P2", "File '"..self.file.."' does not contain the PGM identifier 'P2' in its first line.")
 
-	local res = file:read(self.sep)
-	local len = #res
-	while len > 0 do
-		if res[1]:find("#", 1) then
-			if len > 1 then
-				table.remove(res, 1)
-				table.insert(pgm.comments, table.concat(res, " "))
-			end
-		elseif len == 2 and not pgm.size then
-			pgm.size = {tonumber(res[1]), tonumber(res[2])}
-		elseif len == 1 and not pgm.maximumValue then
-			pgm.maximumValue = tonumber(res[1])
-		else
-			j = 0
-			forEachElement(res, function(_, value)
-				local p = Cell {x = j, y = i, [self.attrname] = tonumber(value)}
-				self:add(p)
-				self.cObj_:addCell(p.x, p.y, p.cObj_)
-				j = j + 1
-			end)
+	local i = #pgm.lines
+	local j = 0
+	local attrname = self.attrname
 
-			i = i + 1
-		end
+	for y = 1, i do
+		local line = pgm.lines[y]
+		j = line.n
 
-		res = file:read(self.sep)
-		len = #res
+		for x = 1, j do
+			self:add(Cell{x = x - 1, y = y - 1, [attrname] = line[x]})
+		end
 	end
 
-	file:close()
-
 	if (j ~= pgm.size[1]) or (i ~= pgm.size[2]) then
 		customWarning("File '"..self.file.."' has a diffent size declared: expected '("..pgm.size[1]..", "..pgm.size[2]..")', got '("..j..", "..i..")'.")
 	end
@@ -741,7 +714,7 @@ registerCellularSpaceDriver{
 
 registerCellularSpaceDriver{
 	source = "csv",
-	optional = "sep",
+	optional = {"sep", "select", "progress"},
 	load = loadCsv,
 	check = checkCsv
 }
@@ -783,6 +756,120 @@ registerCellularSpaceDriver{
 	load = loadGdal
 }
 
+local function attachNativeCell(cs, cell, slot)
+	local attributes = cs.native_
+	local cObj = cell.cObj_
+	local mt = getmetatable(cell)
+
+	if not cs.nativeMetaTables_[mt] then
+		local index = mt.__index
+		local nativeMt = {}
+
+		for idx, value in pairs(mt) do
+			nativeMt[idx] = value
+		end
+
+		nativeMt.__index = function(mcell, key)
+			local attribute = attributes[key]
+			if attribute then
+				return mcell.cObj_:getAttribute(attribute)
+			elseif type(index) == "function" then
+				return index(mcell, key)
+			end
+
+			return index[key]
+		end
+
+		nativeMt.__newindex = function(mcell, key, value)
+			local attribute = attributes[key]
+			if attribute then
+				if type(value) ~= "number" then
+					incompatibleTypeError(key, "number", value)
+				end
+
+				mcell.cObj_:setAttribute(attribute, value)
+			else
+				rawset(mcell, key, value)
+			end
+		end
+
+		cs.nativeMetaTables_[mt] = nativeMt
+		cs.nativeMetaTables_[nativeMt] = nativeMt
+	end
+
+	cObj:setStore(cs.cObj_, slot)
+
+	local past = {cObj_ = cObj}
+
+	forEachElement(cell.past or {}, function(idx, value)
+		if not attributes[idx] then
+			past[idx] = value
+			cs.nativePastKeys_ = true
+		elseif type(value) == "number" then
+			cObj:setAttribute(attributes[idx], value, true)
+		end
+	end)
+
+	forEachElement(attributes, function(idx, attribute)
+		local value = rawget(cell, idx)
+
+		if value == nil then
+			value = 0
+		elseif type(value) ~= "number" then
+			customError("Attribute '"..idx.."' should be a number to be stored natively, got "..type(value)..".")
+		end
+
+		cObj:setAttribute(attribute, value)
+		rawset(cell, idx, nil)
+	end)
+
+	rawset(cell, "past", setmetatable(past, cs.nativePastMetaTable_))
+	setmetatable(cell, cs.nativeMetaTables_[mt])
+end
+
+local function createNativeAttributes(cs)
+	local attributes = {}
+
+	forEachElement(cs.native, function(_, value)
+		if type(value) ~= "string" then
+			customError("All values of 'native' should be 'string', got '"..type(value).."'.")
+		elseif belong(value, {"x", "y", "id", "past", "parent", "cObj_", "geom"}) then
+			customError("Attribute '"..value.."' cannot be stored natively.")
+		end
+
+		attributes[value] = cs.cObj_:addAttribute(value)
+	end)
+
+	cs.native_ = attributes
+	cs.nativeMetaTables_ = {}
+	cs.nativePastMetaTable_ = {
+		__index = function(past, key)
+			local attribute = attributes[key]
+			if attribute then
+				return past.cObj_:getAttribute(attribute, true)
+			end
+		end,
+		__newindex = function(past, key, value)
+			local attribute = attributes[key]
+			if attribute then
+				if type(value) ~= "number" then
+					incompatibleTypeError(key, "number", value)
+				end
+
+				past.cObj_:setAttribute(attribute, value, true)
+			else
+				-- synchronize() removes these attributes when they are not selected
+				cs.nativePastKeys_ = true
+				rawset(past, key, value)
+			end
+		end
+	}
+
+	for i, cell in ipairs(cs.cells) do
+		attachNativeCell(cs, cell, i - 1)
+	end
+end
+
 CellularSpace_ = {
 	type_ = "CellularSpace",
 	--- Add a new Cell to the CellularSpace. It will be the last Cell of the CellularSpace when one uses Utils:forEachCell().
@@ -805,12 +892,28 @@ CellularSpace_ = {
 		cell.parent = self
 		self.cObj_:addCell(cell.x, cell.y, cell.cObj_)
 		table.insert(self.cells, cell)
+
+		if self.native_ then
+			attachNativeCell(self, cell, #self.cells - 1)
+		end
+
 		self.yMin = math.min(self.yMin, cell.y)
 		self.xMin = math.min(self.xMin, cell.x)
 		self.xMax = math.max(self.xMax, cell.x)
 		self.yMax = math.max(self.yMax, cell.y)
-		self.index_id_ = nil
-		self.index_xy_ = nil
+
+		-- the indexes are updated instead of rebuilt, as cells are usually added in sequence
+		if self.index_xy_ then
+			if not self.index_xy_[cell.x] then
+				self.index_xy_[cell.x] = {}
+			end
+
+			self.index_xy_[cell.x][cell.y] = cell
+		end
+
+		if self.index_id_ then
+			self.index_id_[cell:getId()] = cell
+		end
 	end,
 	--- Create a Neighborhood for each Cell of the CellularSpace.
 	-- Most of the available strategies require that each Cell has
@@ -924,6 +1027,9 @@ CellularSpace_ = {
 		defaultTableValue(data, "strategy", "moore")
 		defaultTableValue(data, "inmemory", true)
 
+		-- built-in strategies without user-defined functions can be computed in C++
+		local native = belong(data.strategy, {"diagonal", "moore", "vonneumann"})
+
 		switch(data, "strategy"):caseof{
 			diagonal = function()
 				verifyUnnecessaryArguments(data, {"self", "wrap", "name", "strategy", "inmemory"})
@@ -952,6 +1058,8 @@ CellularSpace_ = {
 			mxn = function()
 				verifyUnnecessaryArguments(data, {"filter", "weight", "wrap", "name", "strategy", "m", "n", "target", "inmemory"})
 
+				native = data.filter == nil and data.weight == nil and (data.target == nil or data.target == self)
+
 				defaultTableValue(data, "filter", function() return true end)
 				defaultTableValue(data, "weight", function() return 1 end)
 				defaultTableValue(data, "target", self)
@@ -998,10 +1106,35 @@ CellularSpace_ = {
 
 		local func = data.func(self, data)
 
-		if data.inmemory then
+		native = native and data.inmemory and type(self) == "CellularSpace" and #self.cells > 0
+
+		if native then
+			forEachCell(self, function(cell)
+				cell:addNeighborhood(Neighborhood(), data.name)
+			end)
+
+			native = self.cObj_:createNeighborhood(data.name, data.strategy, {
+				self = data.self,
+				wrap = data.wrap,
+				m = data.m,
+				n = data.n,
+				xMin = self.xMin,
+				xMax = self.xMax,
+				yMin = self.yMin,
+				yMax = self.yMax
+			})
+		end
+
+		if native then
+			return
+		elseif data.inmemory then
 			forEachCell(self, function(cell)
 				cell:addNeighborhood(func(cell), data.name)
 			end)
+
+			if type(self) == "CellularSpace" then
+				self.cObj_:compactNeighborhood(data.name)
+			end
 		else
 			forEachCell(self, function(cell)
 				cell:addNeighborhood(func, data.name)
@@ -1025,6 +1158,10 @@ CellularSpace_ = {
 				forEachCell(mtarget, function(cell)
 					cell:addNeighborhood(mfunc(cell), data2.name)
 				end)
+
+				if type(mtarget) == "CellularSpace" then
+					mtarget.cObj_:compactNeighborhood(data2.name)
+				end
 			else
 				forEachCell(mtarget, function(cell)
 					cell:addNeighborhood(mfunc, data2.name)
@@ -1199,6 +1336,10 @@ CellularSpace_ = {
 		elseif ext == "gpm" then
 			loadNeighborhoodGPM(self, data)
 		end
+
+		if type(self) == "CellularSpace" then
+			self.cObj_:compactNeighborhood(data.name)
+		end
 	end,
 	--- Notify every Observer connected to the CellularSpace.
 	-- @arg modelTime A number representing the notification time. The default value is zero.
@@ -1437,7 +1578,11 @@ CellularSpace_ = {
 	-- @arg values A string or a vector of strings with the attributes to be synchronized. If
 	-- empty, TerraME synchronizes every attribute of the Cells but the (x, y) coordinates.
 	-- If the CellularSpace has an instance and it implements Cell:on_synchronize() then it
-	-- will be called for each Cell.
+	-- will be called for each Cell. Attributes stored natively (see argument native of
+	-- CellularSpace) are copied at once, without creating a new past for each Cell.
+	-- The other attributes of the past are replaced by the selected ones, as without
+	-- native attributes, while the native attributes that are not selected keep their
+	-- past values.
 	-- @usage cell = Cell{
 	--     forest = Random{min = 0, max = 1}
 	-- }
@@ -1460,6 +1605,10 @@ CellularSpace_ = {
 					table.insert(values, k)
 				end
 			end
+
+			forEachOrderedElement(self.native_ or {}, function(k)
+				table.insert(values, k)
+			end)
 		end
 
 		if type(values) == "string" then
@@ -1468,6 +1617,43 @@ CellularSpace_ = {
 			incompatibleTypeError(1, "string, table or nil", values)
 		end
 
+		if self.native_ then
+			local natives = {}
+			local clear = self.nativePastKeys_
+			local s = "return function(cell)\n"
+			s = s.."local past = cell.past\n"
+
+			-- as a new past would do, the attributes that are not stored natively
+			-- and are not selected are removed
+			if clear then
+				s = s.."for k in pairs(past) do if k ~= 'cObj_' then past[k] = nil end end\n"
+				self.nativePastKeys_ = nil
+			end
+
+			for _, v in pairs(values) do
+				if type(v) ~= "string" then
+					customError("Argument 'values' should contain only strings.")
+				elseif self.native_[v] then
+					table.insert(natives, self.native_[v])
+				else
+					s = s.."past."..v.." = cell."..v.."\n"
+				end
+			end
+
+			s = s.."if type(cell.on_synchronize) == 'function' then cell:on_synchronize() end "
+			s = s.."end"
+
+			if #natives > 0 then
+				self.cObj_:synchronizeAttributes(table.unpack(natives))
+			end
+
+			if clear or #natives < #values or (self.cells[1] and self.cells[1].on_synchronize ~= Cell_.on_synchronize) then
+				forEachCell(self, load(s)())
+			end
+
+			return
+		end
+
 		local s = "return function(cell)\n"
 		s = s.."cell.past = {"
 
@@ -1512,6 +1698,10 @@ metaTableCellularSpace_ = {
 -- @arg data.project A string with the name of the TerraLib project to be used.
 -- If this name does not ends with ".tview", this extension will be added to the name
 -- of the file. It can also be a terralib::Project.
+-- @arg data.select A vector of strings with the columns to be read from a csv file. The
+-- default value is to read all the columns.
+-- @arg data.progress A function that gets the percentage of a csv file already read as
+-- argument. It is useful to follow the loading of large files.
 -- @arg data.attrname A string with an attribute name. It is useful for files that have
 -- only one attribute value for each cell but no attribute name. The default value is
 -- the name of the file being read.
@@ -1528,6 +1718,11 @@ metaTableCellularSpace_ = {
 -- argument can also be a function that gets a Cell as argument and returns two values
 -- with the (x, y) location.
 -- @arg data.... Any other attribute or function for the CellularSpace.
+-- @arg data.native A vector of strings with the names of numeric attributes that will be
+-- stored in contiguous arrays owned by the CellularSpace instead of in the Cells. They are
+-- still accessed as cell.attribute and cell.past.attribute, but CellularSpace:synchronize()
+-- copies them at once. These attributes must always be numbers. Cells without the
+-- attribute start with zero.
 -- @arg data.instance A Cell with the description of attributes and functions.
 -- When using this argument, each Cell will have attributes and functions according to the
 -- instance. It also calls Cell:init() from the instance for each of its Cells.
@@ -1558,7 +1753,7 @@ metaTableCellularSpace_ = {
 -- "pgm" & Load from a text file where Cells are stored as numbers with its attribute value.
 -- & & sep, attrname, as \
 -- "csv" & Load from a Comma-separated value (.csv) file. Each column will become an attribute. It
--- requires at least two attributes: x and y. & file & source, sep, as, geometry, ...\
+-- requires at least two attributes: x and y. & file & source, sep, select, progress, as, geometry, ...\
 -- "proj" & Load from a layer within a TerraLib project. See the documentation of package terralib for
 -- more information. & project, layer & source, geometry, as, ... \
 -- "shp" & Load data from a shapefile. It requires three files with the same name and
@@ -1591,6 +1786,7 @@ function CellularSpace(data)
 	verifyNamedTable(data)
 
 	optionalTableArgument(data, "as", "table")
+	optionalTableArgument(data, "native", "table")
 
 	if data.as then
 		forEachElement(data.as, function(idx, value)
@@ -1708,15 +1904,7 @@ function CellularSpace(data)
 
 				if attribute ~= "x" and attribute ~= "y" then
 					data[attribute] = function(cs)
-						local quantity = 0
-						forEachCell(cs, function(mcell)
-							if type(mcell[attribute]) ~= "number" then
-								incompatibleTypeError(attribute, "number", mcell[attribute])
-							end
-
-							quantity = quantity + mcell[attribute]
-						end)
-						return quantity
+						return cs.cObj_:reduce(attribute, "sum")
 					end
 				end
 			elseif mtype == "boolean" then
@@ -1726,13 +1914,7 @@ function CellularSpace(data)
 				end
 
 				data[attribute] = function(cs)
-					local quantity = 0
-					forEachCell(cs, function(mcell)
-						if mcell[attribute] then
-							quantity = quantity + 1
-						end
-					end)
-					return quantity
+					return cs.cObj_:reduce(attribute, "count")
 				end
 			elseif mtype == "string" or (mtype == "Random" and (value.distrib == "categorical" or (value.distrib == "discrete" and type(value[1]) == "string"))) then
 				if data[attribute] then
@@ -1741,16 +1923,7 @@ function CellularSpace(data)
 				end
 
 				data[attribute] = function(cs)
-					local result = {}
-					forEachCell(cs, function(mcell)
-						local mvalue = mcell[attribute]
-						if result[mvalue] then
-							result[mvalue] = result[mvalue] + 1
-						else
-							result[mvalue] = 1
-						end
-					end)
-					return result
+					return cs.cObj_:reduce(attribute, "histogram")
 				end
 			end
 		end)
@@ -1842,6 +2015,10 @@ function CellularSpace(data)
 		forEachCell(data, load(s)())
 	end
 
+	if data.native then
+		createNativeAttributes(data)
+	end
+
 	return data
 end
 
@@ -52,6 +52,69 @@ local metaTableDataFrameItem_ = {
 	end
 }
 
+-- rows of DataFrames created with native = true only store their position,
+-- the values are read from and written to the columns stored in C++
+local metaTableNativeDataFrameItem_ = {
+	__newindex = function(self, idx, value)
+		local parent = self.parent
+
+		parent.cObj_:set(idx, self.pos, value)
+		parent.columns_[idx] = true
+	end,
+	__index = function(self, idx)
+		local parent = self.parent
+
+		if not parent.columns_[idx] then
+			return parent.instance[idx]
+		end
+
+		return parent.cObj_:get(idx, self.pos)
+	end,
+	__tostring = function(self)
+		local values = {}
+		forEachOrderedElement(self.parent:columns(), function(idx)
+			values[idx] = self.parent.cObj_:get(idx, self.pos)
+		end)
+
+		return vardump(values)
+	end,
+	__len = function(self)
+		return getn(self.parent:columns())
+	end
+}
+
+local metaTableNativeColumn_ = {
+	__index = function(self, idx)
+		return self.parent.cObj_:get(self.name, idx)
+	end,
+	__newindex = function(self, idx, value)
+		self.parent.cObj_:set(self.name, idx, value)
+	end,
+	__len = function(self)
+		return self.parent.cObj_:size()
+	end,
+	__pairs = function(self)
+		local parent = self.parent
+		local cObj = parent.cObj_
+		local name = self.name
+		local size = cObj:size()
+		local row = 0
+
+		return function()
+			while row < size do
+				local position = parent.first_ + row * parent.step_
+				local value = cObj:get(name, position)
+
+				row = row + 1
+
+				if value ~= nil then
+					return position, value
+				end
+			end
+		end, self, nil
+	end
+}
+
 --- Add a new row.
 -- @arg row A named table with the values of the row to be added.
 -- @arg idx An optional number describing the position of the row. As
@@ -112,7 +175,24 @@ local function remove(self, idx)
 	end)
 end
 
---- Save the DataFrame to a given file.
+-- copy the columns of a DataFrame to a new luaDataFrame
+local function createNativeColumns(columns, first, step, quantity)
+	local cObj = TeDataFrame()
+
+	cObj:config(first, step, quantity)
+
+	forEachOrderedElement(columns, function(idx, values)
+		cObj:setColumn(idx, values)
+	end)
+
+	return cObj
+end
+
+--- Save the DataFrame to a given file. Files with extension '.lua' store a Lua
+-- table that can be loaded with DataFrame{file = filename}. Files with extension
+-- '.csv' store one line for each row, with the columns in alphabetical order.
+-- Files with extension '.tmck' store the columns in a binary format, which is
+-- faster to save and load than the others.
 -- @arg filename A mandatory string with the file name.
 -- @usage filename = "dump.lua"
 -- df = DataFrame{x = {1}, y = {2}}
@@ -123,9 +203,29 @@ local function save(self, filename)
 	mandatoryArgument(1, "string", filename)
 
 	local file = File(filename)
-	local stbl = "return"..vardump(self.data)
-	file:write(stbl)
-	file:close()
+	local extension = file:extension()
+
+	if extension == "lua" then
+		local data = self.data
+
+		if self.cObj_ then
+			data = {}
+
+			forEachElement(self.columns_, function(idx)
+				data[idx] = self.cObj_:getColumn(idx)
+			end)
+		end
+
+		local stbl = "return"..vardump(data)
+		file:write(stbl)
+		file:close()
+	elseif extension == "csv" or extension == "tmck" then
+		local cObj = self.cObj_ or createNativeColumns(self.data, self.first_, self.step_, #self)
+
+		cObj:save(file.filename)
+	else
+		invalidFileExtensionError(1, extension)
+	end
 end
 
 --- Return the columns of the DataFrame. It is a named table whose indexes are
@@ -144,12 +244,208 @@ local function rows(self)
 	return self.rows_
 end
 
+-- return the values of a numeric column of a DataFrame stored in Lua
+local function numericValues(self, column)
+	local values = {}
+
+	forEachElement(self.data[column], function(_, value, mtype)
+		if mtype ~= "number" then
+			customError("Column '"..column.."' should have numeric values, got "..mtype..".")
+		end
+
+		table.insert(values, value)
+	end)
+
+	return values
+end
+
+local function checkColumn(self, column)
+	mandatoryArgument(1, "string", column)
+
+	if not self.columns_[column] then
+		valueNotFoundError(1, column)
+	end
+end
+
+--- Return the sum of the values of a numeric column. Rows without value are ignored.
+-- @arg column A string with the name of the column.
+-- @usage df = DataFrame{x = {1, 2, 3, 4}}
+--
+-- print(df:sum("x")) -- 10
+local function sum(self, column)
+	checkColumn(self, column)
+
+	local result = 0
+
+	forEachElement(numericValues(self, column), function(_, value)
+		result = result + value
+	end)
+
+	return result
+end
+
+--- Return the average of the values of a numeric column. Rows without value are ignored.
+-- It returns nil if the column does not have any value.
+-- @arg column A string with the name of the column.
+-- @usage df = DataFrame{x = {1, 2, 3, 4}}
+--
+-- print(df:mean("x")) -- 2.5
+local function mean(self, column)
+	checkColumn(self, column)
+
+	local values = numericValues(self, column)
+
+	if #values == 0 then return nil end
+
+	local result = 0
+
+	forEachElement(values, function(_, value)
+		result = result + value
+	end)
+
+	return result / #values
+end
+
+--- Return the minimum value of a numeric column. Rows without value are ignored.
+-- It returns nil if the column does not have any value.
+-- @arg column A string with the name of the column.
+-- @usage df = DataFrame{x = {4, 2, 3, 1}}
+--
+-- print(df:min("x")) -- 1
+local function min(self, column)
+	checkColumn(self, column)
+
+	local result
+
+	forEachElement(numericValues(self, column), function(_, value)
+		if result == nil or value < result then
+			result = value
+		end
+	end)
+
+	return result
+end
+
+--- Return the maximum value of a numeric column. Rows without value are ignored.
+-- It returns nil if the column does not have any value.
+-- @arg column A string with the name of the column.
+-- @usage df = DataFrame{x = {4, 2, 3, 1}}
+--
+-- print(df:max("x")) -- 4
+local function max(self, column)
+	checkColumn(self, column)
+
+	local result
+
+	forEachElement(numericValues(self, column), function(_, value)
+		if result == nil or value > result then
+			result = value
+		end
+	end)
+
+	return result
+end
+
+--- Return a quantile of a numeric column. It interpolates linearly the two values
+-- closest to the given probability, as the default quantile of R.
+-- Rows without value are ignored. It returns nil if the column does not have any value.
+-- @arg column A string with the name of the column.
+-- @arg probability A number between 0 and 1.
+-- @usage df = DataFrame{x = {1, 2, 3, 4, 5}}
+--
+-- print(df:quantile("x", 0.5)) -- 3
+-- print(df:quantile("x", 0.25)) -- 2
+local function quantile(self, column, probability)
+	checkColumn(self, column)
+	mandatoryArgument(2, "number", probability)
+	verify(probability >= 0 and probability <= 1, "Argument '#2' should be between 0 and 1, got "..probability..".")
+
+	local values = numericValues(self, column)
+
+	if #values == 0 then return nil end
+
+	table.sort(values)
+
+	local h = (#values - 1) * probability
+	local lower = math.floor(h)
+	local result = values[lower + 1]
+
+	if h > lower then
+		result = result + (h - lower) * (values[lower + 2] - result)
+	end
+
+	return result
+end
+
 local DataFrameIndex = {
 	add = add,
 	remove = remove,
 	save = save,
 	rows = rows,
 	columns = columns,
+	sum = sum,
+	mean = mean,
+	min = min,
+	max = max,
+	quantile = quantile,
+	type_ = "DataFrame"
+}
+
+-- functions of the DataFrames created with native = true, whose columns are stored in C++
+local NativeDataFrameIndex = {
+	add = function(self, row, idx)
+		mandatoryArgument(1, "table", row)
+
+		if self.cObj_:add(row, idx) then
+			self.columns_ = self.cObj_:getColumns()
+		end
+
+		self.rows_ = false
+	end,
+	remove = function(self, idx)
+		mandatoryArgument(1, "number", idx)
+
+		self.cObj_:remove(idx)
+		self.rows_ = false
+	end,
+	save = save,
+	rows = function(self)
+		if not self.rows_ then
+			local mrows = {}
+
+			for i = 0, self.cObj_:size() - 1 do
+				mrows[self.first_ + i * self.step_] = true
+			end
+
+			self.rows_ = mrows
+		end
+
+		return self.rows_
+	end,
+	columns = columns,
+	sum = function(self, column)
+		checkColumn(self, column)
+		return self.cObj_:sum(column)
+	end,
+	mean = function(self, column)
+		checkColumn(self, column)
+		return self.cObj_:mean(column)
+	end,
+	min = function(self, column)
+		checkColumn(self, column)
+		return self.cObj_:minimum(column)
+	end,
+	max = function(self, column)
+		checkColumn(self, column)
+		return self.cObj_:maximum(column)
+	end,
+	quantile = function(self, column, probability)
+		checkColumn(self, column)
+		mandatoryArgument(2, "number", probability)
+		verify(probability >= 0 and probability <= 1, "Argument '#2' should be between 0 and 1, got "..probability..".")
+
+		return self.cObj_:quantile(column, probability)
+	end,
 	type_ = "DataFrame"
 }
 
@@ -191,6 +487,12 @@ metaTableDataFrame_ = {
 	__newindex = function(self, idx, value)
 		if type(idx) == "string" then
 			self.data[idx] = value
+
+			if value == nil then
+				self.columns_[idx] = nil
+			else
+				self.columns_[idx] = true
+			end
 		else
 			self:add(value, idx)
 		end
@@ -230,9 +532,9 @@ metaTableDataFrame_ = {
 
 			forEachOrderedElement(mcolumns, function(col)
 				if not first then
-					str = str.."\t"..tostring(self.data[col][idx])
+					str = str.."\t"..tostring(self[col][idx])
 				else
-					str = idx.."\t"..tostring(self.data[col][idx])
+					str = idx.."\t"..tostring(self[col][idx])
 					first = false
 				end
 			end)
@@ -244,12 +546,64 @@ metaTableDataFrame_ = {
 	end
 }
 
+local metaTableNativeDataFrame_ = {
+	__index = function(self, idx)
+		if type(idx) == "number" then
+			local result = self.cache[idx]
+
+			if result then return result end
+
+			result = {pos = idx, parent = self}
+
+			setmetatable(result, metaTableNativeDataFrameItem_)
+
+			self.cache[idx] = result
+
+			return result
+		elseif type(idx) == "string" then
+			if self.columns_[idx] then
+				local result = self.views_[idx]
+
+				if not result then
+					result = setmetatable({parent = self, name = idx}, metaTableNativeColumn_)
+					self.views_[idx] = result
+				end
+
+				return result
+			end
+
+			return NativeDataFrameIndex[idx]
+		end
+	end,
+	__newindex = function(self, idx, value)
+		if type(idx) == "string" then
+			mandatoryArgument(1, "table", value)
+
+			self.cObj_:setColumn(idx, value)
+			self.columns_[idx] = true
+			self.rows_ = false
+		else
+			self:add(value, idx)
+		end
+	end,
+	__len = function(self)
+		return self.cObj_:size()
+	end,
+	__tostring = metaTableDataFrame_.__tostring
+}
+
 --- A two dimensional table. DataFrames can be accessed by row or by column, independently on the way it was created.
--- @arg data.file A string or a File. It must have extension '.lua'.
+-- @arg data.file A string or a File. It must have extension '.lua' or '.tmck'.
+-- See DataFrame:save().
 -- @arg data.first A number with the first index.
 -- @arg data.step A number with the interval between two indexes.
 -- @arg data.last A number with the last index. This argument is optional.
 -- @arg data.instance An optional object used as meta table for the rows of the DataFrame.
+-- @arg data.native A boolean value indicating whether the columns will be stored natively,
+-- in typed contiguous arrays. The type of each column is defined by its first value, and
+-- setting a value of another type to the column is an error, except integer and float numbers.
+-- Native DataFrames use less memory and are faster to add, remove, aggregate, and save
+-- large quantities of rows. The default value is false.
 -- and only used to check whether it is equals to first plus
 -- step times the size of the data vectors.
 -- @arg data.... Values for the DataFrame. It can be a vector of named tables or a named table with whose values are vectors.
@@ -284,30 +638,42 @@ function DataFrame(data)
 
 		mandatoryTableArgument(data, "file", "File")
 
-		verify(data.file:extension() == "lua", "File '"..data.file:name().."' does not have '.lua' extension.")
+		local extension = data.file:extension()
+
+		verify(extension == "lua" or extension == "tmck", "File '"..data.file:name().."' does not have '.lua' or '.tmck' extension.")
 		verify(data.file:exists(), resourceNotFoundMsg("file", data.file:name(true)))
 
 		local tbl
-		local ok, merror = pcall(function() tbl = dofile(tostring(data.file)) end)
-		if not ok then customError("Failed to load file "..merror) end
 
-		verify(type(tbl) == "table", "File '"..data.file:name().."' does not contain a Lua table.")
+		if extension == "tmck" then
+			tbl = TeDataFrame():load(tostring(data.file))
+		else
+			local ok, merror = pcall(function() tbl = dofile(tostring(data.file)) end)
+			if not ok then customError("Failed to load file "..merror) end
+
+			verify(type(tbl) == "table", "File '"..data.file:name().."' does not contain a Lua table.")
+		end
+
+		tbl.native = data.native
 		return DataFrame(tbl)
 	end
 
 	defaultTableValue(data, "first", 1)
 	defaultTableValue(data, "step", 1)
+	defaultTableValue(data, "native", false)
 	optionalTableArgument(data, "last", "number")
 
 	local first = data.first
 	local step = data.step
 	local last = data.last
 	local instance = data.instance
+	local native = data.native
 
 	data.first = nil
 	data.step = nil
 	data.last = nil
 	data.instance = nil
+	data.native = nil
 
 	if instance then
 		if not isTable(instance) then
@@ -401,11 +767,31 @@ function DataFrame(data)
 		customError("It is not possible to create a DataFrame from an empty table using arguments 'first' or 'step'.")
 	end
 
+	if native then
+		data = {
+			cObj_ = createNativeColumns(df, first, step, getn(mrows)),
+			instance = instance,
+			rows_ = false, -- built when DataFrame:rows() is called
+			columns_ = mcolumns,
+			first_ = first,
+			step_ = step,
+			cache = {},
+			views_ = {}
+		}
+
+		setmetatable(data.cache, {__mode = 'v'})
+		setmetatable(data, metaTableNativeDataFrame_)
+
+		return data
+	end
+
 	data = {
 		data = df,
 		instance = instance,
 		rows_ = mrows,
 		columns_ = mcolumns,
+		first_ = first,
+		step_ = step,
 		cache = {}
 	}
 
@@ -90,6 +90,34 @@ local function createUniformPlacement(environment, cs, placement)
 	end)
 end
 
+local metaTableNativePlacementAgents_ = {
+	__index = function(self, position)
+		if type(position) == "number" then
+			local slot = self.placement_.cObj_:get(self.index_, position)
+
+			if slot then
+				return self.placement_.agents[slot]
+			end
+		end
+	end,
+	__len = function(self)
+		return self.placement_.cObj_:size(self.index_)
+	end,
+	__newindex = function()
+		customError("The Agents of a native placement can only be changed by Agent:enter(), Agent:leave(), and Agent:move().")
+	end,
+	__pairs = function(self)
+		return function(agents, position)
+			position = position + 1
+
+			local agent = agents[position]
+			if agent then
+				return position, agent
+			end
+		end, self, 0
+	end
+}
+
 local function createVoidPlacement(environment, cs, data)
 	local placement = data.name
 	local nplacement = placement
@@ -103,9 +131,30 @@ local function createVoidPlacement(environment, cs, data)
 			local melement = element
 			if t == "Trajectory" then melement = element.parent end -- use the CellularSpace
 
-			forEachCell(melement, function(cell)
+			local native
+
+			if data.native then
+				local xs = {}
+				local ys = {}
+
+				forEachCell(melement, function(cell, position)
+					xs[position] = cell.x
+					ys[position] = cell.y
+				end)
+
+				native = {cObj_ = TePlacement(), agents = {}}
+				native.cObj_:config(xs, ys)
+			end
+
+			forEachCell(melement, function(cell, position)
 				cell[nplacement] = Group{build = false}
-				cell[nplacement].agents = {}
+
+				if native then
+					cell[nplacement].agents = setmetatable({placement_ = native, index_ = position}, metaTableNativePlacementAgents_)
+				else
+					cell[nplacement].agents = {}
+				end
+
 				cell.agents = cell[nplacement].agents
 			end)
 		elseif t == "Society" then
@@ -129,6 +178,391 @@ local function createVoidPlacement(environment, cs, data)
 	end)
 end
 
+local checkpointIgnore = {id = true, x = true, y = true, cell = true, cells = true, parent = true, past = true}
+
+local function isCheckpointAttribute(idx, value)
+	local mtype = type(value)
+
+	return type(idx) == "string" and not checkpointIgnore[idx] and string.sub(idx, -1) ~= "_" and
+		(mtype == "number" or mtype == "string" or mtype == "boolean")
+end
+
+-- save the attributes of a vector of objects as one vector for each attribute. The
+-- attributes stored natively are not visible here, as they are not fields of the tables
+local function saveAttributes(objects)
+	local attributes = {}
+
+	for i, object in ipairs(objects) do
+		for idx, value in pairs(object) do
+			if isCheckpointAttribute(idx, value) then
+				local values = attributes[idx]
+				if not values then
+					values = {}
+					attributes[idx] = values
+				end
+
+				values[i] = value
+			end
+		end
+	end
+
+	return attributes
+end
+
+local function restoreAttributes(object, attributes, position)
+	for idx, value in pairs(object) do
+		if isCheckpointAttribute(idx, value) then
+			object[idx] = nil
+		end
+	end
+
+	for idx, values in pairs(attributes) do
+		object[idx] = values[position]
+	end
+end
+
+local function saveCells(cells, cs)
+	local past = {}
+
+	for i, cell in ipairs(cells) do
+		past[i] = cell.past or {}
+	end
+
+	local natives
+
+	-- native attributes are copied as raw arrays by C++, without visiting the Cells
+	if cs and cs.native_ then
+		natives = cs.cObj_:saveAttributes()
+	end
+
+	return {
+		size = #cells,
+		attributes = saveAttributes(cells),
+		past = saveAttributes(past),
+		natives = natives
+	}
+end
+
+local function restoreCells(cells, state, name, cs)
+	if #cells ~= state.size then
+		customError("Component '"..name.."' should have "..state.size.." Cells to be restored, got "..#cells..".")
+	end
+
+	if state.natives then
+		if not (cs and cs.native_) then
+			customError("Component '"..name.."' should have native attributes to be restored.")
+		end
+
+		cs.cObj_:restoreAttributes(state.natives)
+	end
+
+	for i, cell in ipairs(cells) do
+		restoreAttributes(cell, state.attributes, i)
+
+		if not cell.past then
+			cell.past = {}
+		end
+
+		restoreAttributes(cell.past, state.past, i)
+	end
+end
+
+local function saveSociety(society, societies)
+	local agents = society.agents
+	local ids = {}
+
+	for i, agent in ipairs(agents) do
+		ids[i] = agent.id
+	end
+
+	-- each placement is stored as the position of the Cell of each Agent, or zero
+	local placements = {}
+
+	forEachElement(society.placements, function(name, target)
+		local positions = {}
+		local cells = {}
+
+		for i, cell in ipairs(target.cells) do
+			positions[cell] = i
+		end
+
+		for i, agent in ipairs(agents) do
+			local cell = agent[name] and agent[name].cells[1]
+			cells[i] = positions[cell] or 0
+		end
+
+		placements[name] = cells
+	end)
+
+	-- each SocialNetwork is stored as the number of connections of each Agent (-1 if it
+	-- does not have the SocialNetwork) followed by the connections of all the Agents
+	local networks = {}
+
+	for i, agent in ipairs(agents) do
+		forEachElement(agent.socialnetworks or {}, function(name, network, mtype)
+			if mtype ~= "SocialNetwork" then return end
+
+			local saved = networks[name]
+			if not saved then
+				saved = {sizes = {}, ids = {}, weights = {}, societies = {}}
+
+				for j = 1, #agents do
+					saved.sizes[j] = -1
+				end
+
+				networks[name] = saved
+			end
+
+			local size = 0
+			forEachConnection(agent, name, function(_, connection, weight)
+				-- dead Agents cannot be restored
+				if type(connection) ~= "Agent" then return end
+
+				size = size + 1
+				table.insert(saved.ids, connection.id)
+				table.insert(saved.weights, weight)
+
+				if connection.parent ~= society and societies[connection.parent] then
+					saved.societies[#saved.ids] = societies[connection.parent]
+				end
+			end)
+
+			saved.sizes[i] = size
+		end)
+	end
+
+	return {
+		ids = ids,
+		autoincrement = society.autoincrement,
+		attributes = saveAttributes(agents),
+		placements = placements,
+		networks = networks
+	}
+end
+
+local function restoreAgents(society, state)
+	local current = {}
+
+	for _, agent in ipairs(society.agents) do
+		current[agent.id] = agent
+	end
+
+	local agents = {}
+
+	for i, id in ipairs(state.ids) do
+		local agent = current[id]
+
+		if agent then
+			current[id] = nil
+		else
+			agent = society:add{}
+			agent.id = id
+		end
+
+		agents[i] = agent
+	end
+
+	forEachOrderedElement(current, function(_, agent)
+		agent:die()
+	end)
+
+	society.agents = agents
+	society.autoincrement = state.autoincrement
+
+	for i, agent in ipairs(agents) do
+		restoreAttributes(agent, state.attributes, i)
+	end
+end
+
+local function restoreRelations(society, state, name, agentsById, position)
+	local agents = society.agents
+
+	forEachOrderedElement(state.placements, function(placement, cells)
+		local target = society.placements[placement]
+
+		if not target then
+			customError("Placement '"..placement.."' does not exist in Society '"..name.."'.")
+		end
+
+		for _, agent in ipairs(agents) do
+			if agent[placement] and agent[placement].cells[1] then
+				agent:leave(placement)
+			end
+		end
+
+		for i, agent in ipairs(agents) do
+			if cells[i] > 0 then
+				agent:enter(target.cells[cells[i]], placement)
+			end
+		end
+	end)
+
+	forEachOrderedElement(state.networks, function(network, saved)
+		local connection = 0
+
+		for i, agent in ipairs(agents) do
+			local size = saved.sizes[i]
+
+			if size >= 0 then
+				local sn = agent.socialnetworks[network]
+
+				if type(sn) == "SocialNetwork" then
+					sn:clear()
+				else
+					sn = SocialNetwork()
+					agent:addSocialNetwork(sn, network)
+				end
+
+				for _ = 1, size do
+					connection = connection + 1
+
+					local id = saved.ids[connection]
+					local friend = agentsById[saved.societies[connection] or position][id]
+
+					if not friend then
+						customError("Agent '"..id.."' of SocialNetwork '"..network.."' does not exist in the restored Societies.")
+					end
+
+					sn:add(friend, saved.weights[connection])
+				end
+			end
+		end
+	end)
+end
+
+local function saveTimer(timer)
+	local registry = timerEvents_[timer] or {count = 0, orders = {}}
+	local events = {}
+	local times = {}
+	local periods = {}
+	local priorities = {}
+
+	for i, event in ipairs(timer:getEvents()) do
+		events[i] = registry.orders[event]
+		times[i] = event.time
+		periods[i] = event.period
+		priorities[i] = event.priority
+	end
+
+	return {
+		time = timer.time,
+		count = registry.count,
+		events = events,
+		times = times,
+		periods = periods,
+		priorities = priorities
+	}
+end
+
+local function restoreTimer(timer, state, name)
+	local registry = timerEvents_[timer] or {events = {}}
+
+	timer:clear()
+	timer.time = -math.huge
+
+	for i, order in ipairs(state.events) do
+		local event = registry.events[order]
+
+		if not event then
+			customError("Event "..order.." of Timer '"..name.."' does not exist. Only Events created before the simulation starts can be restored.")
+		end
+
+		event.time = state.times[i]
+		event.period = state.periods[i]
+		event.priority = state.priorities[i]
+		timer:add(event)
+	end
+
+	timer.time = state.time
+	registry.count = state.count
+end
+
+-- traverse the objects of an Environment that have their state stored in checkpoints,
+-- visiting each object only once even if it belongs to more than one Environment or Model
+local function forEachCheckpointComponent(container, visited, func)
+	forEachOrderedElement(container, function(idx, value, mtype)
+		if idx == "parent" or visited[value] then return end
+
+		if mtype == "Environment" or type(_G[mtype]) == "Model" then
+			visited[value] = true
+			func(idx, value, "Environment")
+		elseif belong(mtype, {"Agent", "Cell", "CellularSpace", "Society", "Timer"}) then
+			visited[value] = true
+			func(idx, value, mtype)
+		end
+	end)
+end
+
+local function collectSocieties(container, visited, societies)
+	forEachCheckpointComponent(container, visited, function(_, value, mtype)
+		if mtype == "Environment" then
+			collectSocieties(value, visited, societies)
+		elseif mtype == "Society" then
+			table.insert(societies, value)
+		end
+	end)
+
+	return societies
+end
+
+local function saveComponents(container, visited, societies)
+	local components = {}
+
+	forEachCheckpointComponent(container, visited, function(idx, value, mtype)
+		local state
+
+		if mtype == "Environment" then
+			state = {components = saveComponents(value, visited, societies)}
+		elseif mtype == "CellularSpace" then
+			state = saveCells(value.cells, value)
+		elseif mtype == "Cell" then
+			state = saveCells({value})
+		elseif mtype == "Society" then
+			state = saveSociety(value, societies)
+		elseif mtype == "Agent" then
+			state = {attributes = saveAttributes({value})}
+		else
+			state = saveTimer(value)
+		end
+
+		state.type = mtype
+		components[idx] = state
+	end)
+
+	return components
+end
+
+local function restoreComponents(container, components, societies)
+	forEachOrderedElement(components, function(idx, state)
+		local value = container[idx]
+		local mtype = type(value)
+		local name = tostring(idx)
+
+		if type(_G[mtype]) == "Model" then
+			mtype = "Environment"
+		end
+
+		if mtype ~= state.type then
+			customError("Component '"..name.."' should be a "..state.type.." to be restored, got "..mtype..".")
+		end
+
+		if mtype == "Environment" then
+			restoreComponents(value, state.components, societies)
+		elseif mtype == "CellularSpace" then
+			restoreCells(value.cells, state, name, value)
+		elseif mtype == "Cell" then
+			restoreCells({value}, state, name)
+		elseif mtype == "Society" then
+			restoreAgents(value, state)
+			table.insert(societies, {society = value, state = state, name = name})
+		elseif mtype == "Agent" then
+			restoreAttributes(value, state.attributes, 1)
+		else
+			restoreTimer(value, state, name)
+		end
+	end)
+end
+
 Environment_ = {
 	type_ = "Environment",
 	--- Add an element to the Environment.
@@ -164,6 +598,37 @@ Environment_ = {
 
 		self.cObj_:add(object.cObj_)
 	end,
+	--- Save the state of the simulation into a binary file. It stores the attributes and the
+	-- past of the Cells, the Agents of the Societies with their attributes, placements and
+	-- SocialNetworks, the attributes of the other Agents, and the Event queues of the Timers.
+	-- Only numbers, strings, and booleans are saved, as functions belong to the model. The
+	-- file is written through memory mapping. The state can be loaded by Environment:restore()
+	-- into another Environment created by the same model, which allows simulating different
+	-- scenarios from the same time.
+	-- @arg file A File or a string with the name of the file.
+	-- @see Environment:restore
+	-- @usage env = Environment{
+	--     cs = CellularSpace{xdim = 10},
+	--     timer = Timer{Event{action = function() end}}
+	-- }
+	--
+	-- env:run(5)
+	-- env:checkpoint("state.tmck")
+	-- File("state.tmck"):delete()
+	checkpoint = function(self, file)
+		if type(file) == "string" then
+			file = File(file)
+		end
+
+		mandatoryArgument(1, "File", file)
+
+		local societies = {}
+		forEachElement(collectSocieties(self, {}, {}), function(position, society)
+			societies[society] = position
+		end)
+
+		self.cObj_:checkpoint(file.filename, {components = saveComponents(self, {}, societies)})
+	end,
 	--- Create relations between behavioural entities (Agents) and spatial entities (Cells).
 	-- It is possible to have more than one behavioural entity within the Environment, but it must
 	-- have only one CellularSpace, Trajectory, or Cell.
@@ -186,20 +651,27 @@ Environment_ = {
 	-- Note that using this argument does not ensure a maximum number of
 	-- agents inside Cells along the simulation - controlling the maximum is always up to
 	-- the modeler.
+	-- @arg data.native A boolean indicating whether the relations between Agents and Cells
+	-- will be indexed by TerraME instead of being stored in Lua tables. In this case,
+	-- Agent:enter(), Agent:leave(), and Agent:move() do not depend on the number of Agents
+	-- within the Cells, and forEachNeighborAgent() gets the Agents of all the neighbor Cells
+	-- at once. The Agents of a Cell can be read as usual, but they can only be changed
+	-- through the functions of Agent, and the order of the Agents within a Cell changes
+	-- when an Agent leaves it. The default value is false.
 	-- @tabular strategy Strategy & Description & Arguments \
 	-- "random"(default) & Choose a Cell randomly and put max agents also chosen randomly.
 	-- Repeat this process until allocate all Agents. The last Cell chosen might have less than
-	-- max Agents. All the Cells that were not chosen in this process will remain empty. & name, max \
+	-- max Agents. All the Cells that were not chosen in this process will remain empty. & name, max, native \
 	-- "uniform" & Create placements uniformly. The first Agent enters in the first Cell, the second
 	-- one in the second Cell, and so on. If it reaches the last Cell of the CellularSpace or Trajectory
 	-- then it starts again in the first Cell. The
 	-- last Cells will contain fewer Agents if the number of Agents is not proportional to the
 	-- number of Cells. For example, placing a Society with four Agents into a CellularSpace of
-	-- three Cells will put two Agents in the first Cell and one in the other two Cells. & name \
+	-- three Cells will put two Agents in the first Cell and one in the other two Cells. & name, native \
 	-- "void" & This strategy creates an empty placement in each Cell and Agent. It is necessary to
 	-- use this strategy if the modeler needs to establish the relations between Agents and Cells by
 	-- himself/herself. In this case, Agents cannot use Agent:move() or Agent:walk()
-	-- before calling Agent:enter() explicitly. & name \
+	-- before calling Agent:enter() explicitly. & name, native \
 	-- @usage ag = Agent{}
 	--
 	-- soc = Society{
@@ -233,6 +705,8 @@ Environment_ = {
 			positiveTableArgument(data, "max")
 		end
 
+		defaultTableValue(data, "native", false)
+
 		local qty_agents = 0
 
 		for _, ud in pairs(self) do
@@ -271,7 +745,7 @@ Environment_ = {
 
 		switch(data, "strategy"):caseof{
 			random = function()
-				verifyUnnecessaryArguments(data, {"strategy", "name", "max"})
+				verifyUnnecessaryArguments(data, {"strategy", "name", "max", "native"})
 
 				if data.max ~= nil then
 					if qty_agents > #mycs * data.max then
@@ -283,12 +757,12 @@ Environment_ = {
 				createRandomPlacement(self, mycs, data.max, data.name)
 			end,
 			uniform = function()
-				verifyUnnecessaryArguments(data, {"strategy", "name"})
+				verifyUnnecessaryArguments(data, {"strategy", "name", "native"})
 				createVoidPlacement(self, mycs, data)
 				createUniformPlacement(self, mycs, data.name)
 			end,
 			void = function()
-				verifyUnnecessaryArguments(data, {"strategy", "name"})
+				verifyUnnecessaryArguments(data, {"strategy", "name", "native"})
 				createVoidPlacement(self, mycs, data)
 			end
 		}
@@ -563,6 +1037,63 @@ Environment_ = {
 		end
 
 		self.cObj_:notify(modelTime)
+	end,
+	--- Load the state of the simulation from a file saved by Environment:checkpoint(). The
+	-- Environment must have the same components of the one that was saved, which means that
+	-- it must be created by the same model. Cells are restored according to their positions
+	-- in the CellularSpaces and Agents according to their ids. Agents that do not exist are
+	-- created and the ones that are not in the file die. Events are restored according to
+	-- the order they were added to their Timers, therefore Events created along the simulation
+	-- cannot be restored.
+	-- @arg file A File or a string with the name of the file.
+	-- @see Environment:checkpoint
+	-- @usage env = Environment{
+	--     cs = CellularSpace{xdim = 10},
+	--     timer = Timer{Event{action = function() end}}
+	-- }
+	--
+	-- env:run(5)
+	-- env:checkpoint("state.tmck")
+	-- env:run(10)
+	--
+	-- env:restore("state.tmck")
+	-- print(env:getTime())
+	-- File("state.tmck"):delete()
+	restore = function(self, file)
+		if type(file) == "string" then
+			file = File(file)
+		end
+
+		mandatoryArgument(1, "File", file)
+
+		if not file:exists() then
+			resourceNotFoundError(1, file)
+		end
+
+		local state = self.cObj_:restore(file.filename)
+		local restored = {}
+
+		restoreComponents(self, state.components, restored)
+
+		-- placements and SocialNetworks are restored after the Agents of all the Societies,
+		-- as SocialNetworks can have Agents from other Societies
+		local agentsById = {}
+		local positions = {}
+
+		forEachElement(collectSocieties(self, {}, {}), function(position, society)
+			local agents = {}
+
+			forEachAgent(society, function(agent)
+				agents[agent.id] = agent
+			end)
+
+			agentsById[position] = agents
+			positions[society] = position
+		end)
+
+		forEachElement(restored, function(_, value)
+			restoreRelations(value.society, value.state, value.name, agentsById, positions[value.society])
+		end)
 	end
 }
 
@@ -308,14 +308,22 @@ File_ = {
 	readTable = function(self, sep)
 		optionalArgument(1, "string", sep)
 
+		sep = sep or ','
+
 		if not self.mode then
 			self.line = 1
 			self.file = self:open("r")
+
+			-- a file not read yet is parsed at once in C++
+			local data = cpp_readcsv(self.filename, sep)
+			self.line = self.line + #data
+			self:close()
+
+			return data
 		elseif self.mode ~= "r" then
 			customError("Cannot read a file opened for writing.")
 		end
 
-		sep = sep or ','
 		local data = {}
 
 		local fields = parseLine(self.file:read(), sep, self.line)
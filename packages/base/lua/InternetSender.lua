@@ -43,6 +43,12 @@ metaTableInternetSender_ = {__index = InternetSender_}
 -- @arg data.compress Compress the data to be transfered? It might be interesting not to
 -- compress when the connection is on the localhost, or when there is a very fast connection,
 -- to make the simulation faster. The default value is true.
+-- When using "tcp", each state is sent as a frame that starts with its size
+-- (a 32 bits big-endian integer) followed by one byte of flags and the data. If
+-- the host cannot receive the states as fast as they are produced, the oldest
+-- states waiting to be sent are discarded instead of stopping the simulation.
+-- When the observer is removed (for example, by clean()), a last frame with
+-- the flag of end of simulation is sent.
 -- @arg data.select A vector of strings with the name of the attributes to be observed.
 -- If it is a single value then it can also be described as a string. As default, it selects
 -- all the user-defined attributes of an object. When using a CellularSpace as subject,
@@ -172,7 +178,7 @@ function InternetSender(data)
 	observerParams.visible = data.visible
 	observerParams.compress = data.compress
 
-	table.insert(observerParams, data.port)
+	table.insert(observerParams, tostring(math.floor(data.port)))
 	table.insert(observerParams, data.host)
 
 	local observerType
@@ -207,7 +213,7 @@ function InternetSender(data)
 
 	isender:setObserver(obs)
 
-	data.cObj_ = logfile -- SKIP
+	data.cObj_ = isender -- SKIP
 	data.id = id -- SKIP
 
 	setmetatable(data, metaTableInternetSender_)
@@ -54,6 +54,15 @@ metaTableLog_ = {__index = Log_}
 -- @arg data.separator A string with the separator. The default value is ",".
 -- @arg data.overwrite A boolean value indicating whether the file should be overwritten.
 -- The default value is true.
+-- @arg data.buffer The number of bytes kept in memory before writing them into the file.
+-- The default value is zero, meaning that each update is written as soon as it happens.
+-- @arg data.flush The maximum time, in seconds, that an update can stay in memory
+-- before being written into the file. The default value is zero, meaning that the
+-- updates are written only when the buffer is full or when the Log is removed.
+-- @arg data.format A string with the file format. It can be "csv" (default), or
+-- "binary", which saves the updates as a sequence of columnar blocks.
+-- @arg data.compress A boolean value indicating whether each binary block should be
+-- compressed. It can only be used with format "binary". The default value is false.
 -- @arg data.select A vector of strings with the name of the attributes to be observed.
 -- If it is only a single value then it can also be described as a string.
 -- As default, it selects all the user-defined attributes of an object.
@@ -70,12 +79,28 @@ metaTableLog_ = {__index = Log_}
 -- }
 function Log(data)
 	verifyNamedTable(data)
-	verifyUnnecessaryArguments(data, {"target", "select", "file", "separator", "overwrite"})
+	verifyUnnecessaryArguments(data, {"target", "select", "file", "separator", "overwrite", "buffer", "flush", "format", "compress"})
 
 	mandatoryTableArgument(data, "target")
 	defaultTableValue(data, "separator", ",")
 	defaultTableValue(data, "file", "result.csv")
 	defaultTableValue(data, "overwrite", true)
+	defaultTableValue(data, "buffer", 0)
+	defaultTableValue(data, "flush", 0)
+	defaultTableValue(data, "format", "csv")
+	defaultTableValue(data, "compress", false)
+
+	integerTableArgument(data, "buffer")
+	positiveTableArgument(data, "buffer", true)
+	positiveTableArgument(data, "flush", true)
+
+	if not belong(data.format, {"csv", "binary"}) then
+		switchInvalidArgument("format", data.format, {"csv", "binary"})
+	end
+
+	if data.compress and data.format ~= "binary" then
+		customError("Argument 'compress' can only be used with format 'binary'.")
+	end
 
 	if type(data.select) == "string" then data.select = {data.select} end
 
@@ -181,6 +206,10 @@ function Log(data)
 	table.insert(observerParams, data.file)
 	table.insert(observerParams, data.separator)
 	table.insert(observerParams, data.mode)
+	table.insert(observerParams, tostring(data.buffer))
+	table.insert(observerParams, tostring(data.flush))
+	table.insert(observerParams, data.format)
+	table.insert(observerParams, tostring(data.compress))
 
 	if type(target) == "CellularSpace" then
 		id, obs = target.cObj_:createObserver(observerType, {}, data.select, observerParams, target.cells)
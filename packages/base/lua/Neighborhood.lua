@@ -171,16 +171,9 @@ Neighborhood_ = {
 			customError("It is not possible to sample the Neighborhood because it is empty.")
 		end
 
-		local pos = Random():integer(1, #self)
+		local neighbors = self.cObj_:getNeighborsAndWeights()
 
-		local count = 1
-		self.cObj_:first()
-		while not self.cObj_:isLast() do
-			local neigh = self.cObj_:getNeighbor()
-			if count == pos then return neigh end
-			self.cObj_:next()
-			count = count + 1
-		end
+		return neighbors[Random():integer(1, #neighbors)]
 	end,
 	--- Remove a Cell from the Neighborhood replacing it by another Cell.
 	-- @deprecated Neighborhood:remove() and Neighborhood:add()
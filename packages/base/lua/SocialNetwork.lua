@@ -208,6 +208,43 @@ metaTableSocialNetwork_ = {
 	__tostring = _Gtme.tostring
 }
 
+-- Copy a row of a native SocialNetwork (see Society:createSocialNetwork()) to a SocialNetwork
+-- stored in Lua. It is executed before the first function that uses the connections or
+-- weights of the SocialNetwork, which might change them.
+local function copyRow(self)
+	local graph = rawget(self, "graph_")
+	local row = rawget(self, "row_")
+
+	rawset(self, "graph_", nil)
+	rawset(self, "row_", nil)
+
+	local connections, weights = graph.cObj_:copy(graph.agents, row)
+	rawset(self, "connections", connections)
+	rawset(self, "weights", weights)
+	rawset(self, "count", graph.cObj_:size(row))
+
+	setmetatable(self, metaTableSocialNetwork_)
+end
+
+metaTableNativeSocialNetwork_ = {
+	__index = function(self, idx)
+		if idx == "connections" or idx == "weights" or idx == "count" then
+			copyRow(self)
+			return self[idx]
+		end
+
+		return SocialNetwork_[idx]
+	end,
+	__newindex = function(self, idx, value)
+		copyRow(self)
+		self[idx] = value
+	end,
+	__len = function(self)
+		return self.graph_.cObj_:size(self.row_)
+	end,
+	__tostring = _Gtme.tostring
+}
+
 --- SocialNetwork represents relations between A gents. It is a set of pairs (connection,
 -- weight), where connection is an A gent and weight
 -- is a number storing the relation's strength. \
@@ -24,6 +24,156 @@
 
 local terralib = getPackage("terralib")
 
+-- idindex maps the id of each Agent to its position in the vector of Agents. As the
+-- vector can be changed from outside the Society (see Environment:restore), every
+-- position is checked before being used and the index is rebuilt whenever it is stale.
+local function rebuildIndex(self)
+	local idindex = {}
+
+	for i = 1, #self.agents do
+		local id = self.agents[i].id
+		if id ~= nil then
+			idindex[id] = i
+		end
+	end
+
+	self.idindex = idindex
+	return idindex
+end
+
+-- messages is a binary heap ordered by delivery time and then by the order the messages were
+-- sent. Agent:message() appends new messages after the first queued_ elements and they are
+-- pushed into the heap by Society:synchronize(). If the vector is replaced or has messages
+-- removed (detected by its size or by a new message before position queued_), the heap is
+-- rebuilt. Delivery times are compared with a tolerance, as the sum of
+-- fractional delays is not exact.
+local messageTolerance = 1e-9
+local function earlier(m1, m2)
+	return m1.time_ < m2.time_ or (m1.time_ == m2.time_ and m1.order_ < m2.order_)
+end
+
+local function pushMessage(heap, position)
+	local message = heap[position]
+
+	while position > 1 do
+		local parent = math.floor(position / 2)
+		if not earlier(message, heap[parent]) then break end
+
+		heap[position] = heap[parent]
+		position = parent
+	end
+
+	heap[position] = message
+end
+
+local function popMessage(heap)
+	local first = heap[1]
+	local size = #heap
+	local message = heap[size]
+
+	heap[size] = nil
+	size = size - 1
+
+	if size > 0 then
+		local position = 1
+
+		while true do
+			local child = position * 2
+			if child > size then break end
+
+			if child < size and earlier(heap[child + 1], heap[child]) then
+				child = child + 1
+			end
+
+			if not earlier(heap[child], message) then break end
+
+			heap[position] = heap[child]
+			position = child
+		end
+
+		heap[position] = message
+	end
+
+	return first
+end
+
+local function findAgent(self, agent)
+	local agents = self.agents
+	local position = self.idindex[agent.id]
+
+	if agents[position] == agent then return position end
+
+	position = rebuildIndex(self)[agent.id]
+
+	if agents[position] == agent then return position end
+
+	-- two Agents with the same id
+	for i = 1, #agents do
+		if agents[i] == agent then return i end
+	end
+end
+
+local function createNativeSocialNetwork(soc, data)
+	local graph = {cObj_ = TeSocialGraph(), agents = {}}
+	local agents = graph.agents
+
+	forEachAgent(soc, function(agent)
+		table.insert(agents, agent)
+	end)
+
+	local function getCellOfAgents()
+		local positions = {}
+		forEachCell(soc.placements[data.placement], function(cell, i)
+			positions[cell] = i
+		end)
+
+		local cellOfAgents = {}
+		for i = 1, #agents do
+			cellOfAgents[i] = positions[agents[i][data.placement].cells[1]] or 0
+		end
+
+		return cellOfAgents, positions
+	end
+
+	switch(data, "strategy"):caseof{
+		quantity = function()
+			graph.cObj_:quantity(#agents, data.quantity, Random():integer(0, 2147483647))
+		end,
+		probability = function()
+			graph.cObj_:probability(#agents, data.probability, Random():integer(0, 2147483647))
+		end,
+		cell = function()
+			graph.cObj_:cell(getCellOfAgents(), data.self)
+		end,
+		neighbor = function()
+			local cellOfAgents, positions = getCellOfAgents()
+			local neighbors = {}
+
+			forEachCell(soc.placements[data.placement], function(cell, i)
+				local neighborsOfCell = {}
+
+				if cell:getNeighborhood(data.neighborhood) then
+					forEachNeighbor(cell, data.neighborhood, function(_, neigh)
+						table.insert(neighborsOfCell, positions[neigh])
+					end)
+				end
+
+				neighbors[i] = neighborsOfCell
+			end)
+
+			graph.cObj_:neighbor(cellOfAgents, neighbors)
+		end
+	}
+
+	if data.symmetric then
+		graph.cObj_:symmetrize()
+	end
+
+	for i = 1, #agents do
+		agents[i]:addSocialNetwork(setmetatable({graph_ = graph, row_ = i}, metaTableNativeSocialNetwork_), data.name)
+	end
+end
+
 local function getEmptySocialNetwork()
 	return function()
 		return SocialNetwork()
@@ -148,6 +298,7 @@ Society_ = {
 		table.insert(self.agents, agent)
 		if agent.id == nil then agent.id = tostring(self.autoincrement) end
 		self.autoincrement = self.autoincrement + 1
+		self.idindex[agent.id] = #self.agents
 
 		forEachElement(self.placements, function(placement, cs)
 			if agent[placement] == nil then
@@ -182,6 +333,7 @@ Society_ = {
 	-- print(#soc)
 	clear = function(self)
 		self.agents = {}
+		self.idindex = {}
 		self.autoincrement = 1
 	end,
 	--- Create a directed SocialNetwork for each Agent of the Society.
@@ -204,6 +356,15 @@ Society_ = {
 	-- time as they need to be built again and again along the simulation.
 	-- Note that not inmemory relations cannot be changed manually (for example by using
 	-- SocialNetwork:add()), because the relation is recomputed every time it is needed.
+	-- @arg data.native A boolean indicating whether the SocialNetworks of all the Agents will be
+	-- built in C++ and stored in a single compact graph. It is available for the strategies
+	-- "quantity", "probability", "cell", and "neighbor", and requires inmemory = true.
+	-- Building and traversing native SocialNetworks (see Utils:forEachConnection()) are much
+	-- faster, which is useful for Societies with millions of Agents. The SocialNetwork of an Agent
+	-- is copied to Lua when it is changed or when its connections are used by any function other
+	-- than Utils:forEachConnection() and operator #. The random connections are drawn from a
+	-- seed taken from Random, therefore they are different from the ones of non-native
+	-- SocialNetworks. The default value is false.
 	-- @arg data.neighborhood A string with the name of the Neighborhood that will be used to
 	-- create the SocialNetwork. The default value is "1".
 	-- @arg data.placement A string with the name of the placement that will be used to
@@ -234,7 +395,7 @@ Society_ = {
 	-- "cell" &
 	-- Create a dynamic SocialNetwork for each Agent of the Society with every Agent within the
 	-- same Cell the Agent belongs. & &
-	-- name, placement, self, inmemory \
+	-- name, placement, self, inmemory, native \
 	-- "erdos" & Create a SocialNetwork with a given number of random connections. This strategy implements
 	-- the algorithm proposed by Erdos and Renyi (1959) "On random graphs I". Publicationes Mathematicae
 	-- 6: 290-297 & strategy, quantity & name \
@@ -244,14 +405,14 @@ Society_ = {
 	-- "neighbor" &
 	-- Create a dynamic SocialNetwork for each Agent of the Society with every Agent within the
 	-- neighbor Cells of the one the Agent belongs. &
-	-- & name, neighborhood, placement, inmemory \
+	-- & name, neighborhood, placement, inmemory, native \
 	-- "probability" &
 	-- Applies a probability for each pair of Agents to be connected (excluding the Agent itself). &
-	-- probability & name, inmemory, symmetric \
+	-- probability & name, inmemory, symmetric, native \
 	-- "quantity" &
 	-- Each Agent will be connected to a given number of other Agents randomly taken from the Society
 	-- (excluding the Agent itself). &
-	-- quantity & name, inmemory, symmetric \
+	-- quantity & name, inmemory, symmetric, native \
 	-- "void" &
 	-- Create an empty SocialNetwork for each Agent of the Society. &
 	-- & name \
@@ -309,13 +470,17 @@ Society_ = {
 			defaultTableValue(data, "inmemory", true)
 		end
 
+		if belong(data.strategy, {"quantity", "probability", "cell", "neighbor"}) then
+			defaultTableValue(data, "native", false)
+		end
+
 		if self.agents[1].socialnetworks[data.name] ~= nil then
 			customError("SocialNetwork '"..data.name.."' already exists in the Society.")
 		end
 
 		switch(data, "strategy"):caseof{
 			probability = function()
-				verifyUnnecessaryArguments(data, {"strategy", "probability", "name", "inmemory", "symmetric"})
+				verifyUnnecessaryArguments(data, {"strategy", "probability", "name", "inmemory", "symmetric", "native"})
 
 				mandatoryTableArgument(data, "probability", "number")
 				defaultTableValue(data, "symmetric", false)
@@ -334,7 +499,7 @@ Society_ = {
 				data.mfunc = getSocialNetworkByFunction
 			end,
 			cell = function()
-				verifyUnnecessaryArguments(data, {"strategy", "self", "name", "placement", "inmemory"})
+				verifyUnnecessaryArguments(data, {"strategy", "self", "name", "placement", "inmemory", "native"})
 
 				defaultTableValue(data, "self", false)
 				defaultTableValue(data, "placement", "placement")
@@ -350,7 +515,7 @@ Society_ = {
 				data.mfunc = getSocialNetworkByCell
 			end,
 			neighbor = function()
-				verifyUnnecessaryArguments(data, {"strategy", "neighborhood", "name", "placement", "inmemory"})
+				verifyUnnecessaryArguments(data, {"strategy", "neighborhood", "name", "placement", "inmemory", "native"})
 
 				defaultTableValue(data, "neighborhood", "1")
 				defaultTableValue(data, "placement", "placement")
@@ -372,7 +537,7 @@ Society_ = {
 				data.mfunc = getSocialNetworkByNeighbor
 			end,
 			quantity = function()
-				verifyUnnecessaryArguments(data, {"strategy", "quantity", "name", "inmemory", "symmetric"})
+				verifyUnnecessaryArguments(data, {"strategy", "quantity", "name", "inmemory", "symmetric", "native"})
 
 				defaultTableValue(data, "quantity", 1)
 				defaultTableValue(data, "symmetric", false)
@@ -381,13 +546,18 @@ Society_ = {
 					local merror = "It is not possible to connect such amount of agents ("..data.quantity.."). "..
 						"The Society only has "..#self.." agents."
 					customError(merror)
-				elseif data.quantity > #self * 0.9 then
+				elseif data.quantity > #self * 0.9 and not data.native then
 					customWarning("Connecting more than 90% of the Agents randomly might take too much time.")
 				end
 
 				integerTableArgument(data, "quantity")
 				positiveTableArgument(data, "quantity")
 
+				if data.native and data.quantity == #self then
+					customError("It is not possible to connect such amount of agents ("..data.quantity.."). "..
+						"The Society only has "..#self.." agents.")
+				end
+
 				data.mfunc = getSocialNetworkByQuantity
 			end,
 			erdos = function()
@@ -503,6 +673,12 @@ Society_ = {
 
 		if not data.mfunc then return end
 
+		if data.native then
+			verify(data.inmemory, "Argument 'native' does not work with 'inmemory' equal to false.")
+			createNativeSocialNetwork(self, data)
+			return
+		end
+
 		local func = data.mfunc(self, data)
 		local name = data.name
 		if data.inmemory then
@@ -542,17 +718,16 @@ Society_ = {
 	-- print(agent.id)
 	get = function(self, position)
 		if type(position) == "string" then
-			if not self.idindex or not self.idindex[position] then
-				self.idindex = {}
-				forEachAgent(self, function(agent)
-					self.idindex[agent.id] = agent
-				end)
-			end
+			local result = self.agents[self.idindex[position]]
+
+			if not result or result.id ~= position then
+				result = self.agents[rebuildIndex(self)[position]]
 
-			local result = self.idindex[position]
-			if not result then
-				customError("Agent '"..position.."' does not belong to the Society.")
+				if not result then
+					customError("Agent '"..position.."' does not belong to the Society.")
+				end
 			end
+
 			return result
 		end
 
@@ -618,9 +793,13 @@ Society_ = {
 
 		self.cObj_:notify(modelTime)
 	end,
-	--- Remove a given Agent from the Society.
+	--- Remove a given Agent from the Society. Finding the Agent takes constant time. If the
+	-- Society was created with stable = false, the last Agent takes the position of the
+	-- removed one, otherwise all the Agents after it are shifted back.
 	-- @arg arg The Agent that will be removed, or a function that takes an Agent as argument and
-	-- returns true if the Agent must be removed.
+	-- returns true if the Agent must be removed. When using a function, the Agents are removed
+	-- in a single pass that keeps the order of the remaining ones. This function
+	-- must not add or remove Agents from the Society.
 	-- @usage ag = Agent{}
 	--
 	-- soc = Society{
@@ -633,21 +812,62 @@ Society_ = {
 	-- print(#soc)
 	remove = function(self, arg)
 		if type(arg) == "Agent" then
-			for k, v in pairs(self.agents) do
-				if v.id == arg.id and v == arg then
-					table.remove(self.agents, k)
+			local position = findAgent(self, arg)
+
+			if not position then
+				customError("Could not remove the Agent (id = '"..tostring(arg.id).."').")
+			end
+
+			local agents = self.agents
+			local idindex = self.idindex
+			local quantity = #agents
+
+			idindex[arg.id] = nil
 
-					return arg.cObj_:kill(-1)
+			if self.stable == false then
+				local last = agents[quantity]
+
+				agents[position] = last
+				agents[quantity] = nil
+
+				if last ~= arg then
+					idindex[last.id] = position
+				end
+			else
+				table.remove(agents, position)
+
+				for i = position, quantity - 1 do
+					idindex[agents[i].id] = i
 				end
 			end
 
-			customError("Could not remove the Agent (id = '"..tostring(arg.id).."').")
+			return arg.cObj_:kill(-1)
 		elseif type(arg) == "function" then
-			for i = #self.agents, 1, -1  do
-				if arg(self.agents[i]) == true then
-					self:remove(self.agents[i])
+			local agents = self.agents
+			local idindex = {}
+			local quantity = #agents
+			local position = 0
+
+			for i = 1, quantity do
+				local agent = agents[i]
+
+				if arg(agent) == true then
+					agent.cObj_:kill(-1)
+				else
+					position = position + 1
+					agents[position] = agent
+
+					if agent.id ~= nil then
+						idindex[agent.id] = position
+					end
 				end
 			end
+
+			for i = quantity, position + 1, -1 do
+				agents[i] = nil
+			end
+
+			self.idindex = idindex
 		else
 			incompatibleTypeError(1, "Agent or function", arg)
 		end
@@ -757,9 +977,12 @@ Society_ = {
 
 		return result
 	end,
-	--- Deliver asynchronous messages sent by Agents belonging to the Society.
+	--- Deliver asynchronous messages sent by Agents belonging to the Society. The messages
+	-- are kept in a queue ordered by their delivery time, therefore only the messages that
+	-- will be delivered are visited. They are delivered in the same order they were sent.
+	-- Messages sent while delivering wait for the next synchronization.
 	-- @arg delay A number indicating the current delay to be delivered. Messages with delay less
-	-- or equal this value are sent, while the others have their delays reduced by this value.
+	-- or equal the sum of the delays since they were sent are delivered.
 	-- The default value is one.
 	-- @usage nonFooAgent = Agent{
 	--     received = 0,
@@ -796,22 +1019,61 @@ Society_ = {
 			positiveArgument(1, delay)
 		end
 
-		local k = 1
-		for _ = 1, getn(self.messages) do
-			local kmessage = self.messages[k]
-			kmessage.delay = kmessage.delay - delay
+		local messages = self.messages
+		local time = self.time_ or 0
+		local order = self.order_ or 0
+		local queued = self.queued_ or 0
+		local first = queued + 1
 
-			if kmessage.delay <= 0 then
-				kmessage.delay = true
-				if kmessage.subject then
-					kmessage.receiver["on_"..kmessage.subject](kmessage.receiver, kmessage)
-				else
-					kmessage.receiver:on_message(kmessage)
-				end
+		-- the vector was replaced or had messages removed, therefore the heap is rebuilt
+		if messages ~= self.heap_ or #messages < queued or (queued > 0 and messages[queued].time_ == nil) then
+			first = 1
+		end
+
+		for i = first, #messages do
+			local message = messages[i]
+
+			if message.time_ == nil then
+				order = order + 1
+				message.time_ = time + message.delay
+				message.order_ = order
+			end
+
+			pushMessage(messages, i)
+		end
+
+		time = time + delay
+
+		local limit = time + messageTolerance * math.max(1, time)
+		local delivered = {}
+		while messages[1] and messages[1].time_ <= limit do
+			table.insert(delivered, popMessage(messages))
+		end
 
-				table.remove(self.messages, k)
+		-- the time restarts when there is no message waiting, so the error does not accumulate
+		if #messages == 0 then
+			time = 0
+			order = 0
+		end
+
+		self.time_ = time
+		self.order_ = order
+		self.queued_ = #messages
+		self.heap_ = messages
+
+		-- messages due at different times are delivered in the order they were sent
+		table.sort(delivered, function(m1, m2) return m1.order_ < m2.order_ end)
+
+		for i = 1, #delivered do
+			local message = delivered[i]
+			message.time_ = nil
+			message.order_ = nil
+			message.delay = true
+
+			if message.subject then
+				message.receiver["on_"..message.subject](message.receiver, message)
 			else
-				k = k + 1
+				message.receiver:on_message(message)
 			end
 		end
 	end
@@ -850,6 +1112,10 @@ metaTableSociety_ = {
 -- "csv" & Load agents from a csv file. This is the default value when value of argument
 -- database ends with ".csv". & file, id, instance & sep, ...
 -- @arg data.id The unique identifier attribute used when reading the Society from a file.
+-- @arg data.stable A boolean indicating whether removing an Agent keeps the order of the other
+-- Agents. When false, the last Agent takes the position of the removed one, which makes
+-- Society:remove() and Agent:die() take constant time. This is useful for large Societies
+-- with many births and deaths along the simulation. The default value is true.
 -- @arg data.... Any other attribute or function for the Society.
 -- @arg data.instance An Agent with the description of attributes and functions. When using this
 -- argument, each Agent of the Society will have attributes and functions according to the
@@ -875,7 +1141,8 @@ metaTableSociety_ = {
 -- the Society. This Agent must not be executed.
 -- @output autoincrement unique identifier used to represent the last Agent added to the Society.
 -- The next Agent will have 'autoincrement + 1' as id.
--- @output messages A vector that contains the delayed messages.
+-- @output messages A vector that contains the delayed messages. It works as a priority queue
+-- ordered by the delivery time of the messages.
 -- @output parent The Environment it belongs.
 -- @output cObj_ A pointer to a C++ representation of the Society. Never use this object.
 -- @output placements A vector with the names of the placements created using this object (see
@@ -909,8 +1176,11 @@ metaTableSociety_ = {
 function Society(data)
 	verifyNamedTable(data)
 
+	optionalTableArgument(data, "stable", "boolean")
+
 	data.cObj_ = TeSociety()
 	data.agents = {}
+	data.idindex = {}
 	data.messages = {}
 	data.autoincrement = 1
 	data.placements = {}
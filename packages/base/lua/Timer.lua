@@ -22,6 +22,31 @@
 --
 -------------------------------------------------------------------------------------------
 
+-- Events of each Timer indexed by the order they were added for the first time.
+-- It allows Environment:restore() to find the Events of a Timer, as their actions
+-- cannot be saved.
+timerEvents_ = setmetatable({}, {__mode = "k"})
+
+local function registerEvent(timer, event)
+	local registry = timerEvents_[timer]
+
+	if not registry then
+		registry = {
+			count = 0,
+			events = setmetatable({}, {__mode = "v"}),
+			orders = setmetatable({}, {__mode = "k"})
+		}
+
+		timerEvents_[timer] = registry
+	end
+
+	if not registry.orders[event] then
+		registry.count = registry.count + 1
+		registry.orders[event] = registry.count
+		registry.events[registry.count] = event
+	end
+end
+
 Timer_ = {
 	type_ = "Timer",
 	--- Add a new Event to the timer. If the Event has a start time less than the current
@@ -44,18 +69,9 @@ Timer_ = {
 			customWarning(msg)
 		end
 
-		local pos = 1
-		local evp = self.events[pos]
-		local quant = #self.events
-		local time = event.time
-		local prio = event.priority
-		while pos <= quant and (time > evp.time or (time == evp.time and prio >= evp.priority)) do
-			pos = pos + 1
-			evp = self.events[pos]
-		end
-
-		table.insert(self.events, pos, event)
+		self.cObj_:schedule(event, event.time, event.priority)
 		event.parent = self
+		registerEvent(self, event)
 	end,
 	--- Add temporal replacements for a given attribute. Cells and Agents might have temporal
 	-- data stored as attribute values, with time stored as part of the attribute name.
@@ -151,7 +167,7 @@ Timer_ = {
 	--
 	-- timer:clear()
 	clear = function(self)
-		self.events = {}
+		self.cObj_:clear()
 	end,
 	--- Run the simulation.
 	-- @deprecated Timer:run
@@ -165,7 +181,7 @@ Timer_ = {
 	--
 	-- print(timer:getEvents()[1]:getTime())
 	getEvents = function(self)
-		return self.events
+		return self.cObj_:getEvents()
 	end,
 	--- Return the current simulation time.
 	-- @usage timer = Timer{
@@ -229,10 +245,12 @@ Timer_ = {
 			customWarning(msg)
 		end
 
+		local queue = self.cObj_
+
 		while true do
-			if getn(self.events) == 0 then return end
+			local ev = queue:getFirst()
+			if ev == nil then return end
 
-			local ev = self.events[1]
 			if ev.time > finalTime then
 				self.time = finalTime
 				return
@@ -240,7 +258,7 @@ Timer_ = {
 
 			self.time = ev.time
 
-			table.remove(self.events, 1)
+			queue:removeFirst()
 
 			local result = ev.action(ev, self)
 
@@ -265,8 +283,24 @@ Timer_ = {
 }
 
 metaTableTimer_ = {
-	__index = Timer_,
-	__tostring = _Gtme.tostring,
+	__index = function(self, idx)
+		if idx == "events" then
+			return rawget(self, "cObj_"):getEvents()
+		end
+
+		return Timer_[idx]
+	end,
+	__tostring = function(self)
+		local copy = {events = self.events}
+
+		forEachElement(self, function(idx, value)
+			if idx ~= "queue_" then
+				copy[idx] = value
+			end
+		end)
+
+		return _Gtme.tostring(copy)
+	end,
 	--- Return the number of Events in the Timer.
 	-- @usage timer = Timer{
 	--     Event{action = function()
@@ -279,7 +313,7 @@ metaTableTimer_ = {
 	--
 	-- print(#timer)
 	__len = function(self)
-		return #self.events
+		return self.cObj_:size()
 	end
 }
 
@@ -291,7 +325,8 @@ metaTableTimer_ = {
 -- Events before that time were already executed. See Timer:run() for more details.
 -- @arg data.... A set of Events.
 -- @output cObj_ A pointer to a C++ representation of the Timer. Never use this object.
--- @output events An ordered vector with the Events.
+-- @output events An ordered vector with the Events. It is built from the priority
+-- queue of the Timer each time it is accessed.
 -- @output time The current simulation time.
 -- @usage timer = Timer{
 --     Event{action = function()
@@ -318,12 +353,15 @@ function Timer(data)
 	local cObj = TeTimer()
 
 	local mdata = {
-		events = {},
+		cObj_ = cObj,
 		time = -math.huge,
 	}
 
 	setmetatable(mdata, metaTableTimer_)
 
+	-- the queued Events are stored in mdata.queue_, therefore the reference comes first
+	cObj:setReference(mdata)
+
 	forEachOrderedElement(data, function(idx, value, mtype)
 		if mtype == "Event" then
 			mdata:add(value)
@@ -332,8 +370,6 @@ function Timer(data)
 		end
 	end)
 
-	mdata.cObj_ = cObj
-	cObj:setReference(mdata)
 	return mdata
 end
 
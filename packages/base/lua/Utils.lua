@@ -350,13 +350,24 @@ end
 -- It can optionally have a second argument with a positive number representing the position of
 -- the Cell in the vector of Cells. If it returns false when processing a given Cell,
 -- forEachCell() stops and does not process any other Cell.
+-- @arg data An optional table with the execution options.
+-- @arg data.parallel A boolean indicating whether the Cells will be processed by several
+-- threads. It requires a CellularSpace with native attributes (see argument native of
+-- CellularSpace). Each thread runs its own copy of the function, therefore it can only
+-- use native attributes, forEachNeighbor(), and variables from outside the function
+-- that are numbers, strings, or booleans. Such variables are read-only, and changing
+-- them stops with an error. The Cell can change its own attributes, while
+-- its past and its neighbors are read-only and return the past values. The order the
+-- Cells are processed is not defined. Therefore, when the function returns false, the
+-- threads stop as soon as possible, but which Cells were already processed is not
+-- defined. The default value is false.
 -- @usage cellularspace = CellularSpace{xdim = 10}
 --
 -- forEachCell(cellularspace, function(cell)
 --     cell.water = 0
 -- end)
 -- @see Environment:createPlacement
-function forEachCell(cs, _sof_)
+function forEachCell(cs, _sof_, data)
 	local t = type(cs)
 	if t ~= "CellularSpace" and t ~= "Trajectory" and t ~= "Agent" then
 		incompatibleTypeError(1, "CellularSpace, Trajectory, or Agent", cs)
@@ -364,6 +375,23 @@ function forEachCell(cs, _sof_)
 		incompatibleTypeError(2, "function", _sof_)
 	end
 
+	if data ~= nil then
+		if type(data) ~= "table" then
+			incompatibleTypeError(3, "table", data)
+		end
+
+		verifyUnnecessaryArguments(data, {"parallel"})
+		optionalTableArgument(data, "parallel", "boolean")
+
+		if data.parallel then
+			if t ~= "CellularSpace" or not cs.native_ then
+				customError("Argument 'parallel' requires a CellularSpace with native attributes.")
+			end
+
+			return cs.cObj_:forEachCellParallel(_sof_)
+		end
+	end
+
 	for i, cell in ipairs(cs.cells) do
 		if _sof_(cell, i) == false then return false end
 	end
@@ -413,6 +441,8 @@ end
 -- each of them. It returns true if no call to the function taken as argument returns false,
 -- otherwise it returns false.
 -- There are two ways of using this function because the second argument is optional.
+-- SocialNetworks created with native = true (see Society:createSocialNetwork()) are
+-- traversed directly from their arrays of connections.
 -- @arg agent An Agent.
 -- @arg name (Optional) A string with the name of the SocialNetwork to be traversed. The default value is "1".
 -- @arg _sof_ A function that takes three arguments: the Agent itself, its connection, and the
@@ -449,6 +479,11 @@ function forEachConnection(agent, name, _sof_)
 		customError("Agent does not have a SocialNetwork named '"..name.."'.")
 	end
 
+	local graph = socialnetwork.graph_
+	if graph then
+		return graph.cObj_:forEachConnection(graph.agents, socialnetwork.row_, agent, _sof_)
+	end
+
 	for mname, connection in pairs(socialnetwork.connections) do
 		local weight = socialnetwork.weights[mname]
 		if _sof_(agent, connection, weight) == false then return false end
@@ -668,6 +703,19 @@ function forEachModel(env, _sof_)
 	return true
 end
 
+local function getNeighborhood(cell, name)
+	local neighborhood = cell:getNeighborhood(name)
+	if neighborhood == nil then
+		if name == "1" then
+				customError("The CellularSpace does not have a default neighborhood. Please call 'CellularSpace:createNeighborhood' first.")
+		else
+			customError("Neighborhood '"..name.."' does not exist.")
+		end
+	end
+
+	return neighborhood
+end
+
 --- Second order function to traverse a given Neighborhood of a Cell, applying a
 -- function in each of its neighbors. It returns true if no call to the function taken as
 -- argument returns false, otherwise it returns false.
@@ -717,22 +765,10 @@ function forEachNeighbor(cell, name, _sof_)
 		incompatibleTypeError(3, "function", _sof_)
 	end
 
-	local neighborhood = cell:getNeighborhood(name)
-	if neighborhood == nil then
-		if name == "1" then
-				customError("The CellularSpace does not have a default neighborhood. Please call 'CellularSpace:createNeighborhood' first.")
-		else
-			customError("Neighborhood '"..name.."' does not exist.")
-		end
-	end
-
-	neighborhood.cObj_:first()
+	local neighbors, weights = getNeighborhood(cell, name).cObj_:getNeighborsAndWeights()
 
-	while not neighborhood.cObj_:isLast() do
-		local neigh = neighborhood.cObj_:getNeighbor()
-		local weight = neighborhood.cObj_:getWeight()
-		if _sof_(cell, neigh, weight) == false then return false end
-		neighborhood.cObj_:next()
+	for i = 1, #neighbors do
+		if _sof_(cell, neighbors[i], weights[i]) == false then return false end
 	end
 
 	return true
@@ -740,16 +776,27 @@ end
 
 --- Second order function to traverse the Agents within the neighbor Cells fom the
 -- current location of a given Agent, applying a function to each of them.
--- This function requires that the Agent has a default placement ("placement") and
--- its Cell has a default Neighborhood ("1"). More complex placements and neighborhoods
--- need to be traversed manually using Agent:getCell() and Cell:getNeighborhood().
+-- This function requires that the Agent has a default placement ("placement").
+-- More complex placements need to be traversed manually using Agent:getCell() and
+-- Cell:getNeighborhood().
 -- It returns true if no call to the function taken as argument returns false,
 -- otherwise it returns false.
+-- Placements created with native = true (see Environment:createPlacement()) get
+-- the Agents of all the neighbor Cells at once. Both kinds of placement traverse the
+-- same Agents. The Agent given as argument and the other Agents of its Cell are only
+-- traversed when the Cell is a neighbor of itself (see argument self of
+-- CellularSpace:createNeighborhood()).
 -- @arg agent An Agent.
+-- @arg name A string with the name of the Neighborhood of the Cell to be used. The
+-- default value is "1". It can also be a positive number representing a distance.
+-- In this case, it traverses the Agents within the Cells whose Euclidean distance
+-- between their (x, y) and the (x, y) of the Cell of the Agent is less than or equal
+-- to the given value. As it includes the Cell of the Agent, the Agent itself is also traversed.
 -- @arg _sof_ A function that takes one single Agent as argument. This function is called
 -- once for each agent within a neighbor cell of the current cell where the Agent belongs.
 -- If some call to it returns false, forEachNeighborAgent() stops and does not process
--- any other Agent.
+-- any other Agent. In the case where the second argument is missing,
+-- this function becomes the second argument.
 -- @usage ag = Agent{age = Random{min = 0, max = 2}}
 -- soc = Society{
 --     instance = ag,
@@ -765,22 +812,84 @@ end
 -- forEachNeighborAgent(soc:sample(), function(agent)
 --     print("Found Agent "..agent.id)
 -- end)
+--
+-- forEachNeighborAgent(soc:sample(), 2, function(agent)
+--     print("Found Agent "..agent.id.." at most two Cells away")
+-- end)
 -- @see CellularSpace:createNeighborhood
 -- @see Environment:createPlacement
-function forEachNeighborAgent(agent, _sof_)
+function forEachNeighborAgent(agent, name, _sof_)
 	if type(agent) ~= "Agent" then
 		incompatibleTypeError(1, "Agent", agent)
+	elseif type(name) == "function" then
+		_sof_ = name
+		name = "1"
+	elseif type(name) ~= "string" and type(name) ~= "number" then
+		incompatibleTypeError(2, "function", name)
 	elseif type(_sof_) ~= "function" then
-		incompatibleTypeError(2, "function", _sof_)
+		incompatibleTypeError(3, "function", _sof_)
 	end
 
 	local cell = agent:getCell()
+	local native = cell.placement.agents.placement_
+	local agents
+
+	if type(name) == "number" then
+		positiveArgument(2, name, true)
+
+		if native then
+			agents = native.cObj_:radius(native.agents, cell.placement.agents.index_, name)
+		else
+			agents = {}
+
+			local distance = math.floor(name)
+			for x = cell.x - distance, cell.x + distance do
+				for y = cell.y - distance, cell.y + distance do
+					local neigh = cell.parent:get(x, y)
+
+					if neigh and (x - cell.x) ^ 2 + (y - cell.y) ^ 2 <= name ^ 2 then
+						forEachAgent(neigh, function(ag)
+							table.insert(agents, ag)
+						end)
+					end
+				end
+			end
+		end
+	elseif native then
+		local neighbors = getNeighborhood(cell, name).cObj_:getNeighborsAndWeights()
+		local indexes = {}
+		local others = {}
 
-	forEachNeighbor(cell, function(_, neigh)
-		forEachAgent(neigh, function(ag)
-			if _sof_(ag) == false then return false end
+		for i = 1, #neighbors do
+			local group = neighbors[i].placement
+
+			if group and group.agents.placement_ == native then
+				table.insert(indexes, group.agents.index_)
+			else
+				table.insert(others, neighbors[i])
+			end
+		end
+
+		agents = native.cObj_:getAgents(native.agents, indexes)
+
+		for i = 1, #others do
+			forEachAgent(others[i], function(ag)
+				table.insert(agents, ag)
+			end)
+		end
+	else
+		return forEachNeighbor(cell, name, function(_, neigh)
+			return forEachAgent(neigh, function(ag)
+				if _sof_(ag) == false then return false end
+			end)
 		end)
-	end)
+	end
+
+	for i = 1, #agents do
+		if _sof_(agents[i]) == false then return false end
+	end
+
+	return true
 end
 
 --- Second order function to traverse all Neighborhoods of a Cell, applying a given function
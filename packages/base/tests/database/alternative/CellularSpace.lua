@@ -54,6 +54,16 @@ return{
 		end
 		unitTest:assertError(error_func, "source and file extension should be the same.")
 
+		local csvFile = filePath("test/simple-cs.csv", "base")
+		error_func = function()
+			cs = CellularSpace{
+				file = csvFile,
+				sep = ";",
+				select = {"x", "y", "sugar"}
+			}
+		end
+		unitTest:assertError(error_func, "Attribute 'sugar' does not exist in file '"..csvFile.."'.")
+
 		local pgmFile = filePath("test/error/pgm-invalid-identifier.pgm", "base")
 		error_func = function()
 			cs = CellularSpace{
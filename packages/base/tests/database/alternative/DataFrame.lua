@@ -27,7 +27,7 @@ return{
 		local error_func = function()
 			DataFrame{file = "dump"}
 		end
-		unitTest:assertError(error_func, "File 'dump' does not have '.lua' extension.")
+		unitTest:assertError(error_func, "File 'dump' does not have '.lua' or '.tmck' extension.")
 
 		local file = File("dump.lua")
 
@@ -65,6 +65,11 @@ return{
 			df:save(1)
 		end
 		unitTest:assertError(error_func, incompatibleTypeMsg(1, "string", 1))
+
+		error_func = function()
+			df:save("dump.txt")
+		end
+		unitTest:assertError(error_func, invalidFileExtensionMsg(1, "txt"))
 	end
 }
 
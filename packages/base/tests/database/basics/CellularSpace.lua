@@ -223,6 +223,21 @@ return{
 		unitTest:assertType(cs:sample().maxSugar, "number")
 		unitTest:assertType(cs:sample().maxSugar, "number")
 		unitTest:assertType(cs:sample().maxSugar, "number")
+
+		local percentage = 0
+		cs = CellularSpace{
+			file = filePath("test/simple-cs.csv", "base"),
+			sep = ";",
+			select = {"x", "y"},
+			progress = function(value)
+				percentage = value
+			end
+		}
+
+		unitTest:assertEquals(400, #cs)
+		unitTest:assertEquals(100, percentage)
+		unitTest:assertNil(cs:sample().maxSugar)
+		unitTest:assertEquals(cs:get(19, 19).id, "400")
 	end,
 	loadNeighborhood = function(unitTest)
 		local cs1 = CellularSpace{
@@ -43,6 +43,30 @@ return{
 		end
 
 		File(filename):deleteIfExists()
+
+		filename = "dump.tmck"
+		expected = DataFrame{
+			first = 2000,
+			step = 10,
+			demand = {7, 8, 9, 10},
+			limit = {0.1, 0.04, 0.3, 0.07},
+			native = true
+		}
+
+		expected:save(filename)
+		actual = DataFrame{file = filename, native = true}
+
+		unitTest:assertEquals(#actual, 4)
+		unitTest:assertEquals(actual.demand[2010], 8)
+		unitTest:assertEquals(actual[2030].limit, 0.07)
+		unitTest:assertEquals(actual:sum("demand"), 34)
+
+		actual = DataFrame{file = filename}
+
+		unitTest:assertEquals(#actual, 4)
+		unitTest:assertEquals(actual.limit[2020], 0.3)
+
+		File(filename):deleteIfExists()
 	end,
 	save = function(unitTest)
 		local filename = "dump.lua"
@@ -55,6 +79,23 @@ return{
 		expected:save(filename)
 
 		unitTest:assertFile(filename)
+
+		filename = "dump.csv"
+		expected:save(filename)
+
+		unitTest:assertFile(filename)
+
+		expected = DataFrame{
+			age = {1, 3, 3},
+			wealth = {10, 8, 15},
+			vision = {2, 1, 2},
+			native = true
+		}
+
+		filename = "dump-native.csv"
+		expected:save(filename)
+
+		unitTest:assertFile(filename)
 	end
 }
 
@@ -104,6 +104,76 @@ return{
 			}
 		end
 		unitTest:assertError(error_func, "Argument 'instance' should be an isTable() object, got number.")
+
+		local df = DataFrame{
+			x = {1, 2, 3},
+			native = true
+		}
+
+		error_func = function()
+			df[1].x = "a"
+		end
+		unitTest:assertError(error_func, "Column 'x' should have values of type number, got string.")
+
+		error_func = function()
+			df[4].x = 4
+		end
+		unitTest:assertError(error_func, "Position 4 does not exist in the DataFrame.")
+
+		error_func = function()
+			df:add({x = 4}, 6)
+		end
+		unitTest:assertError(error_func, "Position 6 is out of the DataFrame.")
+
+		error_func = function()
+			df:remove(5)
+		end
+		unitTest:assertError(error_func, "Position 5 does not exist in the DataFrame.")
+	end,
+	quantile = function(unitTest)
+		local df = DataFrame{x = {1, 2, 3}}
+
+		local error_func = function()
+			df:quantile("x")
+		end
+		unitTest:assertError(error_func, mandatoryArgumentMsg(2))
+
+		error_func = function()
+			df:quantile("x", 1.5)
+		end
+		unitTest:assertError(error_func, "Argument '#2' should be between 0 and 1, got 1.5.")
+	end,
+	sum = function(unitTest)
+		local df = DataFrame{
+			x = {1, 2, 3},
+			y = {"a", "b", "c"}
+		}
+
+		local error_func = function()
+			df:sum()
+		end
+		unitTest:assertError(error_func, mandatoryArgumentMsg(1))
+
+		error_func = function()
+			df:sum("z")
+		end
+		unitTest:assertError(error_func, valueNotFoundMsg(1, "z"))
+
+		error_func = function()
+			df:sum("y")
+		end
+		unitTest:assertError(error_func, "Column 'y' should have numeric values, got string.")
+
+		df = DataFrame{
+			x = {1, 2, 3},
+			y = {"a", "b", "c"},
+			native = true
+		}
+
+		error_func = function()
+			df:sum("y")
+		end
+		unitTest:assertError(error_func, "Column 'y' should have numeric values, got string.")
 	end
 }
 
@@ -117,6 +117,19 @@ return{
 		end
 		unitTest:assertError(error_func, incompatibleTypeMsg(1, "Agent, Automaton, Cell, CellularSpace, Environment, Group, Society, Timer or Trajectory", unitTest))
 	end,
+	checkpoint = function(unitTest)
+		local env = Environment{}
+
+		local error_func = function()
+			env:checkpoint()
+		end
+		unitTest:assertError(error_func, mandatoryArgumentMsg(1))
+
+		error_func = function()
+			env:checkpoint(2)
+		end
+		unitTest:assertError(error_func, incompatibleTypeMsg(1, "File", 2))
+	end,
 	createPlacement = function(unitTest)
 		local ag1 = Agent{}
 
@@ -170,6 +183,21 @@ return{
 		end
 		unitTest:assertError(error_func, positiveArgumentMsg("max", -13))
 
+		error_func = function()
+			env:createPlacement{native = 1}
+		end
+		unitTest:assertError(error_func, incompatibleTypeMsg("native", "boolean", 1))
+
+		cs = CellularSpace{xdim = 5}
+		sc1 = Society{instance = Agent{}, quantity = 5}
+		env = Environment{cs, sc1}
+		env:createPlacement{native = true}
+
+		error_func = function()
+			table.insert(cs.cells[1].agents, sc1.agents[1])
+		end
+		unitTest:assertError(error_func, "The Agents of a native placement can only be changed by Agent:enter(), Agent:leave(), and Agent:move().")
+
 		cs = CellularSpace{xdim = 2}
 		ag1 = Agent{}
 		sc1 = Society{instance = ag1, quantity = 20}
@@ -251,6 +279,20 @@ return{
 			env:notify(-1)
 		end
 		unitTest:assertError(error_func, positiveArgumentMsg(1, -1, true))
+	end,
+	restore = function(unitTest)
+		local env = Environment{}
+
+		local error_func = function()
+			env:restore()
+		end
+		unitTest:assertError(error_func, mandatoryArgumentMsg(1))
+
+		local file = File("environment-missing.tmck")
+
+		error_func = function()
+			env:restore(file)
+		end
+		unitTest:assertError(error_func, resourceNotFoundMsg(1, file))
 	end
 }
-
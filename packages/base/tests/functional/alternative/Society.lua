@@ -65,6 +65,15 @@ return{
 		end
 		unitTest:assertError(error_func, positiveArgumentMsg("quantity", -15, true))
 
+		error_func = function()
+			Society{
+				instance = ag1,
+				quantity = 5,
+				stable = 1
+			}
+		end
+		unitTest:assertError(error_func, incompatibleTypeMsg("stable", "boolean", 1))
+
 		ag1 = Agent{id = "2"}
 
 		error_func = function()
@@ -292,6 +301,37 @@ return{
 		end
 		unitTest:assertError(error_func, "Argument 'inmemory' does not work with strategy 'void'.")
 
+		error_func = function()
+			sc1:createSocialNetwork{
+				strategy = "quantity",
+				quantity = 2,
+				name = "native",
+				inmemory = false,
+				native = true
+			}
+		end
+		unitTest:assertError(error_func, "Argument 'native' does not work with 'inmemory' equal to false.")
+
+		error_func = function()
+			sc1:createSocialNetwork{
+				strategy = "quantity",
+				quantity = 20,
+				name = "native",
+				native = true
+			}
+		end
+		unitTest:assertError(error_func, "It is not possible to connect such amount of agents (20). The Society only has 20 agents.")
+
+		error_func = function()
+			sc1:createSocialNetwork{
+				strategy = "quantity",
+				quantity = 2,
+				name = "native",
+				native = 1
+			}
+		end
+		unitTest:assertError(error_func, incompatibleTypeMsg("native", "boolean", 1))
+
 		error_func = function()
 			sc1:createSocialNetwork{
 				strategy = "quantity",
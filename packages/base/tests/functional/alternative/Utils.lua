@@ -106,6 +106,26 @@ return{
 			forEachCell(CellularSpace{xdim = 5})
 		end
 		unitTest:assertError(error_func, incompatibleTypeMsg(2, "function"))
+
+		error_func = function()
+			forEachCell(CellularSpace{xdim = 5}, function() end, {parallel = true})
+		end
+		unitTest:assertError(error_func, "Argument 'parallel' requires a CellularSpace with native attributes.")
+
+		local cs = CellularSpace{xdim = 5, native = {"value"}}
+		local values = {}
+
+		error_func = function()
+			forEachCell(cs, function(cell) values[cell.x] = cell.value end, {parallel = true})
+		end
+		unitTest:assertError(error_func, "Variable 'values' (table) cannot be used in a parallel forEachCell. Only numbers, strings and booleans can be shared.")
+
+		local count = 0
+
+		error_func = function()
+			forEachCell(cs, function() count = count + 1 end, {parallel = true})
+		end
+		unitTest:assertError(error_func, "Variable 'count' cannot be changed in a parallel forEachCell, as each thread has its own copy of the variables from outside the function.")
 	end,
 	forEachCellPair = function(unitTest)
 		local cs1 = CellularSpace{xdim = 10}
@@ -288,6 +308,21 @@ return{
 			forEachNeighborAgent(predators:sample())
 		end
 		unitTest:assertError(error_func, incompatibleTypeMsg(2, "function"))
+
+		error_func = function()
+			forEachNeighborAgent(predators:sample(), "1")
+		end
+		unitTest:assertError(error_func, incompatibleTypeMsg(3, "function"))
+
+		error_func = function()
+			forEachNeighborAgent(predators:sample(), -1, function() end)
+		end
+		unitTest:assertError(error_func, positiveArgumentMsg(2, -1, true))
+
+		error_func = function()
+			forEachNeighborAgent(predators:sample(), "abc", function() end)
+		end
+		unitTest:assertError(error_func, "Neighborhood 'abc' does not exist.")
 	end,
 	forEachNeighborhood = function(unitTest)
 		local cs = CellularSpace{xdim = 10}
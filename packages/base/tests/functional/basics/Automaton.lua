@@ -221,6 +221,54 @@ id     string [MyAutomaton]
 		at1:execute(ev)
 		unitTest:assertEquals(3, at1.cont)
 		unitTest:assertEquals(14, cont)
+
+		-- two automata sharing a CellularSpace, jumping in alternate steps
+		cs = CellularSpace{xdim = 5}
+
+		local function alternate(name, parity, target)
+			return Jump{
+				function(event, _, cell)
+					local time = event:getTime()
+					if time % 2 == parity and cell[name] ~= time then
+						cell[name] = time
+						return true
+					end
+
+					return false
+				end,
+				target = target
+			}
+		end
+
+		local odd = Automaton{
+			it = Trajectory{target = cs},
+			State{id = "odd1", alternate("lastOdd", 1, "odd2")},
+			State{id = "odd2", alternate("lastOdd", 1, "odd1")}
+		}
+
+		local even = Automaton{
+			it = Trajectory{target = cs},
+			State{id = "even1", alternate("lastEven", 0, "even2")},
+			State{id = "even2", alternate("lastEven", 0, "even1")}
+		}
+
+		Environment{cs, odd, even}
+		odd:setTrajectoryStatus(true)
+		even:setTrajectoryStatus(true)
+
+		for time = 1, 6 do
+			ev = Event{start = time, action = function() end}
+			odd:execute(ev)
+			even:execute(ev)
+
+			local oddState = "odd"..(math.floor((time + 1) / 2) % 2 + 1)
+			local evenState = "even"..(math.floor(time / 2) % 2 + 1)
+
+			forEachCell(cs, function(cell)
+				unitTest:assertEquals(odd:getStateName(cell), oddState)
+				unitTest:assertEquals(even:getStateName(cell), evenState)
+			end)
+		end
 	end,
 	getId = function(unitTest)
 		unitTest:assert(true)
@@ -75,6 +75,23 @@ return{
 		unitTest:assert(not cs:deforest())
 		unitTest:assertEquals(cs:defor(), 150)
 
+		cs = CellularSpace{
+			instance = Cell{defor = 2, road = false, cover = "forest"},
+			xdim = 10,
+			native = {"defor"}
+		}
+
+		unitTest:assertEquals(tostring(cs:defor()), tostring(200))
+
+		cs.cells[1].defor = 10.5
+		cs.cells[1].road = true
+		cs.cells[2].cover = "pasture"
+
+		unitTest:assertEquals(cs:defor(), 208.5)
+		unitTest:assertEquals(cs:road(), 1)
+		unitTest:assertEquals(cs:cover().forest, 99)
+		unitTest:assertEquals(cs:cover().pasture, 1)
+
 		-- Shapefile
 		local projName = "cellspace.tview"
 		local author = "Avancini"
@@ -463,6 +480,19 @@ ydim    number [20]
 		unitTest:assertEquals(12, sizes[5])
 		unitTest:assertEquals(9, sizes[8])
 
+		local cell = cs:get(2, 2)
+		local neighborhood = cell:getNeighborhood()
+		local neighbor = cs:get(1, 1)
+
+		unitTest:assertEquals(0.125, neighborhood:getWeight(neighbor), 0.00001)
+		neighborhood:setWeight(neighbor, 0.5)
+		unitTest:assertEquals(0.5, neighborhood:getWeight(neighbor))
+
+		neighborhood:remove(neighbor)
+		unitTest:assertEquals(7, #neighborhood)
+		unitTest:assert(not neighborhood:isNeighbor(neighbor))
+		unitTest:assertEquals(8, #cs:get(2, 3):getNeighborhood())
+
 		cs:createNeighborhood{name = "neigh2"}
 
 		forEachNeighbor(cs:sample(), "neigh2", function(c, neigh)
@@ -1628,6 +1658,59 @@ ydim    number [20]
 
 		forEachCell(cs, function(cell) unitTest:assertEquals(3, cell.past.value) end)
 		forEachCell(cs, function(cell) unitTest:assertEquals(0, cell.value) end)
+
+		cs = CellularSpace{
+			xdim = 5,
+			native = {"value"}
+		}
+
+		forEachCell(cs, function(cell)
+			unitTest:assertEquals(0, cell.value)
+			cell.value = cell.x + cell.y
+			cell.cover = "forest"
+		end)
+
+		cs:synchronize()
+		forEachCell(cs, function(cell) cell.value = 0 end)
+
+		forEachCell(cs, function(cell)
+			unitTest:assertEquals(cell.x + cell.y, cell.past.value)
+			unitTest:assertEquals("forest", cell.past.cover)
+			unitTest:assertEquals(0, cell.value)
+		end)
+
+		unitTest:assertNil(rawget(cs.cells[1], "value"))
+
+		cs:synchronize("value")
+		forEachCell(cs, function(cell)
+			unitTest:assertEquals(0, cell.past.value)
+			unitTest:assertNil(cell.past.cover)
+		end)
+
+		forEachCell(cs, function(cell)
+			cell.cover = "pasture"
+			cell.road = true
+		end)
+
+		cs:synchronize{"value", "cover"}
+		forEachCell(cs, function(cell)
+			unitTest:assertEquals("pasture", cell.past.cover)
+			unitTest:assertNil(cell.past.road)
+		end)
+
+		cs.cells[1].cover = "forest"
+		cs:synchronize("cover")
+		unitTest:assertEquals("forest", cs.cells[1].past.cover)
+		unitTest:assertEquals("pasture", cs.cells[2].past.cover)
+
+		cs:synchronize("value")
+		forEachCell(cs, function(cell) unitTest:assertNil(cell.past.cover) end)
+
+		local cell = cs.cells[1]
+		cell.value = 4
+		cell:synchronize()
+		unitTest:assertEquals(4, cell.past.value)
+		unitTest:assertEquals(0, cs.cells[2].past.value)
 	end
 }
 
@@ -115,6 +115,49 @@ return{
 		}
 
 		unitTest:assertType(df[1], "Agent")
+
+		df = DataFrame{
+			{x = 1, y = "a"},
+			{x = 2, y = "b"},
+			{x = 3, y = "a"},
+			native = true
+		}
+
+		unitTest:assertType(df, "DataFrame")
+		unitTest:assertEquals(#df, 3)
+		unitTest:assertEquals(#df.x, 3)
+		unitTest:assertEquals(df[2].x, 2)
+		unitTest:assertEquals(df.y[3], "a")
+
+		df[1].x = 1.5
+		df[2].z = true
+
+		unitTest:assertEquals(df.x[1], 1.5)
+		unitTest:assertEquals(df[2].x, 2)
+		unitTest:assertEquals(df.z[2], true)
+		unitTest:assertNil(df[1].z)
+
+		tab = DataFrame{
+			first = 2000,
+			step = 10,
+			demand = {7, 8, 9, 10},
+			native = true
+		}
+
+		unitTest:assertEquals(#tab, 4)
+		unitTest:assertEquals(tab.demand[2010], 8)
+		unitTest:assertEquals(tab[2030].demand, 10)
+
+		sumidx = 0
+		sumvalue = 0
+
+		forEachElement(tab.demand, function(idx, value)
+			sumidx = sumidx + idx
+			sumvalue = sumvalue + value
+		end)
+
+		unitTest:assertEquals(sumidx, 2000 + 2010 + 2020 + 2030)
+		unitTest:assertEquals(sumvalue, 7 + 8 + 9 + 10)
 	end,
 	add = function(unitTest)
 		local df = DataFrame{
@@ -157,6 +200,51 @@ return{
 		unitTest:assert(cols.y)
 		unitTest:assertEquals(getn(cols), 2)
 	end,
+	max = function(unitTest)
+		local df = DataFrame{x = {4, 2, 3, 1}}
+
+		unitTest:assertEquals(df:max("x"), 4)
+
+		df = DataFrame{x = {4, 2, 3, 1}, native = true}
+		df:add{x = 7.5}
+
+		unitTest:assertEquals(df:max("x"), 7.5)
+	end,
+	mean = function(unitTest)
+		local df = DataFrame{x = {1, 2, 3, 4}}
+
+		unitTest:assertEquals(df:mean("x"), 2.5)
+
+		df = DataFrame{x = {1, 2, 3, 4}, native = true}
+		df[2].x = nil
+
+		unitTest:assertEquals(df:mean("x"), 8 / 3, 0.0001)
+	end,
+	min = function(unitTest)
+		local df = DataFrame{x = {4, 2, 3, 1}}
+
+		unitTest:assertEquals(df:min("x"), 1)
+
+		df = DataFrame{x = {4, 2, 3, 1}, native = true}
+		df:remove(4)
+
+		unitTest:assertEquals(df:min("x"), 2)
+	end,
+	quantile = function(unitTest)
+		local df = DataFrame{x = {5, 1, 4, 2, 3}}
+
+		unitTest:assertEquals(df:quantile("x", 0), 1)
+		unitTest:assertEquals(df:quantile("x", 0.5), 3)
+		unitTest:assertEquals(df:quantile("x", 0.1), 1.4, 0.0001)
+		unitTest:assertEquals(df:quantile("x", 1), 5)
+
+		df = DataFrame{x = {5, 1, 4, 2, 3}, native = true}
+
+		unitTest:assertEquals(df:quantile("x", 0), 1)
+		unitTest:assertEquals(df:quantile("x", 0.5), 3)
+		unitTest:assertEquals(df:quantile("x", 0.1), 1.4, 0.0001)
+		unitTest:assertEquals(df:quantile("x", 1), 5)
+	end,
 	remove = function(unitTest)
 		local df = DataFrame{
 			{x = 1, y = 1},
@@ -189,6 +277,16 @@ return{
 
 		unitTest:assertEquals(#rows, 5)
 	end,
+	sum = function(unitTest)
+		local df = DataFrame{x = {1, 2, 3, 4}}
+
+		unitTest:assertEquals(df:sum("x"), 10)
+
+		df = DataFrame{x = {1, 2, 3, 4}, native = true}
+		df:add{x = 5}
+
+		unitTest:assertEquals(df:sum("x"), 15)
+	end,
 	__index = function(unitTest)
 		local df = DataFrame{
 			{x = 1, y = 1},
@@ -224,6 +224,76 @@ cObj_  userdata
 id     string [env]
 ]])
 	end,
+	checkpoint = function(unitTest)
+		local build = function()
+			local cs = CellularSpace{xdim = 5}
+
+			forEachCell(cs, function(cell)
+				cell.value = 0
+			end)
+
+			local soc = Society{
+				instance = Agent{
+					energy = 10,
+					execute = function(self)
+						self.energy = self.energy + 1
+					end
+				},
+				quantity = 10
+			}
+
+			local timer = Timer{Event{action = function(ev)
+				forEachCell(cs, function(cell)
+					cell.value = cell.value + 1
+				end)
+
+				soc:execute()
+
+				if ev:getTime() == 3 then
+					soc.agents[1]:die()
+				end
+			end}}
+
+			local env = Environment{cs = cs, soc = soc, timer = timer}
+			env:createPlacement()
+			soc:createSocialNetwork{quantity = 2}
+
+			return env
+		end
+
+		local file = File("environment-checkpoint.tmck")
+		file:deleteIfExists()
+
+		local env1 = build()
+		env1:run(5)
+		env1:checkpoint(file)
+
+		unitTest:assert(file:exists())
+
+		local env2 = build()
+		env2:restore(file)
+
+		unitTest:assertEquals(env2.timer:getTime(), 5)
+		unitTest:assertEquals(#env2.soc, 9)
+		unitTest:assertEquals(env2.cs.cells[7].value, 5)
+
+		forEachElement(env1.soc.agents, function(idx, agent)
+			local other = env2.soc.agents[idx]
+
+			unitTest:assertEquals(other.id, agent.id)
+			unitTest:assertEquals(other.energy, agent.energy)
+			unitTest:assertEquals(other:getCell():getId(), agent:getCell():getId())
+			unitTest:assertEquals(#other:getSocialNetwork(), #agent:getSocialNetwork())
+		end)
+
+		env1:run(10)
+		env2:run(10)
+
+		unitTest:assertEquals(env2.cs.cells[7].value, env1.cs.cells[7].value)
+		unitTest:assertEquals(env2.soc.agents[3].energy, env1.soc.agents[3].energy)
+
+		file:delete()
+	end,
 	createPlacement = function(unitTest)
 		Random():reSeed(12345)
 		local predator = Agent{
@@ -373,6 +443,48 @@ id     string [env]
 		env:createPlacement{max = 200}
 
 		unitTest:assertEquals(#cs.cells[1]:getAgents(), #predators)
+
+		predators = Society{
+			instance = Agent{},
+			quantity = 30
+		}
+
+		cs = CellularSpace{xdim = 5}
+
+		env = Environment{cs, predators}
+		env:createPlacement{strategy = "uniform", native = true}
+
+		local cell = cs.cells[1]
+		unitTest:assertEquals(#cell:getAgents(), 2)
+		unitTest:assertEquals(#cell.agents, 2)
+		unitTest:assertEquals(cell:getAgent(), predators.agents[1])
+		unitTest:assertEquals(cell.agents[2], predators.agents[26])
+		unitTest:assertNil(cell.agents[3])
+
+		local agent = predators.agents[1]
+		unitTest:assertEquals(agent:getCell(), cell)
+
+		agent:move(cs.cells[2])
+		unitTest:assertEquals(agent:getCell(), cs.cells[2])
+		unitTest:assertEquals(#cell.agents, 1)
+		unitTest:assertEquals(cell.agents[1], predators.agents[26])
+		unitTest:assertEquals(#cs.cells[2].agents, 3)
+
+		local count = 0
+		forEachAgent(cs.cells[2], function(ag)
+			unitTest:assertEquals(ag:getCell(), cs.cells[2])
+			count = count + 1
+		end)
+		unitTest:assertEquals(count, 3)
+
+		agent:die()
+		unitTest:assertEquals(#cs.cells[2].agents, 2)
+
+		count = 0
+		forEachCell(cs, function(mcell)
+			count = count + #mcell.agents
+		end)
+		unitTest:assertEquals(count, 29)
 	end,
 	run = function(unitTest)
 		local result = ""
@@ -693,6 +805,62 @@ t 4 e 12 p 11
 		unitTest:assertEquals(scenario2.count, 20 + 30)
 		unitTest:assertEquals(scenario3.count, 5  + 30)
 	end,
+	restore = function(unitTest)
+		local cs = CellularSpace{xdim = 3}
+		local timer = Timer{Event{action = function()
+			forEachCell(cs, function(cell)
+				cell.count = cell.count + 1
+			end)
+		end}}
+
+		forEachCell(cs, function(cell)
+			cell.count = 0
+		end)
+
+		local env = Environment{cs = cs, timer = timer}
+		env:run(4)
+		env:checkpoint("environment-restore.tmck")
+		env:run(8)
+
+		unitTest:assertEquals(cs.cells[1].count, 8)
+
+		env:restore("environment-restore.tmck")
+
+		unitTest:assertEquals(timer:getTime(), 4)
+		unitTest:assertEquals(cs.cells[1].count, 4)
+
+		env:run(6)
+
+		unitTest:assertEquals(cs.cells[1].count, 6)
+
+		File("environment-restore.tmck"):delete()
+
+		cs = CellularSpace{xdim = 3, native = {"value"}}
+
+		forEachCell(cs, function(cell)
+			cell.value = cell.x
+			cell.past.value = cell.y
+			cell.other = 1
+		end)
+
+		env = Environment{cs = cs}
+		env:checkpoint("environment-restore.tmck")
+
+		forEachCell(cs, function(cell)
+			cell.value = 10
+			cell.past.value = 10
+			cell.other = 10
+		end)
+
+		env:restore("environment-restore.tmck")
+
+		unitTest:assertEquals(cs.cells[6].value, cs.cells[6].x)
+		unitTest:assertEquals(cs.cells[6].past.value, cs.cells[6].y)
+		unitTest:assertEquals(cs.cells[6].other, 1)
+		unitTest:assertEquals(cs:value(), 9)
+
+		File("environment-restore.tmck"):delete()
+	end,
 	getTime = function(unitTest)
 		local cs = CellularSpace{xdim = 10}
 
@@ -195,6 +195,7 @@ agents         vector of size 2
 autoincrement  number [3]
 cObj_          userdata
 execute        function
+idindex        named table of size 2
 init           function
 instance       Agent
 messages       vector of size 0
@@ -464,6 +465,63 @@ state_          State
 		unitTest:assertEquals(40, count_barabasi)
 		unitTest:assertEquals(80,  count_erdos)
 		unitTest:assertEquals(80,  count_watts)
+
+		-- native social networks
+		predators = Society{
+			instance = Agent{},
+			quantity = 20
+		}
+
+		predators:createSocialNetwork{quantity = 3, name = "boss", native = true}
+		predators:createSocialNetwork{probability = 0.2, name = "friends", symmetric = true, native = true}
+
+		count_quant = 0
+		forEachAgent(predators, function(ag)
+			local connections = 0
+			forEachConnection(ag, "boss", function(self, friend, weight)
+				unitTest:assert(self ~= friend)
+				unitTest:assertEquals(weight, 1)
+				connections = connections + 1
+			end)
+
+			unitTest:assertEquals(connections, #ag:getSocialNetwork("boss"))
+			count_quant = count_quant + connections
+
+			forEachConnection(ag, "friends", function(self, friend)
+				unitTest:assert(friend:getSocialNetwork("friends"):isConnection(self))
+			end)
+		end)
+
+		unitTest:assertEquals(60, count_quant)
+
+		local boss = predators:get(1):getSocialNetwork("boss")
+		local friend = predators:get(2)
+		if not boss:isConnection(friend) then
+			boss:add(friend)
+		end
+
+		unitTest:assertType(boss, "SocialNetwork")
+		unitTest:assertEquals(4, #boss)
+
+		cs = CellularSpace{xdim = 5}
+		cs:createNeighborhood()
+
+		env = Environment{cs, predators}
+		env:createPlacement{max = 5}
+
+		predators:createSocialNetwork{strategy = "cell", name = "c"}
+		predators:createSocialNetwork{strategy = "cell", name = "nc", native = true}
+		predators:createSocialNetwork{strategy = "neighbor", name = "n"}
+		predators:createSocialNetwork{strategy = "neighbor", name = "nn", native = true}
+
+		forEachAgent(predators, function(ag)
+			unitTest:assertEquals(#ag:getSocialNetwork("c"), #ag:getSocialNetwork("nc"))
+			unitTest:assertEquals(#ag:getSocialNetwork("n"), #ag:getSocialNetwork("nn"))
+
+			forEachConnection(ag, "nn", function(_, connection)
+				unitTest:assert(ag:getSocialNetwork("n"):isConnection(connection))
+			end)
+		end)
 	end,
 	clear = function(unitTest)
 		local agent1 = Agent{}
@@ -486,17 +544,24 @@ state_          State
 
 		unitTest:assertType(soc:get(1), "Agent")
 
-		unitTest:assertNil(soc.idindex)
+		unitTest:assertEquals(getn(soc.idindex), 10)
 
 		local ag = soc:get(1)
 		unitTest:assertEquals(soc:get(ag.id), ag)
-		unitTest:assertEquals(getn(soc.idindex), 10)
 
 		ag = soc:add()
 
+		unitTest:assertEquals(getn(soc.idindex), 11)
+		unitTest:assertEquals(soc:get(ag.id), ag)
+
+		soc:remove(soc:get(3))
 		unitTest:assertEquals(getn(soc.idindex), 10)
+		unitTest:assertEquals(soc:get("4"), soc:get(3))
 		unitTest:assertEquals(soc:get(ag.id), ag)
-		unitTest:assertEquals(getn(soc.idindex), 11)
+
+		soc.agents = {soc:get(2), soc:get(1)}
+		unitTest:assertEquals(soc:get("2"), soc.agents[1])
+		unitTest:assertEquals(getn(soc.idindex), 2)
 	end,
 	remove = function(unitTest)
 		local agent1 = Agent{}
@@ -521,11 +586,39 @@ state_          State
 			quantity = 10
 		}
 
+		local older = 0
+		forEachAgent(sc, function(ag)
+			if ag.age > 5 then older = older + 1 end
+		end)
+
 		sc:remove(function(ag)
 			return ag.age > 5
 		end)
 
 		unitTest:assertEquals(9, #soc1)
+		unitTest:assertEquals(10 - older, #sc)
+
+		forEachAgent(sc, function(ag, i)
+			unitTest:assert(ag.age <= 5)
+			unitTest:assertEquals(sc:get(ag.id), sc:get(i))
+		end)
+
+		local soc2 = Society{
+			instance = Agent{},
+			quantity = 5,
+			stable = false
+		}
+
+		soc2:remove(soc2:get("2"))
+		unitTest:assertEquals(4, #soc2)
+		unitTest:assertEquals("5", soc2:get(2).id)
+		unitTest:assertEquals(soc2:get("5"), soc2:get(2))
+
+		soc2:get("5"):die()
+		unitTest:assertEquals(3, #soc2)
+		unitTest:assertEquals("4", soc2:get(2).id)
+		unitTest:assertEquals(soc2:get("4"), soc2:get(2))
+		unitTest:assertEquals("3", soc2:get(3).id)
 	end,
 	sample = function(unitTest)
 		local agent1 = Agent{}
@@ -626,6 +719,64 @@ state_          State
 		soc:synchronize(20)
 		unitTest:assertEquals(16, received)
 		unitTest:assertEquals(2, sugar)
+
+		local order = {}
+		soc = Society{
+			instance = Agent{
+				on_message = function(self, message)
+					table.insert(order, message.content)
+					if message.content == "first" then
+						self:message{receiver = self, content = "reply", delay = 1}
+					end
+				end
+			},
+			quantity = 2
+		}
+
+		john = soc:get(1)
+		john:message{receiver = soc:get(2), content = "first", delay = 3}
+		john:message{receiver = soc:get(2), content = "second", delay = 1}
+		john:message{receiver = soc:get(2), content = "third", delay = 2}
+		john:message{receiver = soc:get(2), content = "fourth", delay = 5}
+
+		soc:synchronize(3)
+		unitTest:assertEquals(table.concat(order, ","), "first,second,third")
+		unitTest:assertEquals(#soc.messages, 2)
+
+		soc:synchronize()
+		unitTest:assertEquals(table.concat(order, ","), "first,second,third,reply")
+
+		soc:synchronize()
+		unitTest:assertEquals(table.concat(order, ","), "first,second,third,reply,fourth")
+		unitTest:assertEquals(#soc.messages, 0)
+
+		order = {}
+		john:message{receiver = soc:get(2), content = "fractional", delay = 0.3}
+
+		for _ = 1, 3 do
+			soc:synchronize(0.1)
+		end
+
+		unitTest:assertEquals(table.concat(order, ","), "fractional")
+
+		john:message{receiver = soc:get(2), content = "discarded", delay = 2}
+		soc:synchronize()
+		soc.messages = {}
+
+		john:message{receiver = soc:get(2), content = "fifth", delay = 1}
+		soc:synchronize()
+		unitTest:assertEquals(table.concat(order, ","), "fractional,fifth")
+
+		john:message{receiver = soc:get(2), content = "seventh", delay = 3}
+		john:message{receiver = soc:get(2), content = "removed", delay = 2}
+		soc:synchronize()
+		table.remove(soc.messages, 1)
+
+		john:message{receiver = soc:get(2), content = "sixth", delay = 1}
+		soc:synchronize()
+		soc:synchronize()
+		unitTest:assertEquals(table.concat(order, ","), "fractional,fifth,sixth,seventh")
+		unitTest:assertEquals(#soc.messages, 0)
 	end,
 	split = function(unitTest)
 		local nonFooAgent = Agent{
@@ -178,6 +178,21 @@ return {
 		}
 
 		unitTest:assertEquals(#timer:getEvents(), 2)
+
+		local order = {}
+		timer = Timer{
+			Event{start = 2, priority = 1, action = function() table.insert(order, "a") end},
+			Event{start = 1, priority = 2, action = function() table.insert(order, "b") end},
+			Event{start = 2, priority = 0, action = function() table.insert(order, "c") end},
+			Event{start = 1, priority = 2, action = function() table.insert(order, "d") end}
+		}
+
+		local events = timer:getEvents()
+		unitTest:assertEquals(events[1].time, 1)
+		unitTest:assertEquals(events[4].priority, 1)
+
+		timer:run(2)
+		unitTest:assertEquals(table.concat(order), "bdcabd")
 	end,
 	__len = function(unitTest)
 		local timer = Timer{
@@ -205,6 +205,43 @@ return{
 
 		unitTest:assert(not r)
 		unitTest:assertEquals(count, 11)
+
+		cs = CellularSpace{
+			xdim = 10,
+			native = {"value"}
+		}
+
+		forEachCell(cs, function(cell) cell.value = cell.x end)
+		cs:synchronize()
+		cs:createNeighborhood{strategy = "vonneumann"}
+
+		local increment = 1
+		r = forEachCell(cs, function(cell)
+			local sum = 0
+			forEachNeighbor(cell, function(_, neighbor, weight)
+				sum = sum + neighbor.value * weight
+			end)
+
+			cell.value = cell.past.value + increment + sum - sum
+		end, {parallel = true})
+
+		unitTest:assert(r)
+		forEachCell(cs, function(cell) unitTest:assertEquals(cell.value, cell.x + 1) end)
+
+		local step = 2
+		r = forEachCell(cs, function(cell)
+			if tostring(step) ~= "2" or tostring(cell.value) ~= tostring(cell.x + 1) then
+				return false
+			end
+		end, {parallel = true})
+
+		unitTest:assert(r)
+
+		r = forEachCell(cs, function(cell)
+			if cell.x == 5 then return false end
+		end, {parallel = true})
+
+		unitTest:assert(not r)
 	end,
 	forEachCellPair = function(unitTest)
 		local cs1 = CellularSpace{xdim = 10}
@@ -415,6 +452,157 @@ return{
 		end)
 
 		unitTest:assertEquals(count, 4)
+
+		predators = Society{
+			instance = Agent{},
+			quantity = 50
+		}
+
+		cs = CellularSpace{xdim = 5}
+		cs:createNeighborhood()
+		cs:createNeighborhood{strategy = "vonneumann", name = "vn"}
+
+		env = Environment{cs, predators = predators}
+		env:createPlacement{strategy = "uniform"}
+
+		local agent = predators.agents[7] -- in the cell (1, 1)
+
+		count = 0
+		local result = forEachNeighborAgent(agent, function(ag)
+			unitTest:assert(ag ~= agent)
+			count = count + 1
+		end)
+
+		unitTest:assert(result)
+		unitTest:assertEquals(count, 16)
+
+		count = 0
+		forEachNeighborAgent(agent, "vn", function()
+			count = count + 1
+		end)
+
+		unitTest:assertEquals(count, 8)
+
+		count = 0
+		local found = false
+		forEachNeighborAgent(agent, 1.5, function(ag)
+			if ag == agent then found = true end
+			count = count + 1
+		end)
+
+		unitTest:assert(found)
+		unitTest:assertEquals(count, 18)
+
+		count = 0
+		result = forEachNeighborAgent(agent, function()
+			count = count + 1
+			return false
+		end)
+
+		unitTest:assert(not result)
+		unitTest:assertEquals(count, 1)
+
+		predators = Society{
+			instance = Agent{},
+			quantity = 50
+		}
+
+		cs = CellularSpace{xdim = 5}
+		cs:createNeighborhood()
+		cs:createNeighborhood{strategy = "vonneumann", name = "vn"}
+
+		env = Environment{cs, predators = predators}
+		env:createPlacement{strategy = "uniform", native = true}
+
+		agent = predators.agents[7]
+
+		count = 0
+		result = forEachNeighborAgent(agent, function(ag)
+			unitTest:assert(ag ~= agent)
+			count = count + 1
+		end)
+
+		unitTest:assert(result)
+		unitTest:assertEquals(count, 16)
+
+		count = 0
+		forEachNeighborAgent(agent, "vn", function()
+			count = count + 1
+		end)
+
+		unitTest:assertEquals(count, 8)
+
+		count = 0
+		found = false
+		forEachNeighborAgent(agent, 1.5, function(ag)
+			if ag == agent then found = true end
+			count = count + 1
+		end)
+
+		unitTest:assert(found)
+		unitTest:assertEquals(count, 18)
+
+		count = 0
+		forEachNeighborAgent(agent, 0, function()
+			count = count + 1
+		end)
+
+		unitTest:assertEquals(count, 2)
+
+		count = 0
+		result = forEachNeighborAgent(agent, function()
+			count = count + 1
+			return false
+		end)
+
+		unitTest:assert(not result)
+		unitTest:assertEquals(count, 1)
+
+		local neighborIds = function(native)
+			local soc = Society{
+				instance = Agent{},
+				quantity = 30
+			}
+
+			local cells = CellularSpace{xdim = 4}
+			cells:createNeighborhood{self = true}
+
+			local environment = Environment{cells, soc}
+			environment:createPlacement{strategy = "void", native = native}
+
+			for i = 1, #soc.agents do
+				soc.agents[i]:enter(cells.cells[(i * 7) % #cells.cells + 1])
+			end
+
+			local result = {}
+
+			for i = 1, #soc.agents do
+				forEachElement({"1", 1.5}, function(_, name)
+					local ids = {}
+					local itself = false
+
+					forEachNeighborAgent(soc.agents[i], name, function(ag)
+						if ag == soc.agents[i] then itself = true end
+						table.insert(ids, ag.id)
+					end)
+
+					unitTest:assert(itself)
+					table.sort(ids)
+					table.insert(result, table.concat(ids, ","))
+				end)
+			end
+
+			return result
+		end
+
+		local luaIds = neighborIds(false)
+		local nativeIds = neighborIds(true)
+
+		unitTest:assertEquals(#luaIds, 60)
+
+		for i = 1, #luaIds do
+			unitTest:assertEquals(luaIds[i], nativeIds[i])
+		end
 	end,
 	forEachNeighborhood = function(unitTest)
 		local c1 = Cell{}
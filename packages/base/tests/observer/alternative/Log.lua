@@ -72,6 +72,36 @@ return{
 		end
 		unitTest:assertError(error_func, incompatibleTypeMsg("separator", "string", 2))
 
+		error_func = function()
+			Log{target = c, buffer = "10"}
+		end
+		unitTest:assertError(error_func, incompatibleTypeMsg("buffer", "number", "10"))
+
+		error_func = function()
+			Log{target = c, buffer = 1.5}
+		end
+		unitTest:assertError(error_func, integerArgumentMsg("buffer", 1.5))
+
+		error_func = function()
+			Log{target = c, buffer = -1}
+		end
+		unitTest:assertError(error_func, positiveArgumentMsg("buffer", -1, true))
+
+		error_func = function()
+			Log{target = c, flush = -1}
+		end
+		unitTest:assertError(error_func, positiveArgumentMsg("flush", -1, true))
+
+		error_func = function()
+			Log{target = c, format = "bin"}
+		end
+		unitTest:assertError(error_func, switchInvalidArgumentSuggestionMsg("bin", "format", "binary"))
+
+		error_func = function()
+			Log{target = c, compress = true}
+		end
+		unitTest:assertError(error_func, "Argument 'compress' can only be used with format 'binary'.")
+
 		local unit = Cell{}
 
 		error_func = function()
@@ -83,7 +83,116 @@ return{
 		local c1 = InternetSender{target = world, select = "value"}
 
 --]]
-		unitTest:assert(true)
+		local cell = Cell{value = 0}
+
+		-- there is no host listening, therefore the states are discarded
+		InternetSender{target = cell, protocol = "tcp", port = 50001, visible = false, compress = false}
+
+		for i = 1, 100 do
+			cell.value = i
+			cell:notify()
+		end
+
+		clean()
+
+		local receive = function(port, compress)
+			local listener = TeTcpListener()
+			unitTest:assert(listener:listen(port))
+
+			local c = Cell{value = 0}
+			InternetSender{target = c, protocol = "tcp", port = port, visible = false, compress = compress}
+
+			for i = 1, 100 do
+				c.value = i
+				c:notify()
+			end
+
+			-- killing the observer sends the end of the simulation
+			clean()
+
+			return listener:receive(5000)
+		end
+
+		local frames = receive(50002, false)
+
+		unitTest:assert(#frames >= 2)
+
+		forEachElement(frames, function(_, frame)
+			unitTest:assert(not frame.compressed)
+			unitTest:assertEquals(frame.size, #frame.data + 1)
+		end)
+
+		for i = 1, #frames - 1 do
+			unitTest:assert(not frames[i].finished)
+			unitTest:assert(string.find(frames[i].data, "value") ~= nil)
+		end
+
+		unitTest:assert(string.find(frames[#frames - 1].data, "100") ~= nil)
+		unitTest:assert(frames[#frames].finished)
+		unitTest:assertEquals(frames[#frames].data, "COMPLETE_SIMUL")
+
+		frames = receive(50003, true)
+
+		unitTest:assert(#frames >= 2)
+
+		forEachElement(frames, function(_, frame)
+			unitTest:assert(frame.compressed)
+			unitTest:assertType(frame.data, "string")
+		end)
+
+		unitTest:assert(string.find(frames[#frames - 1].data, "value") ~= nil)
+		unitTest:assert(string.find(frames[#frames - 1].data, "100") ~= nil)
+		unitTest:assert(frames[#frames].finished)
+		unitTest:assertEquals(frames[#frames].data, "COMPLETE_SIMUL")
+
+		local listener = TeUdpListener()
+		unitTest:assert(listener:listen(50004))
+
+		cell = Cell{value = 0}
+		InternetSender{target = cell, protocol = "udp", host = "127.0.0.1", port = 50004, visible = false}
+
+		for i = 1, 100 do
+			cell.value = i
+			cell:notify()
+		end
+
+		clean()
+
+		frames = listener:receive(5000)
+
+		unitTest:assertEquals(#frames, 101)
+		unitTest:assertEquals(listener:lost(), 0)
+		unitTest:assert(string.find(frames[100].data, "100") ~= nil)
+		unitTest:assert(frames[101].finished)
+		unitTest:assertEquals(frames[101].data, "COMPLETE_SIMUL")
+
+		-- loopback throughput: each state is received before the next one is sent
+		forEachElement({10, 50, 100}, function(_, size)
+			local udp = TeUdpListener()
+			unitTest:assert(udp:listen(50010 + size))
+
+			local cs = CellularSpace{xdim = size}
+			forEachCell(cs, function(c) c.value = 0 end)
+
+			InternetSender{target = cs, select = "value", protocol = "udp", host = "127.0.0.1", port = 50010 + size, visible = false}
+
+			local quantity = 0
+			local start = os.clock()
+
+			for i = 1, 20 do
+				forEachCell(cs, function(c) c.value = i end)
+				cs:notify()
+				quantity = quantity + #udp:receive(1000, 1)
+			end
+
+			local rate = quantity / math.max(os.clock() - start, 0.001)
+
+			unitTest:assertEquals(quantity, 20)
+			unitTest:assertEquals(udp:lost(), 0)
+			unitTest:assert(rate > 0)
+
+			clean()
+		end)
 	end
 }
 
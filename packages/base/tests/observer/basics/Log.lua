@@ -168,6 +168,38 @@ return{
 		log:update()
 
 		unitTest:assertFile("logfile-update.csv")
+
+		world = Cell{
+			count = 0
+		}
+
+		log = Log{target = world, file = "logfile-buffer.csv", buffer = 10}
+
+		log:update() -- kept in memory
+		log:update()
+
+		unitTest:assertFile("logfile-buffer.csv")
+
+		-- the second update sends only the attribute that changed
+		world = Cell{
+			count = 0,
+			value = 5
+		}
+
+		Log{target = world, file = "logfile-changes.csv"}
+
+		world:notify()
+		world.count = 1
+		world:notify()
+
+		local file = File("logfile-changes.csv")
+		local rows = file:readTable()
+
+		unitTest:assertEquals(#rows, 2)
+		unitTest:assertEquals(rows[2].count, 1)
+		unitTest:assertEquals(rows[2].value, 5)
+
+		file:delete()
 	end
 }
 
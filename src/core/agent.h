@@ -34,6 +34,8 @@ of this software and its documentation.
 
 #include <stdlib.h>
 #include <string>
+#include <vector>
+#include <map>
 
 #include "model.h"
 #include "composite.h"
@@ -63,10 +65,29 @@ class AgentImpl : public Implementation
 	bool actionRegionStatus;  ///< true = action regions ON, false = action regions OFF
 	///< time elapsed since the last change in the agent intern discrete state (ControlMode)
 	double lastChangeTime;
+
+	///< cells of all the action regions, flattened in the order they are traversed
+	vector< pair<CellIndex, Cell*> > actionCells;
+	///< span of each action region in actionCells: from actionOffsets[i] to actionOffsets[i + 1] - 1
+	vector<int> actionOffsets;
+	///< content and version of each action region when actionCells was built
+	vector< pair<const void*, unsigned long> > actionVersions;
+	///< control mode of a LocalAgent in each distinct cell of the action regions
+	vector<ControlMode*> states;
+	///< position of each action cell in the array of states
+	vector<int> statePositions;
+	///< number of changes in the tracked states of the agent in the cells
+	unsigned long controlModesVersion;
+	///< value of controlModesVersion when the states were last synchronized with the cells
+	unsigned long statesVersion;
+	bool statesBuilt; ///< true if the states correspond to the current action cells
 public:
     /// constructor
     ///
-	AgentImpl(void): actionRegionStatus(false), lastChangeTime(0.0) { }
+	AgentImpl(void): actionRegionStatus(false), lastChangeTime(0.0), controlModesVersion(0), statesVersion(0), statesBuilt(false)
+	{
+		actionOffsets.push_back(0);
+	}
 
     /// Get the Agent's "regions of action".
     /// \return The composite of action regions.
@@ -102,6 +123,85 @@ public:
     /// false - the Agent's is ignoring the actions regions,
     ///         the modeler rules must also define the iteration over the cellular space.
 	void setActionRegionStatus(bool status) { actionRegionStatus = status; }
+
+    /// Flattens the action regions into contiguous spans of cells. The spans are rebuilt only
+    /// when some action region was added, replaced or changed since the last call.
+	void updateActionCells(void)
+	{
+		bool changed = actionVersions.size() != (size_t) actionRegions.size();
+
+		ActionRegionCompositeInterf::iterator rgsIterator = actionRegions.begin();
+		for (int i = 0; !changed && (rgsIterator != actionRegions.end()); i++, rgsIterator++)
+			changed = actionVersions[i] != make_pair(rgsIterator->getContent(), rgsIterator->getVersion());
+
+		if (!changed) return;
+
+		actionCells.clear();
+		actionOffsets.assign(1, 0);
+		actionVersions.clear();
+
+		for (rgsIterator = actionRegions.begin(); rgsIterator != actionRegions.end(); rgsIterator++)
+		{
+			actionVersions.push_back(make_pair(rgsIterator->getContent(), rgsIterator->getVersion()));
+
+			Region_<CellIndex>::iterator cellIterator = rgsIterator->begin();
+			while (cellIterator != rgsIterator->end())
+			{
+				actionCells.push_back(*cellIterator);
+				cellIterator++;
+			}
+			actionOffsets.push_back((int) actionCells.size());
+		}
+
+		statesBuilt = false;
+	}
+
+    /// Reads the control mode of the agent in each action cell into the dense array of states.
+    /// It only reads them again when the action cells or any tracked state in the cells changed.
+    /// \param event is the Event being executed
+    /// \param agent is the agent whose states are read
+	void updateStates(Event &event, Agent *agent)
+	{
+		if (statesBuilt && (statesVersion == controlModesVersion)) return;
+
+		map<Cell*, int> positions;
+		states.clear();
+		statePositions.clear();
+
+		for (size_t i = 0; i < actionCells.size(); i++)
+		{
+			Cell *cell = actionCells[i].second;
+			map<Cell*, int>::iterator location = positions.find(cell);
+
+			if (location == positions.end())
+			{
+				location = positions.insert(make_pair(cell, (int) states.size())).first;
+				states.push_back(cell->execute(event, agent));
+			}
+			statePositions.push_back(location->second);
+		}
+
+		statesVersion = controlModesVersion;
+		statesBuilt = true;
+	}
+
+    /// Counts a change in the tracked state of the agent in some cell
+	void controlModesChanged(void) { controlModesVersion++; }
+
+    /// Marks the states as synchronized with the cells
+	void setStatesSynchronized(void) { statesVersion = controlModesVersion; }
+
+    /// Gets the flattened action cells
+	vector< pair<CellIndex, Cell*> >& getActionCells(void) { return actionCells; }
+
+    /// Gets the span of each action region in the flattened action cells
+	vector<int>& getActionOffsets(void) { return actionOffsets; }
+
+    /// Gets the dense array of states
+	vector<ControlMode*>& getStates(void) { return states; }
+
+    /// Gets the position of each action cell in the array of states
+	vector<int>& getStatePositions(void) { return statePositions; }
 };
 
 /**
@@ -204,6 +304,9 @@ public:
 		AgentInterf::pImpl_->setActionRegionStatus(status);
 	}
 
+    /// Counts a change in the tracked state (control mode) of the Agent in some cell.
+	void controlModesChanged(void) { AgentInterf::pImpl_->controlModesChanged(); }
+
     /// Builds a Agent checking if there are invalid ControlMode objects defined as target into the
     /// Agent internal data structure.
     /// \return Returns true if all the target ControlMode are valid, otherwise returns false.
@@ -279,34 +382,42 @@ public:
     /// empty, the LocalAgent will also do nothing.
     /// \param event is a reference to the Event which linked message has triggered the agent control mode execution.
 	bool execute(Event &event) {
-		Region_<CellIndex>::iterator cellIterator;
+		if (!getActionRegionStatus()) return true;
+
+		AgentImpl& impl = *AgentInterf::pImpl_;
+		impl.updateActionCells();
+		impl.updateStates(event, this);
+
+		vector< pair<CellIndex, Cell*> >& actionCells = impl.getActionCells();
+		vector<int>& offsets = impl.getActionOffsets();
+		vector<ControlMode*>& states = impl.getStates();
+		vector<int>& positions = impl.getStatePositions();
 		pair<CellIndex, Cell*> cellIndexPair;
 		ControlMode *controlMode;
 
 		// for each agent action region
-		ActionRegionCompositeInterf& actRgs = getActionRegions();
-		ActionRegionCompositeInterf::iterator rgsIterator = actRgs.begin();
-		while (getActionRegionStatus() && (rgsIterator != actRgs.end()))
+		for (size_t region = 0; getActionRegionStatus() && (region + 1 < offsets.size()); region++)
 		{
 			// for each cell
-			cellIterator = rgsIterator->begin();
-			while (cellIterator != rgsIterator->end())
+			for (int i = offsets[region]; i < offsets[region + 1]; i++)
 			{
 				// gets the agent active control mode
-				cellIndexPair.first = cellIterator->first;
-				cellIndexPair.second = cellIterator->second;
+				cellIndexPair = actionCells[i];
+				controlMode = states[positions[i]];
 
-				// execute the control mode
-				do
+				// execute the control mode. When it returns false the agent jumped,
+				// therefore the new control mode is read from the cell
+				while (controlMode && !controlMode->execute(event, this, cellIndexPair))
 				{
 					controlMode = cellIndexPair.second->execute(event, this);
-					if (!controlMode) break;
-				} while (!controlMode->execute(event, this, cellIndexPair));
-
-				cellIterator++;
+					states[positions[i]] = controlMode;
+				}
 			}
-			rgsIterator++;
 		}
+
+		// the only changes in the cells during the execution are the jumps of this agent,
+		// which were already copied to the array of states
+		impl.setStatesSynchronized();
 		return true;
 	}
 };
@@ -339,12 +450,9 @@ public:
 	bool execute(Event &event) {
 		if (currentControlMode == NULL)
 			currentControlMode = &(*ControlModeCompositeInterf::pImpl_)[0];
-		CompositeInterface< multimapComposite<CellIndex, Cell*> >::iterator cellIterator;
 		pair<CellIndex, Cell*> cellIndexPair;
 
-		// for each agent action region
 		ActionRegionCompositeInterf& actRgs = getActionRegions();
-		ActionRegionCompositeInterf::iterator rgsIterator = actRgs.begin();
 		if ((!getActionRegionStatus()) || actRgs.empty())
 		{
 			cellIndexPair.first.first = -1; cellIndexPair.first.second = -1;
@@ -353,21 +461,23 @@ public:
 			return true;
 		}
 
-		while (getActionRegionStatus() && rgsIterator != actRgs.end())
+		AgentImpl& impl = *AgentInterf::pImpl_;
+		impl.updateActionCells();
+
+		vector< pair<CellIndex, Cell*> >& actionCells = impl.getActionCells();
+		vector<int>& offsets = impl.getActionOffsets();
+
+		// for each agent action region
+		for (size_t region = 0; getActionRegionStatus() && (region + 1 < offsets.size()); region++)
 		{
 			// for each cell
-			cellIterator = rgsIterator->begin();
-			while (getActionRegionStatus() && (cellIterator != rgsIterator->end()))
+			for (int i = offsets[region]; getActionRegionStatus() && (i < offsets[region + 1]); i++)
 			{
-				cellIndexPair.first = cellIterator->first;
-				cellIndexPair.second = cellIterator->second;
+				cellIndexPair = actionCells[i];
 
 				// execute the control mode
 				while (!currentControlMode->execute(event, this, cellIndexPair)){}
-
-				cellIterator++;
 			}
-			rgsIterator++;
 		}
 		return true;
 	}
@@ -392,4 +502,9 @@ public:
 	}
 };
 
+inline void CellImpl::controlModesChanged(Agent *agent)
+{
+	agent->controlModesChanged();
+}
+
 #endif
@@ -31,8 +31,6 @@ of this library and its documentation.
 #ifndef CELL_H
 #define CELL_H
 
-#include <cstring>
-
 #include "bridge.h"
 #include "event.h"
 
@@ -61,23 +59,19 @@ class CellImpl : public Implementation
 	map<Agent*, ControlMode*> targetControlMode_; ///< each cell keeps track of the current state of each automaton whitin itself
 
 public:
-	/// Copies the block of memory used by the implementation of cell.
-	/// \return A pointer to the copied block of memory (the cells implementation).
-	CellImpl* clone(void)
-	{
-		CellImpl *copy =(CellImpl*) new char[sizeof(CellImpl)];
-		memcpy(copy, this, sizeof(CellImpl));
-		return copy;
-	}
-
 	/// Default constructor
 	///
-	CellImpl() {}
+	CellImpl() : latency(0) {}
 
 	/// Destructor
 	///
 	virtual ~CellImpl() {}
 
+	/// Notifies an automaton that its tracked state changed in some cell, so that it can detect
+	/// that its dense array of states is out of date. It is defined in agent.h, after Agent.
+	/// \param agent is a pointer to the automaton
+	static inline void controlModesChanged(Agent *agent);
+
 	/// Updates the tracked state (control mode) of a certain agent within the cell.
 	/// \param  agent is a pointer to an agent within the cell.
 	/// \param controlMode is a pointer to the new agent tracked control mode (discrete state).
@@ -91,6 +85,8 @@ public:
 		}
 		else targetControlMode_.insert(
 				map<Agent*, ControlMode*>::value_type(agent, controlMode));
+
+		controlModesChanged(agent);
 	}
 
 	/// Releases the tracked state (control mode) of a agent within the cell
@@ -101,6 +97,7 @@ public:
 		if (location != targetControlMode_.end())
 		{
 			targetControlMode_.erase(agent);
+			controlModesChanged(agent);
 			return true;
 		}
 		else
@@ -162,29 +159,18 @@ typedef Interface<CellImpl> CellInterf;
 /**
  * \brief
  *  Handle for a Cell object.
+ *  A Cell does not keep a copy of itself as its past. The past of the attributes
+ *  is stored in Lua, in the table past of the cell, or by the luaCellularSpace,
+ *  which keeps the present and the past values of its native attributes in
+ *  contiguous arrays.
  *
  */
 class Cell : public CellInterf
 {
-protected:
-	bool duplicated; ///< A flag that indicates if the cell has been copied (true) or not (false)
-	Cell* past; ///< Each cell keeps track of its past
-
-	/// Copies the block of memory used by the handle and the implementation of cell.
-	/// \return A pointer to the copied block of memory (the handle of the cell).
-	Cell& clone(void)
-	{
-		Cell* copy =(Cell*) new char[sizeof(Cell)];
-
-		memcpy(copy, this, sizeof(Cell));
-		copy->pImpl_ = pImpl_->clone();
-
-		return *copy;
-	}
 public:
 	/// constructor
 	///
-	Cell():duplicated(false) { past =(Cell*) &clone(); }
+	Cell() {}
 
 	/// HANDLE - Updates the tracked state (control mode) of a certain agent within the cell.
 	/// \param  agent is a pointer to an agent within the cell.
@@ -231,28 +217,5 @@ public:
 	/// HANDLE - Sets the list of neighborhood graphs from the cell
 	/// \param neighs is a reference to the list of neighborhoods.
 	void  setNeighborhoods(NeighCmpstInterf& neighs) { pImpl_->setNeighborhoods(neighs); }
-
-	/// Gets the past of the cell.
-	/// \return A pointer to the past of cell.
-	Cell * getPast(void) { return past; }
-
-	/// Updates than cell past copying the current value of its attributes.
-	/// \param sizeMem is the size(in bytes) of the cell with all its attributes.
-	void synchronize(unsigned int sizeMem)
-	{
-		CellImpl* p;
-
-		if (sizeMem <= 0) return;
-		if (!duplicated) {
-			past =(Cell*)new unsigned char[sizeMem];
-			past->pImpl_ = new CellImpl();
-			duplicated = true;
-		}
-
-		p = past->pImpl_;
-		memcpy(past, this, sizeMem);
-		memcpy(p, this->pImpl_, sizeof(CellImpl));
-		past->pImpl_ = p;
-	}
 };
 #endif
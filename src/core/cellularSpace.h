@@ -70,6 +70,39 @@ class CellularSpace : public Model, public CellularSpaceInterf, public Cell,
 					public Region_<CellIndex>
 {
 public:
+    /// Constructor
+    CellularSpace() : gridContent(0), gridVersion(0), gridXMin(0), gridYMin(0), gridWidth(0),
+        gridHeight(0) { }
+
+    /// Searches for a cell by its (x, y) coordinate. Rectangular cellular spaces use a dense
+    /// row-major index, built in the first search after the cells change. Irregular ones,
+    /// such as the ones loaded from shapefiles, search in the multimap. When two cells share
+    /// a coordinate, the last one added is returned, as in CellularSpace:get() in Lua.
+    /// \param indx is the (x, y) coordinate of the cell
+    /// \return a Cell pointer if the cell has been found, otherwise returns a NULL pointer
+    Cell* getCell(const CellIndex& indx) {
+        if ((gridContent != getContent()) || (gridVersion != getVersion()))
+            buildGrid();
+
+        if (!grid.empty())
+        {
+            int x = indx.first - gridXMin;
+            int y = indx.second - gridYMin;
+
+            if ((x < 0) || (y < 0) || (x >= gridWidth) || (y >= gridHeight))
+                return 0;
+            return grid[y * gridWidth + x];
+        }
+
+        Region_<CellIndex>::iterator it = Region_<CellIndex>::find(indx);
+        if (it == Region_<CellIndex>::end())
+            return 0;
+
+        Region_<CellIndex>::iterator next = it;
+        while ((++next != Region_<CellIndex>::end()) && (next->first == indx))
+            it = next;
+        return it->second;
+    }
     /// Attaches agent to all cellular space cell.
     /// \param agent is new agent being inserted into the cellular space
     void attachAgent(class LocalAgent *agent) {
@@ -83,20 +116,58 @@ public:
         detachControlModeFromCells(agent);
     }
 
-    /// Updates than cellular space past copying the current value of all cells attributes over the past values.
-    /// \param sizeMem is the size (in bytes) of the cell with all its attributes, including the ones defined
-    /// in TerraME framework application layer.
-    void synchronize(unsigned int  sizeMem) {
+private:
+    /// Builds the dense index when at least half of the bounding box of the cells is filled
+    void buildGrid() {
         Region_<CellIndex>::iterator theIterator;
+        int xMax = 0, yMax = 0;
+        long count = 0;
+
+        gridContent = getContent();
+        gridVersion = getVersion();
+        grid.clear();
+
         theIterator = Region_<CellIndex>::pImpl_->begin();
         while (theIterator != Region_<CellIndex>::pImpl_->end())
         {
-            theIterator->second->synchronize(sizeMem);
+            const CellIndex& indx = theIterator->first;
+
+            if ((count == 0) || (indx.first < gridXMin)) gridXMin = indx.first;
+            if ((count == 0) || (indx.second < gridYMin)) gridYMin = indx.second;
+            if ((count == 0) || (indx.first > xMax)) xMax = indx.first;
+            if ((count == 0) || (indx.second > yMax)) yMax = indx.second;
+
+            count++;
+            theIterator++;
+        }
+
+        if (count == 0)
+            return;
+
+        gridWidth = xMax - gridXMin + 1;
+        gridHeight = yMax - gridYMin + 1;
+
+        if ((double) gridWidth * gridHeight > 2.0 * count)
+            return;
+
+        grid.assign(gridWidth * gridHeight, (Cell*) 0);
+
+        // the multimap keeps the cells with the same coordinate in the order they were
+        // added, therefore the last one is kept
+        theIterator = Region_<CellIndex>::pImpl_->begin();
+        while (theIterator != Region_<CellIndex>::pImpl_->end())
+        {
+            grid[(theIterator->first.second - gridYMin) * gridWidth
+                 + theIterator->first.first - gridXMin] = theIterator->second;
             theIterator++;
         }
     }
 
-private:
+    vector<Cell*> grid; ///< dense row-major index of the cells
+    const void* gridContent; ///< content of the Region when the dense index was built
+    unsigned long gridVersion; ///< version of the Region when the dense index was built
+    int gridXMin, gridYMin, gridWidth, gridHeight; ///< bounding box of the dense index
+
     /// Attaches a control model of a agent attached to the cellular space to each cell.
     /// Using this method, the cell can keep track of the agents active control mode (or discrete state).
     /// \param agent is a pointer to a agent attached to the cellular space.
@@ -0,0 +1,474 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "checkpoint.h"
+
+extern "C"
+{
+#include <lauxlib.h>
+}
+
+#include <QFile>
+
+#include <cmath>
+#include <cstring>
+
+/// Types of the values stored in a checkpoint
+enum CheckpointTag
+{
+    CK_NIL = 0,
+    CK_FALSE,
+    CK_TRUE,
+    CK_NUMBER,
+    CK_INTEGER,
+    CK_STRING,
+    CK_TABLE,
+    CK_NUMBERS, ///< vector of floating point numbers
+    CK_INTEGERS ///< vector of integer numbers
+};
+
+/// Size of the header: magic, version, flags and size of the content
+static const int CHECKPOINT_HEADER_SIZE = 16;
+
+/// Maximum depth of nested tables, which also stops tables with cycles
+static const int CHECKPOINT_MAX_DEPTH = 100;
+
+static quint16 hostFlags()
+{
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    return CHECKPOINT_BIG_ENDIAN;
+#else
+    return 0;
+#endif
+}
+
+static inline bool isInteger(lua_State *L, int index)
+{
+#if LUA_VERSION_NUM >= 503
+    return lua_isinteger(L, index) != 0;
+#else
+    (void) L;
+    (void) index;
+    return false;
+#endif
+}
+
+/// Writes the values of a Lua table. If the output is null, it only computes their size.
+class CheckpointEncoder
+{
+public:
+    CheckpointEncoder(lua_State *L, char *out) : L(L), out(out), size(0) {}
+
+    bool encode(int index, int depth)
+    {
+        int type = lua_type(L, index);
+
+        switch (type)
+        {
+        case LUA_TNIL:
+            putTag(CK_NIL);
+            return true;
+        case LUA_TBOOLEAN:
+            putTag(lua_toboolean(L, index) ? CK_TRUE : CK_FALSE);
+            return true;
+        case LUA_TNUMBER:
+            if (isInteger(L, index))
+            {
+                qint64 value = (qint64) lua_tointeger(L, index);
+                putTag(CK_INTEGER);
+                put(&value, sizeof(value));
+            }
+            else
+            {
+                double value = lua_tonumber(L, index);
+                putTag(CK_NUMBER);
+                put(&value, sizeof(value));
+            }
+            return true;
+        case LUA_TSTRING:
+        {
+            size_t length;
+            const char *value = lua_tolstring(L, index, &length);
+            quint32 size32 = (quint32) length;
+            putTag(CK_STRING);
+            put(&size32, sizeof(size32));
+            put(value, length);
+            return true;
+        }
+        case LUA_TTABLE:
+            return encodeTable(index, depth);
+        default:
+            error = string("Value of type '") + lua_typename(L, type) + "' cannot be saved in a checkpoint.";
+            return false;
+        }
+    }
+
+    quint64 getSize() const { return size; }
+
+    const string& getError() const { return error; }
+
+private:
+    void put(const void *data, size_t length)
+    {
+        if (out)
+            memcpy(out + size, data, length);
+        size += length;
+    }
+
+    void putTag(char tag)
+    {
+        put(&tag, 1);
+    }
+
+    static bool isArrayKey(lua_State *L, int index, quint32 length)
+    {
+        if (lua_type(L, index) != LUA_TNUMBER)
+            return false;
+
+        double key = lua_tonumber(L, index);
+        return key >= 1 && key <= length && key == floor(key);
+    }
+
+    bool encodeTable(int index, int depth)
+    {
+        if (depth > CHECKPOINT_MAX_DEPTH || !lua_checkstack(L, 4))
+        {
+            error = "Cannot save tables with cycles or with more than " + to_string(CHECKPOINT_MAX_DEPTH)
+                + " levels in a checkpoint.";
+            return false;
+        }
+
+        quint32 length = (quint32) lua_rawlen(L, index);
+        bool floats = length > 0;
+        bool integers = length > 0;
+
+        for (quint32 i = 1; i <= length && (floats || integers); i++)
+        {
+            lua_rawgeti(L, index, i);
+            if (lua_type(L, -1) != LUA_TNUMBER)
+                floats = integers = false;
+            else if (isInteger(L, -1))
+                floats = false;
+            else
+                integers = false;
+            lua_pop(L, 1);
+        }
+
+        quint32 others = 0;
+        lua_pushnil(L);
+        while (lua_next(L, index))
+        {
+            lua_pop(L, 1);
+            if (!isArrayKey(L, -1, length))
+                others++;
+        }
+
+        // vectors of numbers are stored as contiguous arrays
+        if (others == 0 && (floats || integers))
+        {
+            putTag(integers ? CK_INTEGERS : CK_NUMBERS);
+            put(&length, sizeof(length));
+
+            for (quint32 i = 1; i <= length; i++)
+            {
+                lua_rawgeti(L, index, i);
+                if (integers)
+                {
+                    qint64 value = (qint64) lua_tointeger(L, -1);
+                    put(&value, sizeof(value));
+                }
+                else
+                {
+                    double value = lua_tonumber(L, -1);
+                    put(&value, sizeof(value));
+                }
+                lua_pop(L, 1);
+            }
+
+            return true;
+        }
+
+        putTag(CK_TABLE);
+        put(&length, sizeof(length));
+        put(&others, sizeof(others));
+
+        for (quint32 i = 1; i <= length; i++)
+        {
+            lua_rawgeti(L, index, i);
+            bool result = encode(lua_gettop(L), depth + 1);
+            lua_pop(L, 1);
+
+            if (!result)
+                return false;
+        }
+
+        lua_pushnil(L);
+        while (lua_next(L, index))
+        {
+            int value = lua_gettop(L);
+
+            if (!isArrayKey(L, value - 1, length))
+            {
+                if (!encode(value - 1, depth + 1) || !encode(value, depth + 1))
+                {
+                    lua_pop(L, 2);
+                    return false;
+                }
+            }
+
+            lua_pop(L, 1);
+        }
+
+        return true;
+    }
+
+    lua_State *L;
+    char *out;
+    quint64 size;
+    string error;
+};
+
+/// Reads the values written by CheckpointEncoder, pushing them onto the stack
+class CheckpointDecoder
+{
+public:
+    CheckpointDecoder(lua_State *L, const char *data, quint64 size) : L(L), data(data), size(size), position(0) {}
+
+    bool decode(int depth)
+    {
+        if (depth > CHECKPOINT_MAX_DEPTH || !lua_checkstack(L, 4))
+            return false;
+
+        char tag;
+        if (!get(&tag, 1))
+            return false;
+
+        switch (tag)
+        {
+        case CK_NIL:
+            lua_pushnil(L);
+            return true;
+        case CK_FALSE:
+        case CK_TRUE:
+            lua_pushboolean(L, tag == CK_TRUE);
+            return true;
+        case CK_NUMBER:
+        {
+            double value;
+            if (!get(&value, sizeof(value)))
+                return false;
+            lua_pushnumber(L, value);
+            return true;
+        }
+        case CK_INTEGER:
+        {
+            qint64 value;
+            if (!get(&value, sizeof(value)))
+                return false;
+            pushInteger(value);
+            return true;
+        }
+        case CK_STRING:
+        {
+            quint32 length;
+            if (!get(&length, sizeof(length)) || position + length > size)
+                return false;
+            lua_pushlstring(L, data + position, length);
+            position += length;
+            return true;
+        }
+        case CK_NUMBERS:
+        case CK_INTEGERS:
+        {
+            quint32 length;
+            if (!get(&length, sizeof(length)) || position + (quint64) length * 8 > size)
+                return false;
+
+            lua_createtable(L, length, 0);
+            for (quint32 i = 1; i <= length; i++)
+            {
+                if (tag == CK_NUMBERS)
+                {
+                    double value;
+                    get(&value, sizeof(value));
+                    lua_pushnumber(L, value);
+                }
+                else
+                {
+                    qint64 value;
+                    get(&value, sizeof(value));
+                    pushInteger(value);
+                }
+                lua_rawseti(L, -2, i);
+            }
+            return true;
+        }
+        case CK_TABLE:
+        {
+            quint32 length, others;
+            if (!get(&length, sizeof(length)) || !get(&others, sizeof(others)))
+                return false;
+
+            // each value has at least one byte, which avoids allocating corrupted sizes
+            if (position + (quint64) length + 2 * (quint64) others > size)
+                return false;
+
+            lua_createtable(L, length, others);
+            for (quint32 i = 1; i <= length; i++)
+            {
+                if (!decode(depth + 1))
+                    return false;
+                lua_rawseti(L, -2, i);
+            }
+
+            for (quint32 i = 0; i < others; i++)
+            {
+                if (!decode(depth + 1) || !decode(depth + 1) || lua_isnil(L, -2))
+                    return false;
+                lua_rawset(L, -3);
+            }
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    bool atEnd() const { return position == size; }
+
+private:
+    bool get(void *value, size_t length)
+    {
+        if (position + length > size)
+            return false;
+
+        memcpy(value, data + position, length);
+        position += length;
+        return true;
+    }
+
+    void pushInteger(qint64 value)
+    {
+#if LUA_VERSION_NUM >= 503
+        lua_pushinteger(L, (lua_Integer) value);
+#else
+        lua_pushnumber(L, (lua_Number) value);
+#endif
+    }
+
+    lua_State *L;
+    const char *data;
+    quint64 size;
+    quint64 position;
+};
+
+bool Checkpoint::save(lua_State *L, int index, const string& filename, string& error)
+{
+    index = lua_absindex(L, index);
+
+    // the first pass computes the size of the file, which is then mapped and filled
+    CheckpointEncoder counter(L, 0);
+    if (!counter.encode(index, 0))
+    {
+        error = counter.getError();
+        return false;
+    }
+
+    quint64 content = counter.getSize();
+    quint64 total = CHECKPOINT_HEADER_SIZE + content;
+
+    QFile file(QString::fromLocal8Bit(filename.c_str()));
+    uchar *map = 0;
+
+    if (file.open(QIODevice::ReadWrite | QIODevice::Truncate) && file.resize(total))
+        map = file.map(0, total);
+
+    if (!map)
+    {
+        error = "File '" + filename + "' could not be written.";
+        return false;
+    }
+
+    quint16 version = CHECKPOINT_VERSION;
+    quint16 flags = hostFlags();
+    memcpy(map, CHECKPOINT_MAGIC, 4);
+    memcpy(map + 4, &version, sizeof(version));
+    memcpy(map + 6, &flags, sizeof(flags));
+    memcpy(map + 8, &content, sizeof(content));
+
+    CheckpointEncoder writer(L, (char*) map + CHECKPOINT_HEADER_SIZE);
+    writer.encode(index, 0);
+
+    file.unmap(map);
+    file.close();
+    return true;
+}
+
+bool Checkpoint::load(lua_State *L, const string& filename, string& error)
+{
+    QFile file(QString::fromLocal8Bit(filename.c_str()));
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = "File '" + filename + "' could not be read.";
+        return false;
+    }
+
+    quint64 total = file.size();
+    const uchar *map = total >= (quint64) CHECKPOINT_HEADER_SIZE ? file.map(0, total) : 0;
+
+    quint16 version = 0;
+    quint16 flags = 0;
+    quint64 content = 0;
+
+    if (map)
+    {
+        memcpy(&version, map + 4, sizeof(version));
+        memcpy(&flags, map + 6, sizeof(flags));
+        memcpy(&content, map + 8, sizeof(content));
+    }
+
+    bool valid = map && memcmp(map, CHECKPOINT_MAGIC, 4) == 0 && version == CHECKPOINT_VERSION
+        && flags == hostFlags() && content == total - CHECKPOINT_HEADER_SIZE;
+
+    int top = lua_gettop(L);
+
+    if (valid)
+    {
+        CheckpointDecoder decoder(L, (const char*) map + CHECKPOINT_HEADER_SIZE, content);
+        valid = decoder.decode(0) && decoder.atEnd();
+    }
+
+    if (map)
+        file.unmap((uchar*) map);
+    file.close();
+
+    if (!valid)
+    {
+        lua_settop(L, top);
+        error = "File '" + filename + "' is not a valid checkpoint.";
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,80 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*!
+  \file checkpoint.h
+  \brief This file contains definitions about the binary checkpoint files: Checkpoint class.
+*/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+extern "C"
+{
+#include <lua.h>
+}
+
+#include <QtGlobal>
+
+#include <string>
+using namespace std;
+
+/// Identifies a checkpoint file
+static const char CHECKPOINT_MAGIC[4] = {'T', 'M', 'C', 'K'};
+
+/// Version of the checkpoint layout
+static const quint16 CHECKPOINT_VERSION = 1;
+
+/// Flag set when the checkpoint was written by a big-endian host
+static const quint16 CHECKPOINT_BIG_ENDIAN = 0x0001;
+
+/**
+ * \brief
+ *  Saves a Lua table into a binary file and loads it back. The file has a header with
+ *  CHECKPOINT_MAGIC, the version, the flags and the size of the content, followed by
+ *  the values. Each value starts with a tag byte. Vectors of numbers are stored as
+ *  contiguous arrays, therefore attributes stored as one vector for each attribute are
+ *  copied at once. Tables can only have numbers, strings, booleans and other tables.
+ *  The file is written and read through memory mapping.
+ *
+ */
+class Checkpoint
+{
+public:
+    /// Saves a table into a file, replacing it if it already exists
+    /// \param L is a Lua stack
+    /// \param index is the position of the table in the stack
+    /// \param filename is the path to the file
+    /// \param error receives the reason of the failure
+    /// \return false if the table cannot be saved
+    static bool save(lua_State *L, int index, const string& filename, string& error);
+
+    /// Loads a table from a file and pushes it onto the stack
+    /// \param L is a Lua stack
+    /// \param filename is the path to the file
+    /// \param error receives the reason of the failure
+    /// \return false if the file is not a valid checkpoint. Nothing is pushed in this case
+    static bool load(lua_State *L, const string& filename, string& error);
+};
+
+#endif
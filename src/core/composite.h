@@ -253,11 +253,15 @@ public:
     typedef typename multimap<TKey, TElmnt, less<TKey> >::iterator iterator;
     typedef typename multimap<TKey, TElmnt, less<TKey> >::reverse_iterator reverse_iterator;
 
+    /// Constructor
+    multimapComposite() : version_(0) {}
+
     /// Add a new component
     void add(const T& comp)
     {
     	components_.insert(typename multimap<TKey, TElmnt, less<TKey> >::value_type(
     			comp.first, comp.second));
+        version_++;
     }
 
     /// Remove the i-th component
@@ -268,6 +272,7 @@ public:
         if (location != components_.end())
         {
             components_.erase(k);
+            version_++;
             return true;
         }
         return false;
@@ -281,6 +286,7 @@ public:
         if (location != components_.end())
         {
             components_.erase(comp.first);
+            version_++;
             return true;
         }
         return false;
@@ -292,13 +298,14 @@ public:
         if (location != components_.end())
         {
             components_.erase(location);
+            version_++;
         }
         return itr;
     }
 
     /// Remove all components
     void clear()
-    { components_.clear(); }
+    { components_.clear(); version_++; }
 
     /// Return the composite size
     int size()
@@ -318,6 +325,10 @@ public:
         return location;
     }
 
+    /// Return the number of changes in the composite, used to detect them
+    unsigned long version()
+    { return version_; }
+
     /// Check if the composite is empty
     bool empty()
     { return components_.empty(); }
@@ -348,6 +359,7 @@ public:
 
 protected:
     multimap<TKey, TElmnt, less<TKey> >	components_;
+    unsigned long version_; ///< incremented by each change in the components
 };
 //////////////////////////////////////////////////////////////////////////////////////
 template < class CpstImpl >
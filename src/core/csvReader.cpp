@@ -0,0 +1,463 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "csvReader.h"
+
+extern "C"
+{
+#include <lauxlib.h>
+}
+
+#include <algorithm>
+#include <cstring>
+
+CsvReader::CsvReader(const string& filename, char separator)
+    : file(QString::fromLocal8Bit(filename.c_str())), data(0), size(0), position(0),
+      separator(separator)
+{
+}
+
+CsvReader::~CsvReader()
+{
+    if (data && size > 0)
+        file.unmap((uchar*) data);
+
+    file.close();
+}
+
+bool CsvReader::open()
+{
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    size = file.size();
+    position = 0;
+
+    // an empty file cannot be mapped
+    if (size == 0)
+    {
+        data = "";
+        return true;
+    }
+
+    data = (const char*) file.map(0, size);
+    return data != 0;
+}
+
+bool CsvReader::nextLine(const char *&begin, int &lineSize)
+{
+    if (position >= size)
+        return false;
+
+    begin = data + position;
+    const char *end = (const char*) memchr(begin, '\n', size - position);
+
+    if (end)
+        position = end - data + 1;
+    else
+    {
+        end = data + size;
+        position = size;
+    }
+
+    // files with windows line breaks
+    if (end > begin && *(end - 1) == '\r')
+        end--;
+
+    lineSize = (int) (end - begin);
+    return true;
+}
+
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+static void trim(string& value)
+{
+    size_t first = 0;
+    size_t last = value.size();
+
+    while (first < last && isSpace(value[first])) first++;
+    while (last > first && isSpace(value[last - 1])) last--;
+
+    if (first > 0 || last < value.size())
+        value = value.substr(first, last - first);
+}
+
+bool CsvReader::split(const char *begin, int lineSize, vector<string>& values, int &count) const
+{
+    int pos = 0;
+    count = 0;
+
+    while (pos < lineSize)
+    {
+        if ((int) values.size() <= count)
+            values.push_back(string());
+
+        string &value = values[count];
+        value.clear();
+        count++;
+
+        if (begin[pos] == '"')
+        {
+            // quoted value: two quotes in sequence are read as a single quote
+            for (;;)
+            {
+                const char *end = (const char*) memchr(begin + pos + 1, '"', lineSize - pos - 1);
+                if (!end)
+                    return false;
+
+                int endPos = (int) (end - begin);
+                value.append(begin + pos + 1, endPos - pos - 1);
+                pos = endPos + 1;
+
+                if (pos < lineSize && begin[pos] == '"')
+                    value.push_back('"');
+                else
+                    break;
+            }
+
+            if (pos < lineSize && begin[pos] != separator)
+                return false;
+
+            pos++;
+        }
+        else
+        {
+            const char *end = (const char*) memchr(begin + pos, separator, lineSize - pos);
+
+            if (end)
+            {
+                value.assign(begin + pos, end - begin - pos);
+                pos = (int) (end - begin) + 1;
+            }
+            else
+            {
+                value.assign(begin + pos, lineSize - pos);
+                pos = lineSize;
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+        trim(values[i]);
+
+    return true;
+}
+
+int CsvReader::getProgress() const
+{
+    if (size == 0)
+        return 100;
+
+    return (int) (position * 100 / size);
+}
+
+/// Pushes a value converted to a number using the same rules of tonumber(),
+/// or the string itself if it is not a number
+static void pushValue(lua_State *L, const string& value)
+{
+#if LUA_VERSION_NUM >= 503
+    if (value.empty() || lua_stringtonumber(L, value.c_str()) == 0)
+        lua_pushlstring(L, value.data(), value.size());
+#else
+    lua_pushlstring(L, value.data(), value.size());
+
+    if (lua_isnumber(L, -1))
+    {
+        lua_Number number = lua_tonumber(L, -1);
+        lua_pop(L, 1);
+        lua_pushnumber(L, number);
+    }
+#endif
+}
+
+/// Pushes a value converted to a number, or nil if it is not a number
+static void pushNumber(lua_State *L, const string& value)
+{
+    pushValue(L, value);
+
+    if (lua_type(L, -1) != LUA_TNUMBER)
+    {
+        lua_pop(L, 1);
+        lua_pushnil(L);
+    }
+}
+
+static void raiseError(lua_State *L, const string& message)
+{
+    lua_getglobal(L, "customError");
+    lua_pushstring(L, message.c_str());
+    lua_call(L, 1, 0);
+}
+
+static string invalidLine(int line, const char *begin, int size)
+{
+    return "Line " + to_string(line) + " ('" + string(begin, size) + "') is invalid.";
+}
+
+int luaReadCsv(lua_State *L)
+{
+    string filename = luaL_checkstring(L, 1);
+    const char *sep = luaL_optstring(L, 2, ",");
+    bool select = lua_istable(L, 3);
+    bool progress = lua_isfunction(L, 4);
+    bool ids = lua_toboolean(L, 5) != 0;
+
+    string error;
+    int luaError = LUA_NOREF;
+
+    lua_newtable(L);
+    int rows = lua_gettop(L);
+
+    // the reader is destroyed before raising any error, as errors do not unwind the C++ stack.
+    // Therefore, the Lua calls within this scope cannot raise errors other than memory ones
+    {
+        CsvReader reader(filename, sep[0]);
+        vector<string> values;
+        const char *begin;
+        int size;
+        int count = 0;
+
+        if (!reader.open())
+            error = "File '" + filename + "' could not be read.";
+        else if (reader.nextLine(begin, size) && !reader.split(begin, size, values, count))
+            error = invalidLine(1, begin, size);
+
+        vector<string> names(values.begin(), values.begin() + count);
+        vector<int> columns;
+
+        if (error.empty() && select)
+        {
+            int quantity = (int) lua_rawlen(L, 3);
+            for (int i = 1; i <= quantity && error.empty(); i++)
+            {
+                lua_rawgeti(L, 3, i);
+                string name = lua_isstring(L, -1) ? lua_tostring(L, -1) : "";
+                lua_pop(L, 1);
+
+                int column = (int) (find(names.begin(), names.end(), name) - names.begin());
+                if (column == (int) names.size())
+                    error = "Attribute '" + name + "' does not exist in file '" + filename + "'.";
+                else
+                    columns.push_back(column);
+            }
+        }
+        else
+        {
+            for (int i = 0; i < (int) names.size(); i++)
+                columns.push_back(i);
+        }
+
+        // the names are pushed once and then copied to each row. luaL_checkstack would raise
+        // the error from within this scope, skipping the destructor of the reader
+        if (error.empty() && !lua_checkstack(L, (int) columns.size() + 4))
+            error = "File '" + filename + "' has too many attributes.";
+
+        if (!error.empty())
+            columns.clear();
+
+        int keys = lua_gettop(L) + 1;
+        for (size_t i = 0; i < columns.size(); i++)
+            lua_pushstring(L, names[columns[i]].c_str());
+
+        int line = 0;
+        int percentage = -1;
+
+        while (error.empty() && reader.nextLine(begin, size))
+        {
+            line++;
+
+            if (!reader.split(begin, size, values, count))
+            {
+                error = invalidLine(line, begin, size);
+                break;
+            }
+
+            if (count != (int) names.size())
+            {
+                error = "Line " + to_string(line) + " ('" + string(begin, size) + "') should contain "
+                    + to_string(names.size()) + " attributes but has " + to_string(count) + ".";
+                break;
+            }
+
+            lua_createtable(L, 0, (int) columns.size() + (ids ? 1 : 0));
+            for (size_t i = 0; i < columns.size(); i++)
+            {
+                lua_pushvalue(L, keys + (int) i);
+                pushValue(L, values[columns[i]]);
+                lua_rawset(L, -3);
+            }
+
+            if (ids)
+            {
+                lua_pushstring(L, "id");
+                lua_pushstring(L, to_string(line).c_str());
+                lua_rawset(L, -3);
+            }
+
+            lua_rawseti(L, rows, line);
+
+            if (progress && reader.getProgress() != percentage)
+            {
+                percentage = reader.getProgress();
+
+                lua_pushvalue(L, 4);
+                lua_pushnumber(L, percentage);
+                if (lua_pcall(L, 1, 0, 0) != 0)
+                {
+                    luaError = luaL_ref(L, LUA_REGISTRYINDEX);
+                    break;
+                }
+            }
+        }
+    }
+
+    lua_settop(L, rows);
+
+    // errors raised by the progress function are propagated as they are
+    if (luaError != LUA_NOREF)
+    {
+        lua_rawgeti(L, LUA_REGISTRYINDEX, luaError);
+        luaL_unref(L, LUA_REGISTRYINDEX, luaError);
+        return lua_error(L);
+    }
+
+    if (!error.empty())
+        raiseError(L, error);
+
+    return 1;
+}
+
+int luaReadPgm(lua_State *L)
+{
+    string filename = luaL_checkstring(L, 1);
+    const char *sep = luaL_optstring(L, 2, " ");
+
+    string error;
+
+    lua_newtable(L);
+    int result = lua_gettop(L);
+
+    lua_newtable(L);
+    lua_setfield(L, result, "comments");
+
+    lua_newtable(L);
+    int lines = lua_gettop(L);
+
+    {
+        CsvReader reader(filename, sep[0]);
+        vector<string> values;
+        const char *begin;
+        int size;
+        int count = 0;
+        int line = 0;
+        int comments = 0;
+        int rows = 0;
+        bool hasSize = false;
+        bool hasMaximum = false;
+
+        if (!reader.open())
+            error = "File '" + filename + "' could not be read.";
+
+        while (error.empty() && reader.nextLine(begin, size))
+        {
+            line++;
+
+            if (!reader.split(begin, size, values, count))
+            {
+                error = invalidLine(line, begin, size);
+                break;
+            }
+
+            if (line == 1)
+            {
+                if (count > 0)
+                {
+                    lua_pushstring(L, values[0].c_str());
+                    lua_setfield(L, result, "type");
+                }
+
+                continue;
+            }
+
+            // the header ends in the first empty line
+            if (count == 0)
+                break;
+
+            if (values[0].find('#') != string::npos)
+            {
+                if (count > 1)
+                {
+                    string comment = values[1];
+                    for (int i = 2; i < count; i++)
+                        comment += " " + values[i];
+
+                    lua_getfield(L, result, "comments");
+                    lua_pushstring(L, comment.c_str());
+                    lua_rawseti(L, -2, ++comments);
+                    lua_pop(L, 1);
+                }
+            }
+            else if (count == 2 && !hasSize)
+            {
+                hasSize = true;
+                lua_createtable(L, 2, 0);
+                pushNumber(L, values[0]);
+                lua_rawseti(L, -2, 1);
+                pushNumber(L, values[1]);
+                lua_rawseti(L, -2, 2);
+                lua_setfield(L, result, "size");
+            }
+            else if (count == 1 && !hasMaximum)
+            {
+                hasMaximum = true;
+                pushNumber(L, values[0]);
+                lua_setfield(L, result, "maximumValue");
+            }
+            else
+            {
+                // values that are not numbers become nil, therefore n stores the size of the line
+                lua_createtable(L, count, 1);
+                for (int i = 0; i < count; i++)
+                {
+                    pushNumber(L, values[i]);
+                    lua_rawseti(L, -2, i + 1);
+                }
+
+                lua_pushnumber(L, count);
+                lua_setfield(L, -2, "n");
+                lua_rawseti(L, lines, ++rows);
+            }
+        }
+    }
+
+    lua_setfield(L, result, "lines");
+    lua_settop(L, result);
+
+    if (!error.empty())
+        raiseError(L, error);
+
+    return 1;
+}
@@ -0,0 +1,102 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*!
+  \file csvReader.h
+  \brief This file contains definitions about the native reader of CSV and PGM files:
+                 CsvReader class.
+*/
+
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+extern "C"
+{
+#include <lua.h>
+}
+
+#include <QFile>
+
+#include <string>
+#include <vector>
+using namespace std;
+
+/**
+ * \brief
+ *  Reads the lines of a text file mapped in memory. The values of each line are split
+ *  following the same rules of File:read() in Lua: values can be quoted, two quotes
+ *  within a quoted value are read as one, and the values are trimmed.
+ *
+ */
+class CsvReader
+{
+public:
+    /// Constructor
+    /// \param filename is the path to the file
+    /// \param separator is the character that separates the values of a line
+    CsvReader(const string& filename, char separator);
+
+    /// Destructor. Unmaps and closes the file.
+    ~CsvReader();
+
+    /// Opens and maps the file in memory
+    /// \return false if the file cannot be read
+    bool open();
+
+    /// Reads the next line, without the line break
+    /// \param begin receives a pointer to the first character of the line
+    /// \param size receives the number of characters of the line
+    /// \return false if there is no other line
+    bool nextLine(const char *&begin, int &size);
+
+    /// Splits a line into its values
+    /// \param begin is a pointer to the first character of the line
+    /// \param size is the number of characters of the line
+    /// \param values receives the values. Its strings are reused between calls
+    /// \param count receives the number of values in the line
+    /// \return false if the line has an invalid quoted value
+    bool split(const char *begin, int size, vector<string>& values, int &count) const;
+
+    /// Gets the percentage of the file already read
+    int getProgress() const;
+
+private:
+    QFile file;
+    const char *data;
+    qint64 size;
+    qint64 position;
+    char separator;
+};
+
+/// Reads a CSV file whose first line has the names of the attributes
+/// parameters: file name, separator, [vector of names of the attributes to be read],
+/// [function called with the percentage of the file read], [true to add a sequential id to each row]
+/// return: a vector of tables, one for each line, with the values converted to numbers when possible
+int luaReadCsv(lua_State *L);
+
+/// Reads a PGM file with type, comments, size and maximum value in the first lines
+/// parameters: file name, separator
+/// return: a table with type, comments, size, maximumValue and the vector of lines with their values
+int luaReadPgm(lua_State *L);
+
+#endif
@@ -0,0 +1,138 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*!
+  \file eventQueue.h
+  \brief This file contains definitions about the priority queue used by the schedulers:
+                 EventQueue class.
+*/
+
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+/**
+ * \brief
+ *  Binary heap of scheduled elements. The element on the top is the one with the smallest
+ *  time. Elements with the same time are ordered by their priority (smaller values first)
+ *  and then by their insertion order. Time and priority are copied when the element is
+ *  added, therefore changing them afterwards does not break the heap.
+ *
+ */
+template <class T>
+class EventQueue
+{
+public:
+    /// Constructor
+    EventQueue() : counter(0) {}
+
+    /// Adds an element to the queue. It takes O(log n).
+    /// \param time is the time instant of the element
+    /// \param priority is the priority of the element
+    /// \param value is the element
+    void push(double time, double priority, const T& value)
+    {
+        Entry entry;
+        entry.time = time;
+        entry.priority = priority;
+        entry.order = counter++;
+        entry.value = value;
+
+        heap.push_back(entry);
+        push_heap(heap.begin(), heap.end(), Later());
+    }
+
+    /// Gets the element on the top of the queue. The queue must not be empty.
+    const T& top() const { return heap.front().value; }
+
+    /// Removes the element on the top of the queue. It takes O(log n).
+    void pop()
+    {
+        pop_heap(heap.begin(), heap.end(), Later());
+        heap.pop_back();
+    }
+
+    /// Return true if the queue is empty
+    bool empty() const { return heap.empty(); }
+
+    /// Gets the number of elements
+    int size() const { return (int) heap.size(); }
+
+    /// Removes all the elements
+    void clear()
+    {
+        heap.clear();
+        counter = 0;
+    }
+
+    /// Gets the elements in the order they will be removed from the queue
+    /// \param values receives the elements
+    void sorted(vector<T>& values) const
+    {
+        vector<Entry> copy(heap);
+        sort(copy.begin(), copy.end(), Before());
+
+        values.clear();
+        for (size_t i = 0; i < copy.size(); i++)
+            values.push_back(copy[i].value);
+    }
+
+private:
+    struct Entry
+    {
+        double time;
+        double priority;
+        unsigned long long order;
+        T value;
+    };
+
+    /// Returns true if the first entry must be removed before the second one
+    struct Before
+    {
+        bool operator()(const Entry& e1, const Entry& e2) const
+        {
+            if (e1.time != e2.time)
+                return e1.time < e2.time;
+            if (e1.priority != e2.priority)
+                return e1.priority < e2.priority;
+            return e1.order < e2.order;
+        }
+    };
+
+    /// Inverse of Before, so that the standard max-heap keeps the earliest entry on the top
+    struct Later
+    {
+        bool operator()(const Entry& e1, const Entry& e2) const
+        {
+            return Before()(e2, e1);
+        }
+    };
+
+    vector<Entry> heap;
+    unsigned long long counter; ///< insertion order of the next element
+};
+
+#endif // EVENT_QUEUE_H
@@ -57,6 +57,9 @@ luaCell::luaCell(lua_State *L)
     observedAttribs.clear();
 
     attrNeighName = "";
+
+    store = 0;
+    storeSlot = -1;
 }
 
 /// Returns the current internal state of the LocalAgent (Automaton) within the cell and received as parameter
@@ -219,9 +222,47 @@ int luaCell::addNeighborhood(lua_State *L)
     return 0;
 }
 
-/// Synchronizes the luaCell
+/// Synchronizes the native attributes of the luaCell. The past of these
+/// attributes is kept by the luaCellularSpace, therefore the cell does not
+/// need to copy itself.
 int luaCell::synchronize(lua_State *L) {
-    Cell::synchronize(sizeof(luaCell)); // parametro nao testado
+    if (store)
+        store->synchronizeCell(storeSlot);
+    return 0;
+}
+
+/// Attaches the cell to the native attributes of a luaCellularSpace
+/// parameters: luaCellularSpace, position of the cell in the attribute arrays
+int luaCell::setStore(lua_State *L)
+{
+    store = Luna<luaCellularSpace>::check(L, 1);
+    storeSlot = (int) luaL_checkinteger(L, 2);
+    store->attachAttributes(storeSlot);
+    return 0;
+}
+
+/// Gets the value of a native attribute
+/// parameters: attribute index, boolean indicating whether the past value is read
+int luaCell::getAttribute(lua_State *L)
+{
+    if (!store)
+        return 0;
+
+    int attribute = (int) luaL_checkinteger(L, 1);
+    store->pushAttribute(L, attribute, storeSlot, lua_toboolean(L, 2));
+    return 1;
+}
+
+/// Sets the value of a native attribute
+/// parameters: attribute index, value, boolean indicating whether the past value is written
+int luaCell::setAttribute(lua_State *L)
+{
+    if (!store)
+        return 0;
+
+    int attribute = (int) luaL_checkinteger(L, 1);
+    double value = luaL_checknumber(L, 2);
+    store->setAttribute(attribute, storeSlot, value, lua_toboolean(L, 3));
     return 0;
 }
 
@@ -589,11 +630,19 @@ int luaCell::createObserver(lua_State *)
 
         if (obsLog)
         {
+            changes.attach(obsId);
             obsLog->setAttributes(obsAttribs);
             obsLog->setFileName(cols.at(0));
             obsLog->setSeparator(cols.at(1));
 			obsLog->setWriteMode(cols.at(2));
 
+            if (cols.size() > 5)
+            {
+                obsLog->setBufferSize(cols.at(3).toInt());
+                obsLog->setFlushInterval(cols.at(4).toDouble());
+                obsLog->setFormat(cols.at(5), cols.size() > 6 && cols.at(6) == "true");
+            }
+
             lua_pushnumber(luaL, obsId);
             lua_pushlightuserdata(luaL, (void*) obsLog);
             return 2;
@@ -601,6 +650,7 @@ int luaCell::createObserver(lua_State *)
 
         if (obsText)
         {
+            changes.attach(obsId);
             obsText->setAttributes(obsAttribs);
             lua_pushnumber(luaL, obsId);
             lua_pushlightuserdata(luaL, (void*) obsText);
@@ -610,6 +660,7 @@ int luaCell::createObserver(lua_State *)
 
         if (obsTable)
         {
+            changes.attach(obsId);
             obsTable->setColumnHeaders(cols);
             obsTable->setAttributes(obsAttribs);
 
@@ -663,6 +714,23 @@ int luaCell::createObserver(lua_State *)
 
             return 2;
         }
+
+        if (obsTCPSender)
+        {
+            obsTCPSender->setAttributes(obsAttribs);
+            obsTCPSender->setPort(cols.at(0).toInt());
+
+            for (int i = 1; i < cols.size(); i++)
+            {
+                if (!cols.at(i).isEmpty())
+                    obsTCPSender->addHost(cols.at(i));
+            }
+
+            lua_pushnumber(luaL, obsId);
+            lua_pushlightuserdata(luaL, (void*) obsTCPSender);
+
+            return 2;
+        }
     }
     //@RAIAN
     // Comeca a criacao do Observer do tipo Neighborhood
@@ -860,6 +928,9 @@ QString luaCell::pop(lua_State *luaL, QStringList& attribs)
                 elements.append(cellMsg);
 
                 CellNeighborhood *neigh = itAux->second;
+
+                // the serialization iterates on the composite of the neighborhood
+                ((luaNeighborhood*) neigh)->detach();
                 CellNeighborhood::iterator itNeigh = neigh->begin();
                 int neighSize = neigh->size();
 
@@ -995,6 +1066,10 @@ QString luaCell::pop(lua_State *luaL, QStringList& attribs)
             lua_pop(luaL, 1);
         }
 
+        // attributes stored natively by the cellular space
+        if (store)
+            attrCounter += store->popAttributes(storeSlot, attribs, attrs);
+
         //@RAIAN: Para uso na serializacao da Vizinhanca
         if (attribs.contains("@getWeight"))
         {
@@ -1023,9 +1098,51 @@ QString luaCell::pop(lua_State *luaL, QStringList& attribs)
     return msg;
 }
 
+TypesOfData luaCell::frameValue(lua_State *luaL, double& number, QByteArray& text)
+{
+    static const QByteArray notInformed = VALUE_NOT_INFORMED.toUtf8();
+
+    size_t size = 0;
+    const char *value = 0;
+    int type = lua_type(luaL, -1);
+
+    switch (type)
+    {
+    case LUA_TNIL:
+        return TObsUnknownData;
+
+    case LUA_TBOOLEAN:
+        number = lua_toboolean(luaL, -1) ? 1 : 0;
+        return TObsBool;
+
+    case LUA_TNUMBER:
+        number = lua_tonumber(luaL, -1);
+        return TObsNumber;
+
+    case LUA_TSTRING:
+        value = lua_tolstring(luaL, -1, &size);
+        if (size > 0)
+            text = QByteArray(value, (int) size);
+        else
+            text = notInformed;
+        return TObsText;
+
+    default:
+    {
+        char result[100];
+        int length = sprintf(result, "Lua-Address(%s): %p",
+                             (type == LUA_TTABLE ? "TB" : (type == LUA_TUSERDATA ? "UD"
+                              : (type == LUA_TFUNCTION ? "FT" : "O"))),
+                             lua_topointer(luaL, -1));
+        text = QByteArray(result, length);
+        return TObsText;
+    }
+    }
+}
+
 QString luaCell::getChanges(QDataStream& in, int observerId, QStringList& attribs)
 {
-    return getAll(in, observerId, attribs);
+    return changes.filter(getAll(in, observerId, attribs), CellSubjectInterf::getObserversCount());
 }
 
 #ifdef TME_BLACK_BOARD
@@ -1035,33 +1152,15 @@ QDataStream& luaCell::getState(QDataStream& in, Subject *, int observerId, QStri
 #endif
 
 {
-    int obsCurrentState = 0; //serverSession->getState(observerId);
     QString content;
 
-    switch (obsCurrentState)
-    {
-    case 0:
 #ifdef TME_BLACK_BOARD
-        content = getAll(in, observerId, observedAttribs);
+    // the BlackBoard builds one state for all the observers at each notify
+    content = getChanges(in, observerId, observedAttribs);
 #else
-        content = getAll(in, observerId, attribs);
+    content = getAll(in, observerId, attribs);
 #endif
-        // serverSession->setState(observerId, 1);
-        // if (execModes == Quiet)
-        // qWarning(QString("Observer %1 passou ao estado %2").arg(observerId).arg(1).toAscii().constData());
-        break;
 
-    case 1:
-#ifdef TME_BLACK_BOARD
-        content = getChanges(in, observerId, observedAttribs);
-#else
-        content = getChanges(in, observerId, attribs);
-#endif
-        // serverSession->setState(observerId, 0);
-        // if (execModes == Quiet)
-        // qWarning(QString("Observer %1 passou ao estado %2").arg(observerId).arg(0).toAscii().constData());
-        break;
-    }
     // cleans the stack
     // lua_settop(L, 0);
 
@@ -1075,6 +1174,7 @@ int luaCell::kill(lua_State *luaL)
     int id = luaL_checknumber(luaL, 1);
 
     bool result = CellSubjectInterf::kill(id);
+    changes.detach(id);
 
     //@RAIAN: Para "matar" o observer Neighbohrood
     if (!result)
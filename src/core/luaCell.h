@@ -29,14 +29,18 @@ of this software and its documentation.
 #define LUACELL_H
 
 #include "../observer/cellSubjectInterf.h"
+#include "../observer/protocol/decoder/binaryFrame.h"
 #include "luaLocalAgent.h"
 
 #include "reference.h"
+#include "stateChanges.h"
 
 extern "C"
 {
 #include <lua.h>
 }
+
+class luaCellularSpace;
 #include "luna.h"
 
 // Raian: Tive que acrescentar este include para poder utilizar o CellularSpace nas
@@ -70,7 +74,15 @@ class luaCell : public CellSubjectInterf, public Reference<luaCell>
 
     QString attrNeighName;
 
+    luaCellularSpace *store; ///< cellular space that stores the native attributes of the cell
+    int storeSlot; ///< position of the cell in the native attribute arrays
+
+    StateChanges changes; ///< last state sent to the observers
+
     QString getAll(QDataStream& in, int obsId, QStringList& attribs);
+
+    /// Gets the attributes that changed since the last state, if every observer keeps
+    /// the values it received. Otherwise, gets every attribute
     QString getChanges(QDataStream& in, int obsId, QStringList& attribs);
 
 public:
@@ -141,6 +153,24 @@ public:
     /// Synchronizes the luaCell
     int synchronize(lua_State *L);
 
+    /// Attaches the cell to the native attributes of a luaCellularSpace
+    /// parameters: luaCellularSpace, position of the cell in the attribute arrays
+    int setStore(lua_State *L);
+
+    /// Gets the value of a native attribute
+    /// parameters: attribute index, boolean indicating whether the past value is read
+    int getAttribute(lua_State *L);
+
+    /// Sets the value of a native attribute
+    /// parameters: attribute index, value, boolean indicating whether the past value is written
+    int setAttribute(lua_State *L);
+
+    /// Gets the position of the cell in the native attribute arrays or -1 if it is not attached
+    inline int getStoreSlot() const { return store ? storeSlot : -1; }
+
+    /// Gets the luaCellularSpace that stores the native attributes of the cell, if any
+    inline luaCellularSpace* getStore() const { return store; }
+
     // @DANIEL:
     // Movido para a classe Reference
     /// Registers the luaCell object in the Lua stack
@@ -193,6 +223,12 @@ public:
     /// \param attribs the list of attributes observed
     QString pop(lua_State *L, QStringList& attribs);
 
+    /// Reads the value on the top of the Lua stack as it is sent in a binary frame
+    /// \param number receives the value of a number or boolean
+    /// \param text receives the value of a string or the address of the other Lua values
+    /// \return the type of the value, or TObsUnknownData if it is nil
+    static TypesOfData frameValue(lua_State *L, double& number, QByteArray& text);
+
     /// Destroys the observer object instance
     int kill(lua_State *L);
 };
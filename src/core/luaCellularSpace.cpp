@@ -28,13 +28,16 @@ of this software and its documentation.
 \author Rodrigo Reis Pereira
 */
 
+#include "csvReader.h"
 #include "luaCellIndex.h"
 #include "luaCellularSpace.h"
 #include "luaNeighborhood.h"
+#include "parallelForEachCell.h"
 #include "terrameGlobals.h"
 
 // Observadores
 #include "../observer/types/observerUDPSender.h"
+#include "../observer/types/observerTCPSender.h"
 #include "../observer/types/agentObserverMap.h"
 #include "../observer/types/observerTextScreen.h"
 #include "../observer/types/observerGraphic.h"
@@ -46,6 +49,9 @@ of this software and its documentation.
 
 #include <fstream>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
 
 #ifndef WIN32
 #define stricmp strcasecmp
@@ -84,6 +90,9 @@ luaCellularSpace::luaCellularSpace(lua_State *L)
     subjectType = TObsCellularSpace;
     observedAttribs.clear();
     port = -1;
+    frameVersion = 0;
+    frameBase = 0;
+    attributesSize = 0;
 }
 
 int luaCellularSpace::setPort(lua_State *L){
@@ -197,6 +206,719 @@ int luaCellularSpace::size(lua_State* L)
     return 1;
 }
 
+/// Reads the attributes of the cells from a CSV file mapped in memory
+/// parameters: file name, separator, [vector of attribute names], [progress function], [true to add ids]
+int luaCellularSpace::readCsv(lua_State *L)
+{
+    return luaReadCsv(L);
+}
+
+/// Reads the values of the cells from a PGM file mapped in memory
+/// parameters: file name, separator
+int luaCellularSpace::readPgm(lua_State *L)
+{
+    return luaReadPgm(L);
+}
+
+/// Parameters of the built-in neighborhood strategies
+struct NeighborhoodStrategy
+{
+    enum Type { Moore, VonNeumann, Diagonal, MxN } type;
+    bool self, wrap;
+    int m, n; ///< half of the number of columns and lines
+    int xMin, yMin, width, height;
+};
+
+/// Neighbors of a range of cells, computed by one thread
+struct NeighborhoodRows
+{
+    vector<int> sizes;
+    vector<int> neighbors;
+    vector<double> weights;
+};
+
+static inline bool acceptNeighbor(const NeighborhoodStrategy& strategy, int lin, int col)
+{
+    bool center = (lin == 0) && (col == 0);
+
+    switch (strategy.type)
+    {
+    case NeighborhoodStrategy::Moore:
+        return strategy.self || !center;
+    case NeighborhoodStrategy::VonNeumann:
+        return (((lin == 0) || (col == 0)) && !center) || (strategy.self && center);
+    case NeighborhoodStrategy::Diagonal:
+        return ((lin != 0) && (col != 0)) || (strategy.self && center);
+    default:
+        return true;
+    }
+}
+
+static inline int wrapCoord(int value, int min, int size)
+{
+    return ((value - min) % size + size) % size + min;
+}
+
+/// Builds the neighbors of the cells from begin to end - 1, following the same
+/// order, weights and wrap rules of the strategies implemented in CellularSpace.lua
+static void buildNeighborhoodRows(const NeighborhoodStrategy& strategy, const vector<CellIndex>& coords,
+                                  const vector<int>& grid, int begin, int end, NeighborhoodRows& rows)
+{
+    vector<int> found;
+
+    for (int i = begin; i < end; i++)
+    {
+        found.clear();
+
+        for (int lin = -strategy.n; lin <= strategy.n; lin++)
+        {
+            for (int col = -strategy.m; col <= strategy.m; col++)
+            {
+                if (!acceptNeighbor(strategy, lin, col))
+                    continue;
+
+                int x = coords[i].first + col;
+                int y = coords[i].second + lin;
+
+                if (strategy.wrap)
+                {
+                    x = wrapCoord(x, strategy.xMin, strategy.width);
+                    y = wrapCoord(y, strategy.yMin, strategy.height);
+                }
+
+                x -= strategy.xMin;
+                y -= strategy.yMin;
+
+                if ((x < 0) || (y < 0) || (x >= strategy.width) || (y >= strategy.height))
+                    continue;
+
+                int node = grid[y * strategy.width + x];
+                if (node >= 0)
+                    found.push_back(node);
+            }
+        }
+
+        // the weight considers repeated cells, as wrap can reach a cell twice in small spaces
+        double weight = (strategy.type == NeighborhoodStrategy::MxN) ? 1 : 1.0 / found.size();
+
+        // neighbors follow the order of their coordinates, as in the CellNeighborhood composite
+        for (size_t j = 1; j < found.size(); j++)
+        {
+            int node = found[j];
+            size_t k = j;
+            for (; (k > 0) && (coords[node] < coords[found[k - 1]]); k--)
+                found[k] = found[k - 1];
+            found[k] = node;
+        }
+        found.erase(unique(found.begin(), found.end()), found.end());
+
+        rows.sizes.push_back((int) found.size());
+        rows.neighbors.insert(rows.neighbors.end(), found.begin(), found.end());
+        rows.weights.insert(rows.weights.end(), found.size(), weight);
+    }
+}
+
+/// Builds the neighborhoods of a built-in strategy for all the cells
+/// parameters: neighborhood name, strategy, table with the arguments of the strategy
+/// return: false if the cells are too sparse to be indexed by a dense grid
+int luaCellularSpace::createNeighborhood(lua_State *L)
+{
+    string name = luaL_checkstring(L, 1);
+    string type = luaL_checkstring(L, 2);
+    luaL_checktype(L, 3, LUA_TTABLE);
+
+    NeighborhoodStrategy strategy;
+    strategy.m = 1;
+    strategy.n = 1;
+
+    if (type == "moore")
+        strategy.type = NeighborhoodStrategy::Moore;
+    else if (type == "vonneumann")
+        strategy.type = NeighborhoodStrategy::VonNeumann;
+    else if (type == "diagonal")
+        strategy.type = NeighborhoodStrategy::Diagonal;
+    else if (type == "mxn")
+        strategy.type = NeighborhoodStrategy::MxN;
+    else
+    {
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    lua_getfield(L, 3, "self");
+    strategy.self = lua_toboolean(L, -1);
+    lua_getfield(L, 3, "wrap");
+    strategy.wrap = lua_toboolean(L, -1);
+    lua_pop(L, 2);
+
+    if (strategy.type == NeighborhoodStrategy::MxN)
+    {
+        lua_getfield(L, 3, "m");
+        lua_getfield(L, 3, "n");
+        strategy.m = (int) luaL_checknumber(L, -2) / 2;
+        strategy.n = (int) luaL_checknumber(L, -1) / 2;
+        lua_pop(L, 2);
+    }
+
+    lua_getfield(L, 3, "xMin");
+    lua_getfield(L, 3, "xMax");
+    lua_getfield(L, 3, "yMin");
+    lua_getfield(L, 3, "yMax");
+    strategy.xMin = (int) luaL_checknumber(L, -4);
+    strategy.width = (int) luaL_checknumber(L, -3) - strategy.xMin + 1;
+    strategy.yMin = (int) luaL_checknumber(L, -2);
+    strategy.height = (int) luaL_checknumber(L, -1) - strategy.yMin + 1;
+    lua_pop(L, 4);
+
+    vector<luaCell*> cells;
+    getCells(L, cells);
+
+    vector<CellIndex> coords;
+    for (size_t i = 0; i < cells.size(); i++)
+        coords.push_back(cells[i]->getIndex());
+
+    if ((strategy.width <= 0) || (strategy.height <= 0)
+        || ((double) strategy.width * strategy.height > 4.0 * cells.size()))
+    {
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    // as CellularSpace:get(), the last cell with a given coordinate is the one found
+    vector<int> grid(strategy.width * strategy.height, -1);
+    for (size_t i = 0; i < coords.size(); i++)
+    {
+        int x = coords[i].first - strategy.xMin;
+        int y = coords[i].second - strategy.yMin;
+
+        if ((x >= 0) && (y >= 0) && (x < strategy.width) && (y < strategy.height))
+            grid[y * strategy.width + x] = (int) i;
+    }
+
+    int size = (int) cells.size();
+    int threads = (int) std::thread::hardware_concurrency();
+    threads = std::max(1, std::min(threads, size / 10000 + 1));
+
+    vector<NeighborhoodRows> rows(threads);
+    vector<std::thread> workers;
+
+    for (int t = 1; t < threads; t++)
+        workers.push_back(std::thread(buildNeighborhoodRows, std::cref(strategy), std::cref(coords),
+                                      std::cref(grid), (int) ((long) size * t / threads),
+                                      (int) ((long) size * (t + 1) / threads), std::ref(rows[t])));
+
+    buildNeighborhoodRows(strategy, coords, grid, 0, size / threads, rows[0]);
+
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+
+    QSharedPointer<NeighborhoodGraph> graph(new NeighborhoodGraph());
+
+    for (int i = 0; i < size; i++)
+        graph->addNode(coords[i], cells[i]);
+
+    for (int t = 0; t < threads; t++)
+        graph->addRows(rows[t].sizes, rows[t].neighbors, rows[t].weights);
+
+    for (int i = 0; i < size; i++)
+    {
+        NeighCmpstInterf& neighborhoods = cells[i]->getNeighborhoods();
+        NeighCmpstInterf::iterator it = neighborhoods.find(name);
+
+        if (it != neighborhoods.end())
+            ((luaNeighborhood*) it->second)->setGraph(graph, i);
+    }
+
+    lua_pushboolean(L, true);
+    return 1;
+}
+
+/// Applies a function to all the cells using several threads
+/// parameters: function, number of threads (optional)
+/// return: false if the function returned false for some cell
+int luaCellularSpace::forEachCellParallel(lua_State *L)
+{
+    luaL_checktype(L, 1, LUA_TFUNCTION);
+    int threads = (int) luaL_optnumber(L, 2, std::thread::hardware_concurrency());
+    lua_settop(L, 1);
+
+    vector<luaCell*> cells;
+    getCells(L, cells);
+
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        if (cells[i]->getStore() != this)
+        {
+            lua_getglobal(L, "customError");
+            lua_pushstring(L, "The Cells should store their attributes natively to be used in a parallel forEachCell.");
+            lua_call(L, 1, 0);
+            return 0;
+        }
+    }
+
+    vector<string> names(attributesIndex.size());
+    for (QHash<QString, int>::const_iterator it = attributesIndex.constBegin(); it != attributesIndex.constEnd(); ++it)
+        names[it.value()] = it.key().toStdString();
+
+    ParallelForEachCell runner(this, cells);
+    bool result = runner.execute(L, names, threads);
+
+    if (!runner.getError().empty())
+    {
+        lua_getglobal(L, "customError");
+        lua_pushstring(L, runner.getError().c_str());
+        lua_call(L, 1, 0);
+        return 0;
+    }
+
+    lua_pushboolean(L, result);
+    return 1;
+}
+
+void luaCellularSpace::getCells(lua_State *L, vector<luaCell*>& cells)
+{
+    int top = lua_gettop(L);
+
+    Reference<luaCellularSpace>::getReference(L);
+    lua_pushstring(L, "cells");
+    lua_rawget(L, -2);
+
+    if (lua_istable(L, -1))
+    {
+        int cellsPos = lua_gettop(L);
+        int count = (int) lua_rawlen(L, cellsPos);
+
+        for (int i = 1; i <= count; i++)
+        {
+            lua_rawgeti(L, cellsPos, i);
+            lua_pushstring(L, "cObj_");
+            lua_rawget(L, -2);
+
+            cells.push_back(Luna<luaCell>::check(L, -1));
+            lua_pop(L, 2);
+        }
+    }
+    lua_settop(L, top);
+}
+
+/// Moves the neighborhoods with a given name of all the cells to a single graph
+/// parameters: neighborhood name
+int luaCellularSpace::compactNeighborhood(lua_State *L)
+{
+    string name = luaL_checkstring(L, 1);
+    QSharedPointer<NeighborhoodGraph> graph(new NeighborhoodGraph());
+
+    vector<luaCell*> cells;
+    getCells(L, cells);
+
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        NeighCmpstInterf& neighborhoods = cells[i]->getNeighborhoods();
+        NeighCmpstInterf::iterator it = neighborhoods.find(name);
+
+        if (it == neighborhoods.end())
+            continue;
+
+        luaNeighborhood *neigh = (luaNeighborhood*) it->second;
+        neigh->detach();
+        neigh->setGraph(graph, graph->addRow(*neigh));
+    }
+
+    return 0;
+}
+
+/// Declares an attribute stored natively
+/// parameters: attribute name
+/// return: the index of the attribute
+int luaCellularSpace::addAttribute(lua_State *L)
+{
+    QString name(luaL_checkstring(L, 1));
+    int attribute = attributesIndex.value(name, -1);
+
+    if (attribute < 0)
+    {
+        attribute = (int) presentAttributes.size();
+        attributesIndex.insert(name, attribute);
+        presentAttributes.push_back(std::vector<double>(attributesSize, 0));
+        pastAttributes.push_back(std::vector<double>(attributesSize, 0));
+    }
+
+    lua_pushnumber(L, attribute);
+    return 1;
+}
+
+/// Copies the present values of native attributes to their past values
+/// parameters: indexes of the attributes. If empty, every attribute is copied
+int luaCellularSpace::synchronizeAttributes(lua_State *L)
+{
+    int top = lua_gettop(L);
+
+    // the arrays have the same size, therefore the copy does not allocate memory
+    if (top == 0)
+    {
+        for (size_t i = 0; i < presentAttributes.size(); i++)
+            pastAttributes[i] = presentAttributes[i];
+        return 0;
+    }
+
+    for (int i = 1; i <= top; i++)
+    {
+        int attribute = (int) luaL_checkinteger(L, i);
+        if ((attribute >= 0) && (attribute < (int) presentAttributes.size()))
+            pastAttributes[attribute] = presentAttributes[attribute];
+    }
+    return 0;
+}
+
+/// Copies the native attributes to be stored in a checkpoint
+/// return: a table indexed by the names of the attributes, with strings of raw values
+int luaCellularSpace::saveAttributes(lua_State *L)
+{
+    size_t bytes = attributesSize * sizeof(double);
+    QByteArray values((int) (2 * bytes), 0);
+
+    lua_createtable(L, 0, attributesIndex.size());
+
+    QHash<QString, int>::const_iterator it = attributesIndex.constBegin();
+    for (; it != attributesIndex.constEnd(); ++it)
+    {
+        if (bytes > 0)
+        {
+            memcpy(values.data(), presentAttributes[it.value()].data(), bytes);
+            memcpy(values.data() + bytes, pastAttributes[it.value()].data(), bytes);
+        }
+
+        lua_pushstring(L, it.key().toLocal8Bit().constData());
+        lua_pushlstring(L, values.constData(), values.size());
+        lua_rawset(L, -3);
+    }
+    return 1;
+}
+
+/// Restores the native attributes copied by saveAttributes()
+/// parameters: a table indexed by the names of the attributes, with strings of raw values
+int luaCellularSpace::restoreAttributes(lua_State *L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    size_t bytes = attributesSize * sizeof(double);
+    string msg;
+
+    // the values are checked before being copied, so that an error does not leave
+    // some attributes restored
+    lua_pushnil(L);
+    while (msg.empty() && lua_next(L, 1))
+    {
+        size_t length = 0;
+        const char *name = lua_type(L, -2) == LUA_TSTRING ? lua_tostring(L, -2) : "?";
+
+        if (attributesIndex.value(QString(name), -1) < 0)
+            msg = string("Attribute '") + name + "' is not stored natively.";
+        else if (lua_type(L, -1) != LUA_TSTRING || (lua_tolstring(L, -1, &length), length != 2 * bytes))
+            msg = string("Native attribute '") + name + "' should have " + to_string(attributesSize)
+                + " values to be restored.";
+
+        lua_pop(L, 1);
+    }
+
+    if (!msg.empty())
+    {
+        lua_settop(L, 0);
+        lua_getglobal(L, "customError");
+        lua_pushstring(L, msg.c_str());
+        lua_call(L, 1, 0);
+        return 0;
+    }
+
+    lua_pushnil(L);
+    while (lua_next(L, 1))
+    {
+        int attribute = attributesIndex.value(QString(lua_tostring(L, -2)));
+        const char *values = lua_tostring(L, -1);
+
+        if (bytes > 0)
+        {
+            memcpy(presentAttributes[attribute].data(), values, bytes);
+            memcpy(pastAttributes[attribute].data(), values + bytes, bytes);
+        }
+
+        lua_pop(L, 1);
+    }
+
+    // every cell is sent in the next frame
+    std::fill(slotVersions.begin(), slotVersions.end(), frameVersion + 1);
+    return 0;
+}
+
+/// Partial summary of a numeric attribute, computed by one thread
+struct AttributeSummary
+{
+    double sum;
+    double min;
+    double max;
+    int fractions; ///< number of values with a fractional part (or NaN)
+};
+
+/// Summarizes the values from begin to end - 1. The loop does not have branches
+/// other than the comparisons, so that the compiler can vectorize it.
+static void summarizeValues(const double *values, int begin, int end, AttributeSummary& summary)
+{
+    double sum = 0;
+    double min = HUGE_VAL;
+    double max = -HUGE_VAL;
+    int fractions = 0;
+
+    for (int i = begin; i < end; i++)
+    {
+        double value = values[i];
+        sum += value;
+        min = value < min ? value : min;
+        max = value > max ? value : max;
+        fractions += (value - std::trunc(value)) != 0 ? 1 : 0;
+    }
+
+    summary.sum = sum;
+    summary.min = min;
+    summary.max = max;
+    summary.fractions = fractions;
+}
+
+/// Summarizes an attribute of all the cells
+/// parameters: attribute name, operation, number of threads (optional)
+/// return: the result of the operation
+int luaCellularSpace::reduce(lua_State *L)
+{
+    const char *attribute = luaL_checkstring(L, 1);
+    string operation = luaL_checkstring(L, 2);
+    int threads = (int) luaL_optnumber(L, 3, 0);
+    bool numeric = (operation == "sum") || (operation == "mean") || (operation == "minimum") || (operation == "maximum");
+
+    if (!numeric && (operation != "count") && (operation != "histogram"))
+    {
+        string msg = "Invalid reduction '" + operation + "'.";
+        lua_getglobal(L, "customError");
+        lua_pushstring(L, msg.c_str());
+        lua_call(L, 1, 0);
+        return 0;
+    }
+
+    lua_settop(L, 1);
+
+    AttributeSummary total;
+    total.sum = 0;
+    total.min = HUGE_VAL;
+    total.max = -HUGE_VAL;
+    total.fractions = 0;
+    int size = 0;
+    int native = attributesIndex.value(QString(attribute), -1);
+
+    if (numeric && (native >= 0))
+    {
+        const double *values = presentAttributes[native].data();
+        size = attributesSize;
+
+        if (threads <= 0)
+        {
+            threads = (int) std::thread::hardware_concurrency();
+            threads = std::max(1, std::min(threads, size / 1000000 + 1));
+        }
+        threads = std::max(1, std::min(threads, size));
+
+        vector<AttributeSummary> summaries(threads);
+        vector<std::thread> workers;
+
+        for (int t = 1; t < threads; t++)
+            workers.push_back(std::thread(summarizeValues, values, (int) ((long) size * t / threads),
+                                          (int) ((long) size * (t + 1) / threads), std::ref(summaries[t])));
+
+        summarizeValues(values, 0, size / threads, summaries[0]);
+
+        for (size_t t = 0; t < workers.size(); t++)
+            workers[t].join();
+
+        // partial results are combined in the order of the cells
+        for (int t = 0; t < (int) summaries.size(); t++)
+        {
+            total.sum += summaries[t].sum;
+            total.min = std::min(total.min, summaries[t].min);
+            total.max = std::max(total.max, summaries[t].max);
+            total.fractions += summaries[t].fractions;
+        }
+
+#if LUA_VERSION_NUM >= 503
+        // integral values are summed exactly while every partial sum is below 2^53, so the
+        // native attributes return integers as the attributes of the cells in Lua
+        double bound = std::max(std::fabs(total.min), std::fabs(total.max));
+        bool exact = (total.fractions == 0) && ((size == 0) || (bound * size <= 9007199254740992.0));
+
+        if (exact && (operation == "sum"))
+        {
+            lua_pushinteger(L, (lua_Integer) total.sum);
+            return 1;
+        }
+
+        if (exact && (size > 0) && (operation != "mean"))
+        {
+            lua_pushinteger(L, (lua_Integer) (operation == "minimum" ? total.min : total.max));
+            return 1;
+        }
+#endif
+    }
+    else
+    {
+        int count = 0;
+
+        // sums of Lua integers remain integers, as in the summary functions written in Lua
+        bool integers = true;
+        lua_Integer integerSum = 0;
+
+        if (operation == "histogram")
+            lua_newtable(L);
+
+        int resultPos = lua_gettop(L);
+
+        Reference<luaCellularSpace>::getReference(L);
+        lua_pushstring(L, "cells");
+        lua_rawget(L, -2);
+
+        if (lua_istable(L, -1))
+        {
+            int cellsPos = lua_gettop(L);
+            size = (int) lua_rawlen(L, cellsPos);
+
+            for (int i = 1; i <= size; i++)
+            {
+                lua_rawgeti(L, cellsPos, i);
+                lua_getfield(L, -1, attribute);
+
+                if (numeric)
+                {
+                    if (lua_type(L, -1) != LUA_TNUMBER)
+                    {
+                        lua_getglobal(L, "incompatibleTypeError");
+                        lua_pushstring(L, attribute);
+                        lua_pushstring(L, "number");
+                        lua_pushvalue(L, -4);
+                        lua_call(L, 3, 0);
+                        return 0;
+                    }
+
+#if LUA_VERSION_NUM >= 503
+                    if (integers && lua_isinteger(L, -1))
+                        integerSum += lua_tointeger(L, -1);
+                    else
+                        integers = false;
+#else
+                    integers = false;
+#endif
+
+                    double value = lua_tonumber(L, -1);
+                    total.sum += value;
+                    total.min = std::min(total.min, value);
+                    total.max = std::max(total.max, value);
+                }
+                else if (operation == "count")
+                {
+                    if (lua_toboolean(L, -1))
+                        count++;
+                }
+                else
+                {
+                    lua_pushvalue(L, -1);
+                    lua_rawget(L, resultPos);
+                    lua_Integer quantity = lua_tointeger(L, -1);
+                    lua_pop(L, 1);
+
+                    lua_pushinteger(L, quantity + 1);
+                    lua_rawset(L, resultPos);
+                    lua_pop(L, 1);
+                    continue;
+                }
+
+                lua_pop(L, 2);
+            }
+        }
+
+        lua_settop(L, resultPos);
+
+        if (operation == "histogram")
+            return 1;
+
+        if (operation == "count")
+        {
+            lua_pushinteger(L, count);
+            return 1;
+        }
+
+        if (integers && (operation != "mean"))
+        {
+            if (operation == "sum")
+                lua_pushinteger(L, integerSum);
+            else if (size == 0)
+                lua_pushnil(L);
+            else
+                lua_pushinteger(L, (lua_Integer) (operation == "minimum" ? total.min : total.max));
+            return 1;
+        }
+    }
+
+    if (operation == "sum")
+        lua_pushnumber(L, total.sum);
+    else if (size == 0)
+        lua_pushnil(L);
+    else if (operation == "mean")
+        lua_pushnumber(L, total.sum / size);
+    else if (operation == "minimum")
+        lua_pushnumber(L, total.min);
+    else
+        lua_pushnumber(L, total.max);
+
+    return 1;
+}
+
+void luaCellularSpace::synchronizeCell(int slot)
+{
+    for (size_t i = 0; i < presentAttributes.size(); i++)
+        pastAttributes[i][slot] = presentAttributes[i][slot];
+}
+
+void luaCellularSpace::attachAttributes(int slot)
+{
+    if (slot < attributesSize)
+        return;
+
+    attributesSize = slot + 1;
+    slotVersions.resize(attributesSize, 0);
+    for (size_t i = 0; i < presentAttributes.size(); i++)
+    {
+        presentAttributes[i].resize(attributesSize, 0);
+        pastAttributes[i].resize(attributesSize, 0);
+    }
+}
+
+int luaCellularSpace::popAttributes(int slot, const QStringList& attribs, QString& attrs)
+{
+    int counter = 0;
+    QString text;
+
+    QHash<QString, int>::const_iterator it = attributesIndex.constBegin();
+    for (; it != attributesIndex.constEnd(); ++it)
+    {
+        if (!attribs.contains(it.key()))
+            continue;
+
+        doubleToQString(presentAttributes[it.value()][slot], text, 20);
+        attrs.append(it.key());
+        attrs.append(PROTOCOL_SEPARATOR);
+        attrs.append(QString::number(TObsNumber));
+        attrs.append(PROTOCOL_SEPARATOR);
+        attrs.append(text);
+        attrs.append(PROTOCOL_SEPARATOR);
+        counter++;
+    }
+    return counter;
+}
+
 /// Sets the name of the TerraLib layer related to the CellularSpace object
 /// parameter: layerName is a string containing the new layerName
 /// \author Raian Vargas Maretto
@@ -497,6 +1219,7 @@ int luaCellularSpace::createObserver(lua_State * luaL)
 
     AgentObserverMap *obsMap = 0;
     ObserverUDPSender *obsUDPSender = 0;
+    ObserverTCPSender *obsTCPSender = 0;
     ObserverTextScreen *obsText = 0;
     ObserverTable *obsTable = 0;
     ObserverGraphic *obsGraphic = 0;
@@ -606,6 +1329,23 @@ int luaCellularSpace::createObserver(lua_State * luaL)
                 qWarning("%s", qPrintable(TerraMEObserver::MEMORY_ALLOC_FAILED));
         }
         break;
+
+    case TObsTCPSender:
+        obsTCPSender =(ObserverTCPSender *) CellSpaceSubjectInterf::createObserver(TObsTCPSender);
+        if (obsTCPSender)
+        {
+            obsId = obsTCPSender->getId();
+            obsTCPSender->setCompress(compressDatagram);
+
+            if (obsVisible)
+                obsTCPSender->show();
+        }
+        else
+        {
+            if (execModes != Quiet)
+                qWarning("%s", qPrintable(TerraMEObserver::MEMORY_ALLOC_FAILED));
+        }
+        break;
     default:
         if (execModes != Quiet)
         {
@@ -622,6 +1362,13 @@ int luaCellularSpace::createObserver(lua_State * luaL)
         obsLog->setSeparator(obsParamsAtribs.at(1));
         obsLog->setWriteMode(obsParamsAtribs.at(2));
 
+        if (obsParamsAtribs.size() > 5)
+        {
+            obsLog->setBufferSize(obsParamsAtribs.at(3).toInt());
+            obsLog->setFlushInterval(obsParamsAtribs.at(4).toDouble());
+            obsLog->setFormat(obsParamsAtribs.at(5), obsParamsAtribs.size() > 6 && obsParamsAtribs.at(6) == "true");
+        }
+
         lua_pushnumber(luaL, obsId);
         lua_pushlightuserdata(luaL, (void*) obsLog);
 
@@ -710,6 +1457,23 @@ int luaCellularSpace::createObserver(lua_State * luaL)
         return 2;
     }
 
+    if (obsTCPSender)
+    {
+        obsTCPSender->setAttributes(obsAttribs);
+        obsTCPSender->setPort(obsParamsAtribs.at(0).toInt());
+
+        for (int i = 1; i < obsParamsAtribs.size(); i++)
+        {
+            if (!obsParamsAtribs.at(i).isEmpty())
+                obsTCPSender->addHost(obsParamsAtribs.at(i));
+        }
+
+        lua_pushnumber(luaL, obsId);
+        lua_pushlightuserdata(luaL, (void*) obsTCPSender);
+
+        return 2;
+    }
+
     return 0;
 }
 
@@ -741,11 +1505,6 @@ QString luaCellularSpace::getAll(QDataStream& /*in*/, int /*observerId*/ , QStri
     return pop(luaL, attribs);
 }
 
-QString luaCellularSpace::getChanges(QDataStream& in, int observerId , QStringList &attribs)
-{
-    return getAll(in, observerId, attribs);
-}
-
 //------------
 /// Serializes the luaCellularSpace object to the Observer objects
 #ifdef TME_BLACK_BOARD
@@ -754,35 +1513,28 @@ QDataStream& luaCellularSpace::getState(QDataStream& in, Subject *, int observer
 QDataStream& luaCellularSpace::getState(QDataStream& in, Subject *, int observerId, QStringList &  attribs)
 #endif
 {
-    int obsCurrentState = 0; //serverSession->getState(observerId);
-    QString content;
-
-    switch (obsCurrentState)
+    // map observers decode the cells directly from the binary frame
+    if (useBinaryFrame())
     {
-    case 0:
 #ifdef TME_BLACK_BOARD
-        content = getAll(in, observerId, observedAttribs);
+        in << getFrame(luaL, observedAttribs);
 #else
-        content = getAll(in, observerId, attribs);
+        in << popFrame(luaL, attribs);
 #endif
+        return in;
+    }
 
-        // serverSession->setState(observerId, 1);
-        //if (execModes == Quiet)
-        // 	qWarning(QString("Observer %1 passou ao estado %2").arg(observerId).arg(1).toLatin1().constData());
-        break;
+    // the observers receive complete states, so the next frame can not be a delta
+    frameBase = 0;
+
+    QString content;
 
-    case 1:
 #ifdef TME_BLACK_BOARD
-        content = getChanges(in, observerId, observedAttribs);
+    content = getAll(in, observerId, observedAttribs);
 #else
-        content = getChanges(in, observerId, attribs);
+    content = getAll(in, observerId, attribs);
 #endif
 
-        // serverSession->setState(observerId, 0);
-        //if (execModes != Quiet)
-        // 	qWarning(QString("Observer %1 passou ao estado %2").arg(observerId).arg(0).toLatin1().constData());
-        break;
-    }
     // cleans the stack
     // lua_settop(L, 0);
 
@@ -941,11 +1693,334 @@ QString luaCellularSpace::pop(lua_State *luaL, QStringList& attribs)
     return msg;
 }
 
+QByteArray luaCellularSpace::popFrame(lua_State *luaL, QStringList& attribs, quint32 sequence)
+{
+    readFrame(luaL, attribs);
+    return writeFrame(sequence, 0);
+}
+
+void luaCellularSpace::readFrame(lua_State *luaL, const QStringList& attribs)
+{
+    frameAttribs = attribs;
+    frameColumns.clear();
+
+    for (int i = 0; i < attribs.size(); i++)
+    {
+        if (attribs.at(i).startsWith("@"))
+            continue;
+
+        FrameColumn col;
+        col.name = attribs.at(i);
+        col.key = attribs.at(i).toUtf8();
+        col.native = attributesIndex.value(attribs.at(i), -1);
+        col.type = (col.native >= 0) ? TObsNumber : TObsUnknownData;
+        frameColumns.append(col);
+    }
+
+    int top = lua_gettop(luaL);
+    int count = 0;
+
+    Reference<luaCellularSpace>::getReference(luaL);
+    lua_pushstring(luaL, "cells");
+    lua_rawget(luaL, -2);
+
+    int cellsPos = lua_gettop(luaL);
+    if (lua_istable(luaL, cellsPos))
+        count = (int) lua_rawlen(luaL, cellsPos);
+
+    frameCells.resize(count);
+    frameSlots.resize(count);
+    rowVersions.fill(0, count);
+
+    for (int c = 0; c < frameColumns.size(); c++)
+    {
+        FrameColumn &col = frameColumns[c];
+        if (col.native >= 0)
+            continue;
+
+        col.numbers.fill(0, count);
+        col.texts.fill(QByteArray(), count);
+        col.valid.fill(0, count);
+    }
+
+    double number = 0;
+    QByteArray text;
+
+    for (int row = 0; row < count; row++)
+    {
+        lua_rawgeti(luaL, cellsPos, row + 1);
+        int cellPos = lua_gettop(luaL);
+
+        lua_pushstring(luaL, "cObj_");
+        lua_rawget(luaL, cellPos);
+        luaCell *cell = Luna<luaCell>::check(luaL, -1);
+        lua_pop(luaL, 1);
+
+        frameCells[row] = lua_topointer(luaL, cellPos);
+        frameSlots[row] = (cell->getStore() == this) ? cell->getStoreSlot() : -1;
+
+        for (int c = 0; c < frameColumns.size(); c++)
+        {
+            FrameColumn &col = frameColumns[c];
+            if (col.native >= 0)
+                continue;
+
+            lua_pushlstring(luaL, col.key.constData(), col.key.size());
+            lua_rawget(luaL, cellPos);
+            TypesOfData type = luaCell::frameValue(luaL, number, text);
+            lua_pop(luaL, 1);
+
+            if (type == TObsUnknownData)
+                continue;
+
+            if (col.type == TObsUnknownData)
+                col.type = type;
+
+            // the cells whose value has a type different from the first one are sent without value
+            if (type != col.type)
+            {
+                warnMixedAttribute(luaL, col.name);
+                continue;
+            }
+
+            col.valid[row] = 1;
+            if (type == TObsText)
+                col.texts[row] = text;
+            else
+                col.numbers[row] = number;
+        }
+        lua_pop(luaL, 1);
+    }
+    lua_settop(luaL, top);
+}
+
+bool luaCellularSpace::updateFrame(lua_State *luaL, quint32 sequence)
+{
+    QVector<int> columns;
+
+    for (int c = 0; c < frameColumns.size(); c++)
+    {
+        const FrameColumn &col = frameColumns.at(c);
+
+        if (attributesIndex.value(col.name, -1) != col.native)
+            return false;
+
+        // the coordinates of the cells are not expected to change
+        if ((col.native < 0) && (col.name != "x") && (col.name != "y"))
+            columns.append(c);
+    }
+
+    int top = lua_gettop(luaL);
+    int count = 0;
+
+    Reference<luaCellularSpace>::getReference(luaL);
+    lua_pushstring(luaL, "cells");
+    lua_rawget(luaL, -2);
+
+    int cellsPos = lua_gettop(luaL);
+    if (lua_istable(luaL, cellsPos))
+        count = (int) lua_rawlen(luaL, cellsPos);
+
+    // the cells are not visited when every attribute that can change is native
+    bool result = (count == frameCells.size());
+    double number = 0;
+    QByteArray text;
+
+    for (int row = 0; result && !columns.isEmpty() && (row < count); row++)
+    {
+        lua_rawgeti(luaL, cellsPos, row + 1);
+        int cellPos = lua_gettop(luaL);
+        result = (lua_topointer(luaL, cellPos) == frameCells.at(row));
+
+        for (int i = 0; result && (i < columns.size()); i++)
+        {
+            FrameColumn &col = frameColumns[columns.at(i)];
+
+            lua_pushlstring(luaL, col.key.constData(), col.key.size());
+            lua_rawget(luaL, cellPos);
+            TypesOfData type = luaCell::frameValue(luaL, number, text);
+            lua_pop(luaL, 1);
+
+            // a column without a type takes it from the first value
+            if ((col.type == TObsUnknownData) && (type != TObsUnknownData))
+            {
+                result = false;
+                break;
+            }
+
+            if ((type != TObsUnknownData) && (type != col.type))
+            {
+                warnMixedAttribute(luaL, col.name);
+                type = TObsUnknownData;
+            }
+
+            bool changed;
+            if (type == TObsUnknownData)
+                changed = (col.valid.at(row) != 0);
+            else if (col.valid.at(row) == 0)
+                changed = true;
+            else if (type == TObsText)
+                changed = (col.texts.at(row) != text);
+            else
+                // compares the bits, so NaN values without change are equal
+                changed = (memcmp(&col.numbers.at(row), &number, sizeof(double)) != 0);
+
+            if (!changed)
+                continue;
+
+            rowVersions[row] = sequence;
+            col.valid[row] = (type == TObsUnknownData) ? 0 : 1;
+            if (type == TObsText)
+                col.texts[row] = text;
+            else if (type != TObsUnknownData)
+                col.numbers[row] = number;
+        }
+        lua_settop(luaL, cellsPos);
+    }
+    lua_settop(luaL, top);
+    return result;
+}
+
+QByteArray luaCellularSpace::writeFrame(quint32 sequence, quint32 base)
+{
+    BinaryFrameWriter frame(getId(), subjectType);
+    frame.setSequence(sequence);
+
+    int indexCol = -1;
+    if (base > 0)
+    {
+        frame.setDelta(true);
+        frame.setBase(base);
+        indexCol = frame.addColumn(DELTA_INDEX_KEY, TObsNumber);
+    }
+
+    // the columns keep the type of the complete frame even if the rows of a delta do not have values
+    QVector<int> columns;
+    for (int c = 0; c < frameColumns.size(); c++)
+        columns.append(frame.addColumn(frameColumns.at(c).name, frameColumns.at(c).type));
+
+    for (int row = 0; row < frameCells.size(); row++)
+    {
+        int slot = frameSlots.at(row);
+
+        if ((base > 0) && (rowVersions.at(row) <= base)
+            && ((slot < 0) || (slotVersions[slot] <= base)))
+            continue;
+
+        frame.addRow();
+        if (indexCol >= 0)
+            frame.setNumber(indexCol, row);
+
+        for (int c = 0; c < frameColumns.size(); c++)
+        {
+            const FrameColumn &col = frameColumns.at(c);
+
+            // native attributes are read straight from their arrays
+            if (col.native >= 0)
+            {
+                if (slot >= 0)
+                    frame.setNumber(columns.at(c), presentAttributes[col.native][slot]);
+                continue;
+            }
+
+            if (col.valid.at(row) == 0)
+                continue;
+
+            switch (col.type)
+            {
+            case TObsBool:
+                frame.setBool(columns.at(c), col.numbers.at(row) != 0);
+                break;
+
+            case TObsText:
+                frame.setText(columns.at(c), col.texts.at(row).constData(), col.texts.at(row).size());
+                break;
+
+            default:
+                frame.setNumber(columns.at(c), col.numbers.at(row));
+                break;
+            }
+        }
+    }
+
+    return frame.toByteArray();
+}
+
+void luaCellularSpace::warnMixedAttribute(lua_State *luaL, const QString& attribute)
+{
+    if (mixedAttributes.contains(attribute))
+        return;
+
+    mixedAttributes.insert(attribute);
+    if (execModes != Quiet)
+    {
+        string err_out = string("Attribute '") + string(qPrintable(attribute))
+                + string("' has values of different types in the Cells, only the values of the first type are observed.");
+        lua_getglobal(luaL, "customWarning");
+        lua_pushstring(luaL, err_out.c_str());
+        lua_call(luaL, 1, 0);
+    }
+}
+
+QByteArray luaCellularSpace::getFrame(lua_State *luaL, QStringList& attribs)
+{
+    // zero identifies the frames that are not numbered. After a wrap, the
+    // sequence numbers of the maps cannot be compared anymore
+    if (++frameVersion == 0)
+    {
+        frameVersion = 1;
+        frameBase = 0;
+        std::fill(slotVersions.begin(), slotVersions.end(), 0);
+    }
+
+    // the observers report the last frame they drew, so a frame that was not
+    // drawn (or a delta that could not be applied) is patched again by this one
+    quint32 base = frameBase;
+    QHash<int, Observer *>::const_iterator it = observersHash.constBegin();
+    for (; (base > 0) && (it != observersHash.constEnd()); ++it)
+    {
+        quint32 received = ((ObserverMap *) it.value())->getFrameReceived();
+        if (received < frameBase)
+            base = 0;
+        else if (received < base)
+            base = received;
+    }
+
+    if ((base == 0) || (attribs != frameAttribs) || !updateFrame(luaL, frameVersion))
+    {
+        readFrame(luaL, attribs);
+        frameBase = frameVersion;
+        return writeFrame(frameVersion, 0);
+    }
+
+    int changed = 0;
+    for (int row = 0; row < frameCells.size(); row++)
+    {
+        int slot = frameSlots.at(row);
+        if ((rowVersions.at(row) > base) || ((slot >= 0) && (slotVersions[slot] > base)))
+            changed++;
+    }
+
+    // a delta row has one more column, the position of the row
+    int columns = frameColumns.size();
+    if ((qint64) changed * (columns + 1) >= (qint64) frameCells.size() * columns)
+        return writeFrame(frameVersion, 0);
+
+    return writeFrame(frameVersion, base);
+}
+
+bool luaCellularSpace::useBinaryFrame()
+{
+    return (!observersHash.isEmpty())
+        && (observersHash.size() == SubjectInterf::getObserversCount());
+}
+
 int luaCellularSpace::kill(lua_State *luaL)
 {
     int id = luaL_checknumber(luaL, 1);
 
     bool result = CellSpaceSubjectInterf::kill(id);
+    observersHash.remove(id);
     lua_pushboolean(luaL, result);
     return 1;
 }
@@ -975,7 +2050,5 @@ luaCell * luaCellularSpace::findCellByID(const char* cellID)
 /// Find a cell given a luaCellularSpace object and a luaCellIndex object
 luaCell * findCell(luaCellularSpace* cs, CellIndex& cellIndex)
 {
-    Region_<CellIndex>::iterator it = cs->find(cellIndex);
-    if (it != cs->end()) return(luaCell*)it->second;
-    return(luaCell*)0;
+    return(luaCell*)cs->getCell(cellIndex);
 }
@@ -36,8 +36,12 @@ extern "C"
 #include "luna.h"
 
 #include <QHash>
+#include <QSet>
 #include <QString>
 
+#include <cstring>
+#include <vector>
+
 #include "../observer/cellSpaceSubjectInterf.h"
 #include "luaCell.h"
 #include "reference.h"
@@ -105,6 +109,135 @@ public:
     /// no parameters
     int size(lua_State* L);
 
+    /// Reads the attributes of the cells from a CSV file mapped in memory
+    /// parameters: file name, separator, [vector of attribute names], [progress function], [true to add ids]
+    /// return: a vector with one table of attributes for each cell
+    int readCsv(lua_State *L);
+
+    /// Reads the values of the cells from a PGM file mapped in memory
+    /// parameters: file name, separator
+    /// return: a table with the header of the file and its lines of values
+    int readPgm(lua_State *L);
+
+    /// Moves the neighborhoods with a given name of all the cells to a single graph
+    /// in compressed sparse row format, shared by them
+    /// parameters: neighborhood name
+    int compactNeighborhood(lua_State *L);
+
+    /// Builds the neighborhoods of a built-in strategy for all the cells in C++, in
+    /// parallel, storing them in a graph in compressed sparse row format. Each cell
+    /// must already have an empty neighborhood with the given name.
+    /// parameters: neighborhood name, strategy (moore, vonneumann, diagonal or mxn),
+    /// table with self, wrap, m, n, xMin, xMax, yMin, and yMax
+    /// return: false if the cells are too sparse to be indexed by a dense grid
+    int createNeighborhood(lua_State *L);
+
+    /// Applies a function to all the cells using several threads, each one with its own
+    /// lua_State. The cells must store their attributes natively. Within the function,
+    /// only native attributes can be used, the past and the neighbors are read-only,
+    /// and upvalues must be numbers, strings or booleans.
+    /// parameters: function, number of threads (optional)
+    /// return: false if the function returned false for some cell
+    int forEachCellParallel(lua_State *L);
+
+    /// Declares an attribute stored natively, in one contiguous array for
+    /// the present values and another for the past values of the cells
+    /// parameters: attribute name
+    /// return: the index of the attribute
+    int addAttribute(lua_State *L);
+
+    /// Copies the present values of native attributes to their past values
+    /// parameters: indexes of the attributes. If empty, every attribute is copied
+    int synchronizeAttributes(lua_State *L);
+
+    /// Copies the native attributes to be stored in a checkpoint
+    /// return: a table indexed by the names of the attributes. Each value is a string
+    /// with the raw present values of the cells followed by their raw past values
+    int saveAttributes(lua_State *L);
+
+    /// Restores the native attributes copied by saveAttributes()
+    /// parameters: the table returned by saveAttributes()
+    int restoreAttributes(lua_State *L);
+
+    /// Summarizes an attribute of all the cells. Native attributes are read straight
+    /// from their arrays, using several threads in large CellularSpaces, while the other
+    /// attributes are read from the Lua tables of the cells.
+    /// parameters: attribute name, operation (sum, mean, minimum, maximum, count, or histogram),
+    /// number of threads (optional)
+    /// return: the sum, average, minimum, or maximum of a numeric attribute, the number of
+    /// cells whose attribute is neither false nor nil, or a table with the number of cells
+    /// with each value of the attribute. Average, minimum, and maximum return nil when
+    /// there is no cell.
+    int reduce(lua_State *L);
+
+    /// Copies the present values of the native attributes of one cell to their past values
+    /// \param slot the position of the cell in the attribute arrays
+    void synchronizeCell(int slot);
+
+    /// Guarantees that the native attribute arrays have a position for a cell
+    /// \param slot the position of the cell in the attribute arrays
+    void attachAttributes(int slot);
+
+    /// Gets the value of a native attribute
+    /// \param attribute the index of the attribute
+    /// \param slot the position of the cell in the attribute arrays
+    /// \param past whether the past value is read
+    inline double getAttribute(int attribute, int slot, bool past) const
+    {
+        return past ? pastAttributes[attribute][slot] : presentAttributes[attribute][slot];
+    }
+
+    /// Pushes the value of a native attribute. As the values are stored as doubles, the
+    /// values without a fractional part are pushed as integers, as they were written.
+    /// \param L the lua_State that receives the value
+    /// \param attribute the index of the attribute
+    /// \param slot the position of the cell in the attribute arrays
+    /// \param past whether the past value is read
+    inline void pushAttribute(lua_State *L, int attribute, int slot, bool past) const
+    {
+        double value = getAttribute(attribute, slot, past);
+#if LUA_VERSION_NUM >= 503
+        // doubles beyond 2^53 do not keep every integer, so they stay floats
+        if ((value >= -9007199254740992.0) && (value <= 9007199254740992.0)
+            && (value == (double) (lua_Integer) value))
+        {
+            lua_pushinteger(L, (lua_Integer) value);
+            return;
+        }
+#endif
+        lua_pushnumber(L, value);
+    }
+
+    /// Sets the value of a native attribute. A change in the present value marks the
+    /// cell to be sent in the next frame. Each thread of a parallel forEachCell writes
+    /// only the positions of its own cells.
+    /// \param attribute the index of the attribute
+    /// \param slot the position of the cell in the attribute arrays
+    /// \param value the new value
+    /// \param past whether the past value is written
+    inline void setAttribute(int attribute, int slot, double value, bool past)
+    {
+        if (past)
+        {
+            pastAttributes[attribute][slot] = value;
+            return;
+        }
+
+        double &current = presentAttributes[attribute][slot];
+        if (memcmp(&current, &value, sizeof(double)) != 0)
+        {
+            current = value;
+            slotVersions[slot] = frameVersion + 1;
+        }
+    }
+
+    /// Serializes the observed native attributes of a cell in the text protocol
+    /// \param slot the position of the cell in the attribute arrays
+    /// \param attribs the list of attributes observed
+    /// \param attrs the serialized attributes
+    /// \return the number of attributes serialized
+    int popAttributes(int slot, const QStringList& attribs, QString& attrs);
+
     /// Registers the luaCellularSpace object in the Lua stack
     // @DANIEL
     // Movido para Reference
@@ -157,6 +290,12 @@ public:
     /// \param attribs the list of attributes observed
     QString pop(lua_State *L, QStringList& attribs);
 
+    /// Gets the attributes of the cells in the columnar binary format. Every cell is read,
+    /// and the values are kept to build the next delta frames
+    /// \param attribs the list of attributes observed
+    /// \param sequence the sequence number of the frame, zero if it is not numbered
+    QByteArray popFrame(lua_State *L, QStringList& attribs, quint32 sequence = 0);
+
     /// Destroys the observer object instance
     int kill(lua_State *L);
 
@@ -180,8 +319,65 @@ private:
     bool getSpaceDimensions;
     QStringList observedAttribs;
     QHash<int, Observer *> observersHash;
+
+    /// Values of an observed attribute in the last frame sent to the map observers
+    struct FrameColumn
+    {
+        QString name;
+        QByteArray key; ///< name pushed onto the Lua stack
+        int native; ///< index of the native attribute, or -1 if it is read from the cells
+        TypesOfData type; ///< type of the values, defined by the first cell that has a value
+        QVector<double> numbers; ///< values of the numbers and booleans
+        QVector<QByteArray> texts; ///< values of the other types
+        QVector<uchar> valid; ///< zero for the cells without a value of the column type
+    };
+
+    quint32 frameVersion; ///< sequence number of the last frame sent to the map observers
+    quint32 frameBase; ///< last frame that read every cell, zero if the values are not kept
+    QStringList frameAttribs; ///< attributes observed in the frames
+    QVector<FrameColumn> frameColumns; ///< values of the last frame
+    QVector<const void *> frameCells; ///< Lua table of the cell of each row
+    QVector<int> frameSlots; ///< position of the cell of each row in the native arrays, or -1
+    QVector<quint32> rowVersions; ///< last frame that changed the attributes read from each cell
+    std::vector<quint32> slotVersions; ///< next frame after the last change of the native values of each cell
+    QSet<QString> mixedAttributes; ///< observed attributes already reported with values of different types
+    QHash<QString, int> attributesIndex; ///< index of each native attribute
+    std::vector< std::vector<double> > presentAttributes; ///< present values of the native attributes
+    std::vector< std::vector<double> > pastAttributes; ///< past values of the native attributes
+    int attributesSize; ///< number of positions of each native attribute array
     QString getAll(QDataStream& in, int obsId, QStringList& attribs);
-    QString getChanges(QDataStream& in, int obsId, QStringList& attribs);
+
+    /// Returns true when every attached observer can decode binary frames
+    bool useBinaryFrame();
+
+    /// Builds the frame sent to the map observers. As the BlackBoard shares the frame
+    /// among them, it carries the cells changed after the oldest frame drawn by a map.
+    /// \param attribs the list of attributes observed
+    QByteArray getFrame(lua_State *L, QStringList& attribs);
+
+    /// Reads every observed attribute of every cell, replacing the values kept
+    /// \param attribs the list of attributes observed
+    void readFrame(lua_State *L, const QStringList& attribs);
+
+    /// Reads again the attributes that are not native, except x and y, marking the
+    /// cells whose values changed. Native values are marked when they are written.
+    /// \param sequence the sequence number of the new frame
+    /// \return false if the cells or the types of the attributes changed, which
+    /// requires reading every attribute again
+    bool updateFrame(lua_State *L, quint32 sequence);
+
+    /// Writes the values kept in a binary frame
+    /// \param sequence the sequence number of the frame
+    /// \param base zero for a complete frame, otherwise the frame after which the
+    /// rows of a delta frame changed
+    QByteArray writeFrame(quint32 sequence, quint32 base);
+
+    /// Warns once that an attribute has values of different types
+    void warnMixedAttribute(lua_State *L, const QString& attribute);
+
+    /// Gets the luaCell objects, following the order of the Lua vector of cells
+    /// \param cells receives the cells
+    void getCells(lua_State *L, vector<luaCell*>& cells);
 
 //    void loadLegendsFromDatabase(TeDatabase *db, TeTheme *inputTheme, QString& luaLegend);
 };
@@ -0,0 +1,851 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "luaDataFrame.h"
+
+extern "C"
+{
+#include <lauxlib.h>
+}
+
+#include <QByteArray>
+#include <QFile>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+
+#include "checkpoint.h"
+
+/// Size of the buffer used to write CSV files
+static const int DATA_FRAME_BUFFER_SIZE = 1 << 20;
+
+/// Raises the error message on the top of the stack through customError()
+static int raiseError(lua_State *L)
+{
+    lua_getglobal(L, "customError");
+    lua_insert(L, -2);
+    lua_call(L, 1, 0);
+    return 0;
+}
+
+static const char * typeName(DataFrameColumnType type)
+{
+    switch (type)
+    {
+    case DF_NUMBER:
+    case DF_INTEGER:
+        return "number";
+    case DF_BOOLEAN:
+        return "boolean";
+    case DF_STRING:
+        return "string";
+    default:
+        return "nil";
+    }
+}
+
+luaDataFrame::luaDataFrame(lua_State *)
+    : rows(0), first(1), step(1)
+{
+}
+
+luaDataFrame::~luaDataFrame(void)
+{
+}
+
+int luaDataFrame::config(lua_State *L)
+{
+    first = luaL_checknumber(L, 1);
+    step = luaL_checknumber(L, 2);
+    int quantity = (int) luaL_optinteger(L, 3, 0);
+
+    for (int i = rows; i < quantity; i++)
+        appendRow();
+
+    return 0;
+}
+
+int luaDataFrame::size(lua_State *L)
+{
+    lua_pushinteger(L, rows);
+    return 1;
+}
+
+int luaDataFrame::getColumns(lua_State *L)
+{
+    lua_createtable(L, 0, (int) columns.size());
+
+    for (size_t i = 0; i < columns.size(); i++)
+    {
+        lua_pushboolean(L, 1);
+        lua_setfield(L, -2, columns[i].name.c_str());
+    }
+
+    return 1;
+}
+
+int luaDataFrame::add(lua_State *L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    int row = lua_isnoneornil(L, 2) ? rows : toRow(L, 2);
+
+    if (row < 0 || row > rows)
+    {
+        lua_pushfstring(L, "Position %s is out of the DataFrame.", luaL_tolstring(L, 2, NULL));
+        return raiseError(L);
+    }
+
+    if (row == rows)
+        appendRow();
+
+    bool created = false;
+    string error;
+
+    lua_pushnil(L);
+    while (lua_next(L, 1))
+    {
+        if (lua_type(L, -2) != LUA_TSTRING)
+        {
+            lua_pushfstring(L, "Column names should be strings, got %s.", luaL_typename(L, -2));
+            return raiseError(L);
+        }
+
+        bool newColumn;
+        int index = column(lua_tostring(L, -2), newColumn);
+        created = created || newColumn;
+
+        if (!setValue(columns[index], row, L, -1, error))
+        {
+            lua_pushstring(L, error.c_str());
+            return raiseError(L);
+        }
+
+        lua_pop(L, 1);
+    }
+
+    lua_pushboolean(L, created);
+    return 1;
+}
+
+int luaDataFrame::remove(lua_State *L)
+{
+    int row = toRow(L, 1);
+
+    if (row < 0 || row >= rows)
+    {
+        lua_pushfstring(L, "Position %s does not exist in the DataFrame.", luaL_tolstring(L, 1, NULL));
+        return raiseError(L);
+    }
+
+    for (size_t i = 0; i < columns.size(); i++)
+    {
+        Column& col = columns[i];
+
+        col.valid.erase(col.valid.begin() + row);
+
+        switch (col.type)
+        {
+        case DF_NUMBER:
+            col.numbers.erase(col.numbers.begin() + row);
+            break;
+        case DF_INTEGER:
+            col.integers.erase(col.integers.begin() + row);
+            break;
+        case DF_BOOLEAN:
+            col.booleans.erase(col.booleans.begin() + row);
+            break;
+        case DF_STRING:
+            col.codes.erase(col.codes.begin() + row);
+            break;
+        default:
+            break;
+        }
+    }
+
+    rows--;
+    return 0;
+}
+
+int luaDataFrame::get(lua_State *L)
+{
+    if (lua_type(L, 1) != LUA_TSTRING)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    unordered_map<string, int>::const_iterator it = columnsIndex.find(lua_tostring(L, 1));
+    int row = toRow(L, 2);
+
+    if (it == columnsIndex.end() || row < 0 || row >= rows)
+        lua_pushnil(L);
+    else
+        pushValue(L, columns[it->second], row);
+
+    return 1;
+}
+
+int luaDataFrame::set(lua_State *L)
+{
+    string name = luaL_checkstring(L, 1);
+    int row = toRow(L, 2);
+
+    if (row < 0 || row >= rows)
+    {
+        lua_pushfstring(L, "Position %s does not exist in the DataFrame.", luaL_tolstring(L, 2, NULL));
+        return raiseError(L);
+    }
+
+    bool created;
+    string error;
+
+    if (!setValue(columns[column(name, created)], row, L, 3, error))
+    {
+        lua_pushstring(L, error.c_str());
+        return raiseError(L);
+    }
+
+    return 0;
+}
+
+int luaDataFrame::getColumn(lua_State *L)
+{
+    string name = luaL_checkstring(L, 1);
+    unordered_map<string, int>::const_iterator it = columnsIndex.find(name);
+
+    if (it == columnsIndex.end())
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    const Column& col = columns[it->second];
+
+    lua_createtable(L, rows, 0);
+
+    for (int row = 0; row < rows; row++)
+    {
+        if (!col.valid[row])
+            continue;
+
+        lua_pushnumber(L, toPosition(row));
+        pushValue(L, col, row);
+        lua_rawset(L, -3);
+    }
+
+    return 1;
+}
+
+int luaDataFrame::setColumn(lua_State *L)
+{
+    string name = luaL_checkstring(L, 1);
+    luaL_checktype(L, 2, LUA_TTABLE);
+
+    if (rows == 0 && columns.empty())
+    {
+        int quantity = (int) lua_rawlen(L, 2);
+
+        for (int i = 0; i < quantity; i++)
+            appendRow();
+    }
+
+    bool created;
+    Column& col = columns[column(name, created)];
+    string error;
+
+    reset(col);
+
+    for (int row = 0; row < rows; row++)
+    {
+        lua_pushnumber(L, toPosition(row));
+        lua_rawget(L, 2);
+
+        if (!setValue(col, row, L, -1, error))
+        {
+            lua_pushstring(L, error.c_str());
+            return raiseError(L);
+        }
+
+        lua_pop(L, 1);
+    }
+
+    return 0;
+}
+
+int luaDataFrame::sum(lua_State *L)
+{
+    const Column& col = columns[numericColumn(L)];
+
+    if (col.type == DF_INTEGER)
+    {
+        lua_Integer result = 0;
+
+        for (int row = 0; row < rows; row++)
+            if (col.valid[row]) result += col.integers[row];
+
+        lua_pushinteger(L, result);
+    }
+    else
+    {
+        lua_Number result = 0;
+
+        if (col.type == DF_NUMBER)
+            for (int row = 0; row < rows; row++)
+                if (col.valid[row]) result += col.numbers[row];
+
+        lua_pushnumber(L, result);
+    }
+
+    return 1;
+}
+
+int luaDataFrame::mean(lua_State *L)
+{
+    const Column& col = columns[numericColumn(L)];
+    lua_Number result = 0;
+    int count = 0;
+
+    for (int row = 0; row < rows; row++)
+    {
+        if (!col.valid[row])
+            continue;
+
+        result += col.type == DF_INTEGER ? (lua_Number) col.integers[row] : col.numbers[row];
+        count++;
+    }
+
+    if (count == 0)
+        lua_pushnil(L);
+    else
+        lua_pushnumber(L, result / count);
+
+    return 1;
+}
+
+int luaDataFrame::minimum(lua_State *L)
+{
+    const Column& col = columns[numericColumn(L)];
+    int best = -1;
+
+    for (int row = 0; row < rows; row++)
+    {
+        if (!col.valid[row])
+            continue;
+
+        if (best < 0 || (col.type == DF_INTEGER ? col.integers[row] < col.integers[best]
+                                               : col.numbers[row] < col.numbers[best]))
+            best = row;
+    }
+
+    if (best < 0)
+        lua_pushnil(L);
+    else
+        pushValue(L, col, best);
+
+    return 1;
+}
+
+int luaDataFrame::maximum(lua_State *L)
+{
+    const Column& col = columns[numericColumn(L)];
+    int best = -1;
+
+    for (int row = 0; row < rows; row++)
+    {
+        if (!col.valid[row])
+            continue;
+
+        if (best < 0 || (col.type == DF_INTEGER ? col.integers[row] > col.integers[best]
+                                               : col.numbers[row] > col.numbers[best]))
+            best = row;
+    }
+
+    if (best < 0)
+        lua_pushnil(L);
+    else
+        pushValue(L, col, best);
+
+    return 1;
+}
+
+int luaDataFrame::quantile(lua_State *L)
+{
+    const Column& col = columns[numericColumn(L)];
+    lua_Number probability = luaL_checknumber(L, 2);
+
+    vector<double> values;
+    numericValues(col, values);
+
+    if (values.empty())
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    // the same definition of the default quantile of R (type 7)
+    double h = (values.size() - 1) * probability;
+    size_t lower = (size_t) floor(h);
+
+    nth_element(values.begin(), values.begin() + lower, values.end());
+    double result = values[lower];
+
+    if (h > lower)
+    {
+        // after nth_element, the next value in order is the smallest one after the lower
+        double upper = *min_element(values.begin() + lower + 1, values.end());
+        result += (h - lower) * (upper - result);
+    }
+
+    lua_pushnumber(L, result);
+    return 1;
+}
+
+int luaDataFrame::save(lua_State *L)
+{
+    string filename = luaL_checkstring(L, 1);
+    const char *separator = luaL_optstring(L, 2, ",");
+
+    string extension = ".tmck";
+    bool binary = filename.size() > extension.size() &&
+            filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+
+    string error;
+    bool saved;
+
+    if (binary)
+    {
+        pushTable(L);
+        saved = Checkpoint::save(L, -1, filename, error);
+        lua_pop(L, 1);
+    }
+    else
+    {
+        saved = saveCsv(filename, separator[0]);
+        error = "File '" + filename + "' could not be written.";
+    }
+
+    if (!saved)
+    {
+        lua_pushstring(L, error.c_str());
+        return raiseError(L);
+    }
+
+    return 0;
+}
+
+int luaDataFrame::load(lua_State *L)
+{
+    string filename = luaL_checkstring(L, 1);
+    string error;
+
+    if (!Checkpoint::load(L, filename, error))
+    {
+        lua_pushstring(L, error.c_str());
+        return raiseError(L);
+    }
+
+    return 1;
+}
+
+int luaDataFrame::toRow(lua_State *L, int index) const
+{
+    if (lua_type(L, index) != LUA_TNUMBER)
+        return -1;
+
+    double row = (lua_tonumber(L, index) - first) / step;
+    double rounded = floor(row + 0.5);
+
+    if (fabs(row - rounded) > 1e-9 || rounded < 0 || rounded > rows)
+        return -1;
+
+    return (int) rounded;
+}
+
+lua_Number luaDataFrame::toPosition(int row) const
+{
+    return first + row * step;
+}
+
+int luaDataFrame::column(const string& name, bool& created)
+{
+    unordered_map<string, int>::const_iterator it = columnsIndex.find(name);
+
+    created = it == columnsIndex.end();
+    if (!created)
+        return it->second;
+
+    Column col;
+    col.name = name;
+    col.type = DF_EMPTY;
+    col.valid.assign(rows, 0);
+
+    columns.push_back(col);
+    columnsIndex[name] = (int) columns.size() - 1;
+    return (int) columns.size() - 1;
+}
+
+int luaDataFrame::numericColumn(lua_State *L)
+{
+    string name = luaL_checkstring(L, 1);
+    unordered_map<string, int>::const_iterator it = columnsIndex.find(name);
+
+    if (it == columnsIndex.end())
+    {
+        lua_pushfstring(L, "Column '%s' does not exist in the DataFrame.", name.c_str());
+        raiseError(L);
+    }
+
+    const Column& col = columns[it->second];
+
+    if (col.type == DF_BOOLEAN || col.type == DF_STRING)
+    {
+        lua_pushfstring(L, "Column '%s' should have numeric values, got %s.", name.c_str(), typeName(col.type));
+        raiseError(L);
+    }
+
+    return it->second;
+}
+
+void luaDataFrame::appendRow()
+{
+    for (size_t i = 0; i < columns.size(); i++)
+    {
+        Column& col = columns[i];
+
+        col.valid.push_back(0);
+
+        switch (col.type)
+        {
+        case DF_NUMBER:
+            col.numbers.push_back(0);
+            break;
+        case DF_INTEGER:
+            col.integers.push_back(0);
+            break;
+        case DF_BOOLEAN:
+            col.booleans.push_back(0);
+            break;
+        case DF_STRING:
+            col.codes.push_back(0);
+            break;
+        default:
+            break;
+        }
+    }
+
+    rows++;
+}
+
+void luaDataFrame::reset(Column& col)
+{
+    col.type = DF_EMPTY;
+    col.numbers.clear();
+    col.integers.clear();
+    col.booleans.clear();
+    col.codes.clear();
+    col.dictionary.clear();
+    col.dictionaryIndex.clear();
+    col.valid.assign(rows, 0);
+}
+
+void luaDataFrame::promote(Column& col)
+{
+    col.numbers.resize(col.integers.size());
+
+    for (size_t row = 0; row < col.integers.size(); row++)
+        col.numbers[row] = (double) col.integers[row];
+
+    vector<lua_Integer>().swap(col.integers);
+    col.type = DF_NUMBER;
+}
+
+bool luaDataFrame::setValue(Column& col, int row, lua_State *L, int index, string& error)
+{
+    DataFrameColumnType type;
+
+    switch (lua_type(L, index))
+    {
+    case LUA_TNIL:
+        col.valid[row] = 0;
+        return true;
+    case LUA_TNUMBER:
+#if LUA_VERSION_NUM >= 503
+        type = lua_isinteger(L, index) ? DF_INTEGER : DF_NUMBER;
+#else
+        type = DF_NUMBER;
+#endif
+        break;
+    case LUA_TBOOLEAN:
+        type = DF_BOOLEAN;
+        break;
+    case LUA_TSTRING:
+        type = DF_STRING;
+        break;
+    default:
+        error = "Column '" + col.name + "' cannot store values of type " + luaL_typename(L, index) + ".";
+        return false;
+    }
+
+    if (col.type == DF_EMPTY)
+    {
+        col.type = type;
+
+        switch (type)
+        {
+        case DF_NUMBER:
+            col.numbers.assign(rows, 0);
+            break;
+        case DF_INTEGER:
+            col.integers.assign(rows, 0);
+            break;
+        case DF_BOOLEAN:
+            col.booleans.assign(rows, 0);
+            break;
+        default:
+            col.codes.assign(rows, 0);
+            break;
+        }
+    }
+    else if (col.type == DF_INTEGER && type == DF_NUMBER)
+        promote(col);
+    else if (col.type == DF_NUMBER && type == DF_INTEGER)
+        type = DF_NUMBER;
+
+    if (col.type != type)
+    {
+        error = "Column '" + col.name + "' should have values of type " + typeName(col.type) +
+                ", got " + typeName(type) + ".";
+        return false;
+    }
+
+    switch (type)
+    {
+    case DF_NUMBER:
+        col.numbers[row] = lua_tonumber(L, index);
+        break;
+    case DF_INTEGER:
+        col.integers[row] = lua_tointeger(L, index);
+        break;
+    case DF_BOOLEAN:
+        col.booleans[row] = (char) lua_toboolean(L, index);
+        break;
+    default:
+    {
+        size_t length;
+        const char *value = lua_tolstring(L, index, &length);
+        string text(value, length);
+
+        unordered_map<string, int>::const_iterator it = col.dictionaryIndex.find(text);
+
+        if (it == col.dictionaryIndex.end())
+        {
+            col.codes[row] = (int) col.dictionary.size();
+            col.dictionaryIndex[text] = col.codes[row];
+            col.dictionary.push_back(text);
+        }
+        else
+            col.codes[row] = it->second;
+    }
+    }
+
+    col.valid[row] = 1;
+    return true;
+}
+
+void luaDataFrame::pushValue(lua_State *L, const Column& col, int row) const
+{
+    if (!col.valid[row])
+    {
+        lua_pushnil(L);
+        return;
+    }
+
+    switch (col.type)
+    {
+    case DF_NUMBER:
+        lua_pushnumber(L, col.numbers[row]);
+        break;
+    case DF_INTEGER:
+        lua_pushinteger(L, col.integers[row]);
+        break;
+    case DF_BOOLEAN:
+        lua_pushboolean(L, col.booleans[row]);
+        break;
+    case DF_STRING:
+    {
+        const string& value = col.dictionary[col.codes[row]];
+        lua_pushlstring(L, value.data(), value.size());
+        break;
+    }
+    default:
+        lua_pushnil(L);
+    }
+}
+
+void luaDataFrame::numericValues(const Column& col, vector<double>& values) const
+{
+    values.reserve(rows);
+
+    for (int row = 0; row < rows; row++)
+    {
+        if (!col.valid[row])
+            continue;
+
+        values.push_back(col.type == DF_INTEGER ? (double) col.integers[row] : col.numbers[row]);
+    }
+}
+
+void luaDataFrame::pushTable(lua_State *L) const
+{
+    lua_createtable(L, 0, (int) columns.size() + 2);
+
+    // default values are not stored, as DataFrame() warns when they are used
+    if (first != 1)
+    {
+        lua_pushnumber(L, first);
+        lua_setfield(L, -2, "first");
+    }
+
+    if (step != 1)
+    {
+        lua_pushnumber(L, step);
+        lua_setfield(L, -2, "step");
+    }
+
+    for (size_t i = 0; i < columns.size(); i++)
+    {
+        const Column& col = columns[i];
+
+        lua_createtable(L, rows, 0);
+
+        for (int row = 0; row < rows; row++)
+        {
+            pushValue(L, col, row);
+            lua_rawseti(L, -2, row + 1);
+        }
+
+        lua_setfield(L, -2, col.name.c_str());
+    }
+}
+
+/// Appends a text to a CSV line, quoting it when needed
+static void appendText(QByteArray& buffer, const string& value, char separator)
+{
+    bool quote = !value.empty() && (value.find_first_of("\"\r\n") != string::npos ||
+            value.find(separator) != string::npos || isspace((unsigned char) value[0]) ||
+            isspace((unsigned char) value[value.size() - 1]));
+
+    if (!quote)
+    {
+        buffer.append(value.data(), (int) value.size());
+        return;
+    }
+
+    buffer.append('"');
+
+    for (size_t i = 0; i < value.size(); i++)
+    {
+        if (value[i] == '"')
+            buffer.append('"');
+
+        buffer.append(value[i]);
+    }
+
+    buffer.append('"');
+}
+
+bool luaDataFrame::saveCsv(const string& filename, char separator) const
+{
+    QFile file(QString::fromLocal8Bit(filename.c_str()));
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    // columns are saved in alphabetical order, as in tostring()
+    vector<const Column*> ordered;
+    for (size_t i = 0; i < columns.size(); i++)
+        ordered.push_back(&columns[i]);
+
+    sort(ordered.begin(), ordered.end(), [](const Column *a, const Column *b) {
+        return a->name < b->name;
+    });
+
+    QByteArray buffer;
+    buffer.reserve(DATA_FRAME_BUFFER_SIZE + 4096);
+    char number[64];
+    bool ok = true;
+
+    for (size_t i = 0; i < ordered.size(); i++)
+    {
+        if (i > 0) buffer.append(separator);
+        appendText(buffer, ordered[i]->name, separator);
+    }
+
+    buffer.append('\n');
+
+    for (int row = 0; row < rows && ok; row++)
+    {
+        for (size_t i = 0; i < ordered.size(); i++)
+        {
+            const Column& col = *ordered[i];
+
+            if (i > 0) buffer.append(separator);
+            if (!col.valid[row]) continue;
+
+            switch (col.type)
+            {
+            case DF_NUMBER:
+                buffer.append(number, snprintf(number, sizeof(number), "%.14g", col.numbers[row]));
+                break;
+            case DF_INTEGER:
+                buffer.append(number, snprintf(number, sizeof(number), "%lld", (long long) col.integers[row]));
+                break;
+            case DF_BOOLEAN:
+                buffer.append(col.booleans[row] ? "true" : "false");
+                break;
+            case DF_STRING:
+                appendText(buffer, col.dictionary[col.codes[row]], separator);
+                break;
+            default:
+                break;
+            }
+        }
+
+        buffer.append('\n');
+
+        if (buffer.size() >= DATA_FRAME_BUFFER_SIZE)
+        {
+            ok = file.write(buffer) == buffer.size();
+            buffer.resize(0);
+        }
+    }
+
+    if (ok && buffer.size() > 0)
+        ok = file.write(buffer) == buffer.size();
+
+    file.close();
+    return ok;
+}
@@ -0,0 +1,217 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*!
+  \file luaDataFrame.h
+  \brief This file contains definitions about the columnar storage of DataFrames:
+                 luaDataFrame class.
+*/
+
+#ifndef LUA_DATA_FRAME_H
+#define LUA_DATA_FRAME_H
+
+extern "C"
+{
+#include <lua.h>
+}
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+#include "luna.h"
+
+/// Types of the values stored in a column of a luaDataFrame
+enum DataFrameColumnType
+{
+    DF_EMPTY = 0, ///< column without any value, its type is defined by the first value
+    DF_NUMBER,
+    DF_INTEGER,
+    DF_BOOLEAN,
+    DF_STRING
+};
+
+/**
+ * \brief
+ *  Stores the columns of a DataFrame created with native = true. Each column is a
+ *  contiguous typed array (numbers, integers, booleans, or indexes in a dictionary of
+ *  strings) plus a flag for each row indicating whether it has a value. The type of a
+ *  column is defined by its first value. Integer columns become number columns when
+ *  they receive a float, and any other change of type is an error.
+ *  Rows are accessed from Lua through their positions, which start in 'first' and
+ *  increase by 'step', as in the DataFrames stored in Lua tables.
+ *
+ */
+class luaDataFrame
+{
+public:
+    ///< Data structure issued by Luna<T>
+    static const char className[];
+
+    ///< Data structure issued by Luna<T>
+    static Luna<luaDataFrame>::RegType methods[];
+
+    /// Constructor
+    luaDataFrame(lua_State *L);
+
+    /// Destructor
+    ~luaDataFrame(void);
+
+    /// Configures the positions of the rows and creates empty rows
+    /// parameters: first position, step between positions, number of rows
+    int config(lua_State *L);
+
+    /// Gets the number of rows
+    int size(lua_State *L);
+
+    /// Gets the names of the columns
+    /// return: a named table whose values are true
+    int getColumns(lua_State *L);
+
+    /// Adds a row, or updates the values of an existing row
+    /// parameters: named table with the values, optional position of the row
+    /// return: true if a new column was created
+    int add(lua_State *L);
+
+    /// Removes a row, moving the next rows one position back
+    /// parameters: position of the row
+    int remove(lua_State *L);
+
+    /// Gets a value
+    /// parameters: column name, position of the row
+    /// return: the value, or nil if the column or the row does not exist
+    int get(lua_State *L);
+
+    /// Sets a value, creating the column if it does not exist
+    /// parameters: column name, position of the row, value
+    int set(lua_State *L);
+
+    /// Gets the values of a column
+    /// parameters: column name
+    /// return: a table indexed by the positions of the rows
+    int getColumn(lua_State *L);
+
+    /// Replaces all the values of a column, creating it if it does not exist
+    /// parameters: column name, table indexed by the positions of the rows
+    int setColumn(lua_State *L);
+
+    /// Sums the values of a numeric column, ignoring the rows without value
+    /// parameters: column name
+    int sum(lua_State *L);
+
+    /// Computes the average of the values of a numeric column
+    /// parameters: column name
+    /// return: the average, or nil if the column has no value
+    int mean(lua_State *L);
+
+    /// Gets the minimum value of a numeric column
+    /// parameters: column name
+    /// return: the minimum, or nil if the column has no value
+    int minimum(lua_State *L);
+
+    /// Gets the maximum value of a numeric column
+    /// parameters: column name
+    /// return: the maximum, or nil if the column has no value
+    int maximum(lua_State *L);
+
+    /// Computes a quantile of a numeric column, interpolating linearly between
+    /// the two closest values
+    /// parameters: column name, probability between 0 and 1
+    /// return: the quantile, or nil if the column has no value
+    int quantile(lua_State *L);
+
+    /// Saves the DataFrame in a file. Files with extension '.tmck' are saved in
+    /// the binary format of Checkpoint, as a table with the arguments to create the
+    /// DataFrame again. Other files are saved as CSV.
+    /// parameters: file name, optional CSV separator
+    int save(lua_State *L);
+
+    /// Loads a file saved in the binary format
+    /// parameters: file name
+    /// return: a table with the arguments to create the DataFrame
+    int load(lua_State *L);
+
+private:
+    struct Column
+    {
+        string name;
+        DataFrameColumnType type;
+        vector<double> numbers;
+        vector<lua_Integer> integers;
+        vector<char> booleans;
+        vector<int> codes; ///< indexes in the dictionary
+        vector<string> dictionary;
+        unordered_map<string, int> dictionaryIndex;
+        vector<char> valid; ///< whether each row has a value
+    };
+
+    /// Gets the row of a position
+    /// \return the row, or -1 if the value at index is not the position of a row
+    int toRow(lua_State *L, int index) const;
+
+    /// Gets the position of a row
+    lua_Number toPosition(int row) const;
+
+    /// Gets the index of a column, creating it if needed
+    /// \param created receives true if the column was created
+    int column(const string& name, bool& created);
+
+    /// Gets the index of a numeric column from the first argument of a function,
+    /// or raises an error if it does not exist or it is not numeric
+    int numericColumn(lua_State *L);
+
+    /// Appends a row without values to all the columns
+    void appendRow();
+
+    /// Removes all the values of a column
+    void reset(Column& col);
+
+    /// Converts an integer column into a number column
+    void promote(Column& col);
+
+    /// Sets a value of a column from a value of the Lua stack
+    /// \param error receives the reason of the failure
+    /// \return false if the value does not match the type of the column
+    bool setValue(Column& col, int row, lua_State *L, int index, string& error);
+
+    /// Pushes a value onto the Lua stack, or nil if the row has no value
+    void pushValue(lua_State *L, const Column& col, int row) const;
+
+    /// Copies the valid values of a numeric column
+    void numericValues(const Column& col, vector<double>& values) const;
+
+    /// Pushes the table with the arguments to create the DataFrame onto the stack
+    void pushTable(lua_State *L) const;
+
+    /// Writes the DataFrame as CSV
+    bool saveCsv(const string& filename, char separator) const;
+
+    vector<Column> columns;
+    unordered_map<string, int> columnsIndex;
+    int rows;
+    lua_Number first;
+    lua_Number step;
+};
+
+#endif
@@ -21,6 +21,7 @@ indirect, special, incidental, or consequential damages arising out of the use
 of this software and its documentation.
 *************************************************************************************/
 
+#include "checkpoint.h"
 #include "luaEnvironment.h"
 #include "luaTimer.h"
 #include "luaCellularSpace.h"
@@ -756,3 +757,33 @@ int luaEnvironment::kill(lua_State *luaL)
     return 1;
 }
 
+int luaEnvironment::checkpoint(lua_State *L)
+{
+    string filename = luaL_checkstring(L, 1);
+    luaL_checktype(L, 2, LUA_TTABLE);
+
+    string error;
+    if (!Checkpoint::save(L, 2, filename, error))
+    {
+        lua_getglobal(L, "customError");
+        lua_pushstring(L, error.c_str());
+        lua_call(L, 1, 0);
+    }
+
+    return 0;
+}
+
+int luaEnvironment::restore(lua_State *L)
+{
+    string filename = luaL_checkstring(L, 1);
+
+    string error;
+    if (!Checkpoint::load(L, filename, error))
+    {
+        lua_getglobal(L, "customError");
+        lua_pushstring(L, error.c_str());
+        lua_call(L, 1, 0);
+    }
+
+    return 1;
+}
@@ -129,5 +129,14 @@ public:
 
     /// Destroys the observer object instance
     int kill(lua_State *L);
+
+    /// Saves the state of the simulation into a binary checkpoint file
+    /// parameters: file name, table with the state
+    int checkpoint(lua_State *L);
+
+    /// Loads the state of the simulation from a binary checkpoint file
+    /// parameters: file name
+    /// return: the table with the state
+    int restore(lua_State *L);
 };
 #endif
@@ -35,15 +35,72 @@ extern lua_State * L; ///< Gobal variabel: Lua stack used for comunication with
 luaNeighborhood::luaNeighborhood(lua_State *L) {
     it = CellNeighborhood::begin();
     itNext = false;
+    row = -1;
+    position = 0;
 }
 
 /// destructor
 luaNeighborhood::~luaNeighborhood(void) { }
 
+/// Moves the neighbors to a row of a graph shared by the neighborhoods with the same name
+void luaNeighborhood::setGraph(QSharedPointer<NeighborhoodGraph> g, int r)
+{
+    CellNeighborhood::clear();
+    it = CellNeighborhood::end();
+    itNext = false;
+
+    graph = g;
+    row = r;
+    position = graph->end(row);
+}
+
+/// Copies the neighbors back from the shared graph, keeping the iterator position
+void luaNeighborhood::detach()
+{
+    if (!graph)
+        return;
+
+    graph->copyRow(row, *this);
+
+    it = CellNeighborhood::begin();
+    for (int pos = graph->begin(row); (pos < position) && (it != CellNeighborhood::end()); pos++)
+        it++;
+
+    graph.clear();
+    row = -1;
+    position = 0;
+}
+
+/// Gets all the neighbors and their weights at once, without changing the iterator
+void luaNeighborhood::getNeighbors(vector<Cell*>& cells, vector<double>& weights)
+{
+    cells.clear();
+    weights.clear();
+
+    if (graph)
+    {
+        for (int pos = graph->begin(row); pos < graph->end(row); pos++)
+        {
+            cells.push_back(graph->getCell(pos));
+            weights.push_back(graph->getWeight(pos));
+        }
+        return;
+    }
+
+    for (CellNeighborhood::iterator theIterator = CellNeighborhood::begin();
+         theIterator != CellNeighborhood::end(); theIterator++)
+    {
+        CellIndex indx = theIterator->first;
+        cells.push_back(theIterator->second);
+        weights.push_back(CellNeighborhood::getWeight(indx));
+    }
+}
+
 /// Adds a new cell to the luaNeigborhood
 /// parameters: cell.y, cell.x,  cell, weight
 /// return luaCell
 int luaNeighborhood::addNeighbor(lua_State *L) {
+    detach();
     double weight = luaL_checknumber(L, -1);
     luaCell *cell = Luna<luaCell>::check(L, -2);
     CellIndex cellIndex;
@@ -61,6 +118,7 @@ int luaNeighborhood::addNeighbor(lua_State *L) {
 /// parameters: cell.x, cell.y
 /// \author Raian Vargas Maretto
 int luaNeighborhood::eraseNeighbor(lua_State *L) {
+	detach();
 //	luaCell *cell =(luaCell*)Luna<luaCell>::check(L, -1);
 	CellIndex cellIndex;
 	cellIndex.second = luaL_checknumber(L, -2);
@@ -78,6 +136,7 @@ int luaNeighborhood::eraseNeighbor(lua_State *L) {
 /// parameters: cell index,  cell, weight
 /// return luaCell
 int luaNeighborhood::addCell(lua_State *L) {
+    detach();
     double weight = luaL_checknumber(L, -1);
     luaCellularSpace *cs = Luna<luaCellularSpace>::check(L, -2);
     luaCellIndex *cI = Luna<luaCellIndex>::check(L, -3);
@@ -94,6 +153,7 @@ int luaNeighborhood::addCell(lua_State *L) {
 /// Removes the luaNeighbor cell from the luaNeighborhood
 /// parameters: cell index
 int luaNeighborhood::eraseCell(lua_State *L) {
+    detach();
     luaCellIndex *cI = Luna<luaCellIndex>::check(L, -1);
     CellIndex cellIndex; cellIndex.first = cI->x; cellIndex.second = cI->y;
     // Raian: Coloquei esta compara??o porque quando um vizinho era retirado da vizinhan?a o iterador era invalidado
@@ -113,6 +173,11 @@ int luaNeighborhood::eraseCell(lua_State *L) {
 int luaNeighborhood::getCellWeight(lua_State *L) {
     luaCellIndex *cI = Luna<luaCellIndex>::check(L, -1);
     CellIndex cellIndex; cellIndex.first = cI->x; cellIndex.second = cI->y;
+    if (graph) {
+        int pos = graph->find(row, cellIndex);
+        lua_pushnumber(L, pos >= 0 ? graph->getWeight(pos) : 0);
+        return 1;
+    }
     lua_pushnumber(L, CellNeighborhood::getWeight(cellIndex));
     return 1;
 }
@@ -123,7 +188,12 @@ int luaNeighborhood::getCellWeight(lua_State *L) {
 int luaNeighborhood::getCellNeighbor(lua_State *L) {
     luaCellIndex *cI = Luna<luaCellIndex>::check(L, -1);
     CellIndex cellIndex; cellIndex.first = cI->x; cellIndex.second = cI->y;
-    luaCell *cell =(luaCell*)(*CellNeighborhood::pImpl_)[ cellIndex ];
+    luaCell *cell;
+    if (graph) {
+        int pos = graph->find(row, cellIndex);
+        cell = pos >= 0 ? (luaCell*)graph->getCell(pos) : 0;
+    }
+    else cell =(luaCell*)(*CellNeighborhood::pImpl_)[ cellIndex ];
     if (cell) cell->getReference(L);
     else lua_pushnil(L);
     return 1;
@@ -137,6 +207,11 @@ int luaNeighborhood::getWeight(lua_State *L)
     //@RAIAN
 //    double weight = 0;
     CellIndex cellIndex;
+    if (graph) {
+        if (position == graph->end(row)) return 0;
+        lua_pushnumber(L, graph->getWeight(position));
+        return 1;
+    }
     if (it != CellNeighborhood::end()){
         cellIndex = it->first;
         double weight = CellNeighborhood::getWeight(cellIndex);
@@ -154,6 +229,14 @@ int luaNeighborhood::getWeight(lua_State *L)
 int luaNeighborhood::getNeighbor(lua_State *L)
 {
     CellIndex cellIndex;
+    if (graph) {
+        if (position != graph->end(row)) {
+            ((luaCell*)graph->getCell(position))->getReference(L);
+            return 1;
+        }
+        lua_pushnil(L);
+        return 1;
+    }
     if (it != CellNeighborhood::end()){
         cellIndex = it->first;
         luaCell *cell =(luaCell*) it->second; //dynamic_cast<luaCell*>(it->second);
@@ -164,6 +247,31 @@ int luaNeighborhood::getNeighbor(lua_State *L)
     return 1;
 }
 
+/// Gets all the luaNeighbor cells and their weights in a single call.
+/// no parameters
+/// return a table with the cells and a table with their weights
+int luaNeighborhood::getNeighborsAndWeights(lua_State *L)
+{
+    vector<Cell*> cells;
+    vector<double> weights;
+    getNeighbors(cells, weights);
+
+    int size = (int) cells.size();
+    lua_createtable(L, size, 0);
+    int cellsTable = lua_gettop(L);
+    lua_createtable(L, size, 0);
+    int weightsTable = lua_gettop(L);
+
+    for (int i = 0; i < size; i++)
+    {
+        ((luaCell*)cells[i])->getReference(L);
+        lua_rawseti(L, cellsTable, i + 1);
+        lua_pushnumber(L, weights[i]);
+        lua_rawseti(L, weightsTable, i + 1);
+    }
+    return 2;
+}
+
 
 /// Gets luaNeighbor identifier
 /// no parameters
@@ -185,6 +293,14 @@ int luaNeighborhood::setNeighWeight(lua_State *L) {
 	cellIndex.second = luaL_checknumber(L, -3);
 	cellIndex.first = luaL_checknumber(L, -4);
 
+	if (graph)
+	{
+		int pos = graph->find(row, cellIndex);
+		if (pos >= 0) graph->setWeight(pos, weight);
+		lua_pushboolean(L, pos >= 0);
+		return 1;
+	}
+
 	if (CellNeighborhood::empty()
 		|| CellNeighborhood::find(cellIndex) == CellNeighborhood::end())
 		lua_pushboolean(L, false);
@@ -206,6 +322,14 @@ int luaNeighborhood::getNeighWeight(lua_State *L) {
 	cellIndex.second = luaL_checknumber(L, -2);
 	cellIndex.first = luaL_checknumber(L, -3);
 
+	if (graph)
+	{
+		int pos = graph->find(row, cellIndex);
+		if (pos >= 0) lua_pushnumber(L, graph->getWeight(pos));
+		else lua_pushnil(L);
+		return 1;
+	}
+
 	if (CellNeighborhood::empty()
 		|| CellNeighborhood::find(cellIndex) == CellNeighborhood::end())
 	{
@@ -228,6 +352,14 @@ int luaNeighborhood::setCellWeight(lua_State *L) {
     double weight = luaL_checknumber(L, -1);
     luaCellIndex *cI = Luna<luaCellIndex>::check(L, -2);
     CellIndex cellIndex; cellIndex.first = cI->x; cellIndex.second = cI->y;
+    if (graph) {
+        int pos = graph->find(row, cellIndex);
+        if (pos >= 0) {
+            graph->setWeight(pos, weight);
+            return 0;
+        }
+        detach();
+    }
     CellNeighborhood::setWeight(cellIndex, weight);
     return 0;
 }
@@ -237,6 +369,10 @@ int luaNeighborhood::setCellWeight(lua_State *L) {
 int luaNeighborhood::setWeight(lua_State *L) {
     double weight = luaL_checknumber(L, -1);
     CellIndex cellIndex;
+    if (graph) {
+        if (position != graph->end(row)) graph->setWeight(position, weight);
+        return 0;
+    }
     if (it != CellNeighborhood::end()){
         cellIndex = it->first;
         CellNeighborhood::setWeight(cellIndex, weight);
@@ -248,6 +384,10 @@ int luaNeighborhood::setWeight(lua_State *L) {
 /// no parameters
 int luaNeighborhood::first(lua_State *)
 {
+    if (graph) {
+        position = graph->begin(row);
+        return 0;
+    }
     it = CellNeighborhood::begin();
     return 0;
 }
@@ -256,6 +396,10 @@ int luaNeighborhood::first(lua_State *)
 /// no parameters
 int luaNeighborhood::last(lua_State *)
 {
+    if (graph) {
+        position = graph->end(row) - 1;
+        return 0;
+    }
     it = CellNeighborhood::end();
     it--;
     return 0;
@@ -265,7 +409,8 @@ int luaNeighborhood::last(lua_State *)
 /// no parameters
 int luaNeighborhood::isFirst(lua_State *L)
 {
-    lua_pushboolean(L, it == CellNeighborhood::begin());
+    if (graph) lua_pushboolean(L, position == graph->begin(row));
+    else lua_pushboolean(L, it == CellNeighborhood::begin());
     return 1;
 }
 
@@ -273,7 +418,8 @@ int luaNeighborhood::isFirst(lua_State *L)
 /// no parameters
 int  luaNeighborhood::isLast(lua_State *L)
 {
-    lua_pushboolean(L, it == CellNeighborhood::end());
+    if (graph) lua_pushboolean(L, position == graph->end(row));
+    else lua_pushboolean(L, it == CellNeighborhood::end());
     return  1;
 }
 
@@ -288,6 +434,14 @@ int luaNeighborhood::isNeighbor(lua_State *L)
   CellIndex cellIndex;
   cellIndex.second = luaL_checknumber(L, -2);
   cellIndex.first = luaL_checknumber(L, -3);
+  if (graph) {
+      bool found = false;
+      for (int pos = graph->find(row, cellIndex); (pos >= 0) && (pos < graph->end(row))
+           && (graph->getIndex(pos) == cellIndex) && !found; pos++)
+          found = (graph->getCell(pos) == cell);
+      lua_pushboolean(L, found);
+      return 1;
+  }
   CellNeighborhood::iterator itAux;
   itAux = CellNeighborhood::begin();
   bool isneighbor = false;
@@ -307,6 +461,10 @@ int luaNeighborhood::isNeighbor(lua_State *L)
 /// no parameters
 int luaNeighborhood::next(lua_State *)
 {
+    if (graph) {
+        if (position != graph->end(row)) position++;
+        return 0;
+    }
     if (itNext){
         itNext = false;
         return 0;
@@ -323,6 +481,10 @@ int luaNeighborhood::next(lua_State *)
 /// no parameters
 int luaNeighborhood::previous(lua_State *)
 {
+    if (graph) {
+        if (position != graph->begin(row)) position--;
+        return 0;
+    }
     if (it != CellNeighborhood::begin()) it--;
     return 0;
 }
@@ -333,7 +495,13 @@ int luaNeighborhood::previous(lua_State *)
 int luaNeighborhood::getCoord(lua_State *L)
 {
     int x = 0, y = 0;
-    if (it != CellNeighborhood::end())
+    if (graph) {
+        if (position != graph->end(row)) {
+            x = graph->getIndex(position).first;
+            y = graph->getIndex(position).second;
+        }
+    }
+    else if (it != CellNeighborhood::end())
     {
         x = it->first.first;
         y = it->first.second;
@@ -346,13 +514,16 @@ int luaNeighborhood::getCoord(lua_State *L)
 /// Returns true if the Neighborhood is empty.
 /// no parameters
 int luaNeighborhood::isEmpty(lua_State *L) {
-    lua_pushboolean(L, CellNeighborhood::empty());
+    if (graph) lua_pushboolean(L, graph->size(row) == 0);
+    else lua_pushboolean(L, CellNeighborhood::empty());
     return 1;
 }
 
 /// Clears all the Neighborhood content
 /// no parameters
 int luaNeighborhood::clear(lua_State *L) {
+    graph.clear();
+    row = -1;
     CellNeighborhood::clear();
     return 0;
 }
@@ -360,7 +531,8 @@ int luaNeighborhood::clear(lua_State *L) {
 /// Returns the number of Neighbors cells in the Neighborhood
 /// no parameters
 int luaNeighborhood::size(lua_State *L) {
-    lua_pushnumber(L, CellNeighborhood::size());
+    if (graph) lua_pushnumber(L, graph->size(row));
+    else lua_pushnumber(L, CellNeighborhood::size());
     return 1;
 }
 
@@ -38,9 +38,11 @@ extern "C"
 #include "luaCellIndex.h"
 #include "luaCell.h"
 #include "neighborhood.h"
+#include "neighborhoodGraph.h"
 
 #include <QString>
 #include <QDataStream>
+#include <QSharedPointer>
 
 class luaCellularSpace;
 
@@ -58,6 +60,10 @@ class luaNeighborhood : public CellNeighborhood, public Reference<luaNeighborhoo
     // int ref; ///< The position of the object in the Lua stack
     bool itNext; ///< auxliary variable used to avoid iterator problems that occurs when the erase() method is called
 
+    QSharedPointer<NeighborhoodGraph> graph; ///< shared storage of the neighbors, when they were compacted
+    int row; ///< row of the graph that stores the neighbors
+    int position; ///< luaNeighborhood iterator when the neighbors are stored in the graph
+
     //@RODRIGO
     QString getAll(QDataStream& in, int obsId, QStringList& attribs);
     QString getChanges(QDataStream& in, int obsId, QStringList& attribs);
@@ -79,6 +85,21 @@ public:
     /// destructor
     ~luaNeighborhood(void);
 
+    /// Moves the neighbors to a row of a graph shared by the neighborhoods with the same name
+    /// \param graph is the shared graph, that already contains the neighbors in the row
+    /// \param row is the index of the row
+    void setGraph(QSharedPointer<NeighborhoodGraph> graph, int row);
+
+    /// Copies the neighbors back from the shared graph, keeping the iterator position.
+    /// It must be called before any change in the set of neighbors.
+    void detach();
+
+    /// Gets all the neighbors and their weights at once, without changing the iterator.
+    /// As it does not change the neighborhood, it can be called by several threads.
+    /// \param cells receives the neighbor cells, following the order of their coordinates
+    /// \param weights receives the weight of each neighbor
+    void getNeighbors(vector<Cell*>& cells, vector<double>& weights);
+
     /// Adds a new luaNeighbor cell to the luaNeighborhood
     /// parameters: cell.y, cell.x,  cell, weight
     int addNeighbor(lua_State *L);
@@ -117,6 +138,12 @@ public:
     /// no parameters
     int getNeighbor(lua_State *L);
 
+    /// Gets all the luaNeighbor cells and their weights in a single call,
+    /// without changing the Neighborhood iterator.
+    /// no parameters
+    /// return a table with the cells and a table with their weights, in the same order
+    int getNeighborsAndWeights(lua_State *L);
+
     /// Gets luaNeighbor identifier
     /// no parameters
     int getID(lua_State *L);
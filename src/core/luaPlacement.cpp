@@ -0,0 +1,251 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "luaPlacement.h"
+
+extern "C"
+{
+#include <lauxlib.h>
+}
+
+#include <cmath>
+#include <string>
+
+/// Raises the error message on the top of the stack through customError()
+static int raiseError(lua_State *L)
+{
+    lua_getglobal(L, "customError");
+    lua_insert(L, -2);
+    lua_call(L, 1, 0);
+    return 0;
+}
+
+luaPlacement::luaPlacement(lua_State *)
+{
+}
+
+luaPlacement::~luaPlacement(void)
+{
+}
+
+int luaPlacement::config(lua_State *L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    luaL_checktype(L, 2, LUA_TTABLE);
+
+    int size = (int) lua_rawlen(L, 1);
+
+    cells.assign(size, vector<int>());
+    xs.resize(size);
+    ys.resize(size);
+    grid.clear();
+    grid.reserve(size);
+
+    for (int i = 0; i < size; i++)
+    {
+        lua_rawgeti(L, 1, i + 1);
+        lua_rawgeti(L, 2, i + 1);
+        xs[i] = (int) lua_tonumber(L, -2);
+        ys[i] = (int) lua_tonumber(L, -1);
+        lua_pop(L, 2);
+
+        grid[key(xs[i], ys[i])] = i;
+    }
+
+    agentCell.clear();
+    agentPosition.clear();
+    freeSlots.clear();
+    slots.clear();
+    return 0;
+}
+
+// Agents are identified by the address of their tables. It is safe because the
+// table of Agents indexed by slots, kept in Lua, prevents the Agents within Cells
+// from being collected.
+int luaPlacement::enter(lua_State *L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    int cell = toCell(L, 2);
+    const void *agent = lua_topointer(L, 1);
+    int slot;
+
+    unordered_map<const void*, int>::iterator it = slots.find(agent);
+    if (it != slots.end())
+    {
+        slot = it->second;
+        remove(slot);
+    }
+    else if (!freeSlots.empty())
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        slots[agent] = slot;
+    }
+    else
+    {
+        slot = (int) agentCell.size();
+        agentCell.push_back(-1);
+        agentPosition.push_back(-1);
+        slots[agent] = slot;
+    }
+
+    agentCell[slot] = cell;
+    agentPosition[slot] = (int) cells[cell].size();
+    cells[cell].push_back(slot);
+
+    lua_pushinteger(L, slot + 1);
+    return 1;
+}
+
+int luaPlacement::leave(lua_State *L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    unordered_map<const void*, int>::iterator it = slots.find(lua_topointer(L, 1));
+    if (it == slots.end())
+        return 0;
+
+    int slot = it->second;
+    slots.erase(it);
+    remove(slot);
+    freeSlots.push_back(slot);
+
+    lua_pushinteger(L, slot + 1);
+    return 1;
+}
+
+int luaPlacement::size(lua_State *L)
+{
+    lua_pushinteger(L, (lua_Integer) cells[toCell(L, 1)].size());
+    return 1;
+}
+
+int luaPlacement::get(lua_State *L)
+{
+    const vector<int>& agents = cells[toCell(L, 1)];
+    lua_Integer position = (lua_Integer) luaL_checknumber(L, 2);
+
+    if (position < 1 || position > (lua_Integer) agents.size())
+        return 0;
+
+    lua_pushinteger(L, agents[position - 1] + 1);
+    return 1;
+}
+
+int luaPlacement::getAgents(lua_State *L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    int count = 0;
+
+    if (lua_type(L, 2) == LUA_TTABLE)
+    {
+        int size = (int) lua_rawlen(L, 2);
+
+        lua_createtable(L, size, 0);
+        for (int i = 1; i <= size; i++)
+        {
+            lua_rawgeti(L, 2, i);
+            int cell = toCell(L, -1);
+            lua_pop(L, 1);
+            pushAgents(L, 1, cell, count);
+        }
+    }
+    else
+    {
+        int cell = toCell(L, 2);
+
+        lua_createtable(L, (int) cells[cell].size(), 0);
+        pushAgents(L, 1, cell, count);
+    }
+
+    return 1;
+}
+
+int luaPlacement::radius(lua_State *L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    int cell = toCell(L, 2);
+    double distance = luaL_checknumber(L, 3);
+    int range = (int) floor(distance);
+    int count = 0;
+
+    lua_newtable(L);
+    for (int dx = -range; dx <= range; dx++)
+    {
+        for (int dy = -range; dy <= range; dy++)
+        {
+            if (dx * dx + dy * dy > distance * distance)
+                continue;
+
+            unordered_map<long long, int>::const_iterator it = grid.find(key(xs[cell] + dx, ys[cell] + dy));
+            if (it != grid.end())
+                pushAgents(L, 1, it->second, count);
+        }
+    }
+
+    return 1;
+}
+
+int luaPlacement::toCell(lua_State *L, int index) const
+{
+    lua_Integer cell = (lua_Integer) luaL_checknumber(L, index);
+
+    if (cell < 1 || cell > (lua_Integer) cells.size())
+    {
+        string msg = "Cell " + to_string((long long) cell) + " does not belong to the placement.";
+        lua_pushstring(L, msg.c_str());
+        raiseError(L);
+    }
+
+    return (int) cell - 1;
+}
+
+long long luaPlacement::key(int x, int y)
+{
+    return ((long long) x << 32) ^ (long long) (unsigned int) y;
+}
+
+void luaPlacement::remove(int slot)
+{
+    vector<int>& agents = cells[agentCell[slot]];
+    int position = agentPosition[slot];
+    int last = agents.back();
+
+    agents[position] = last;
+    agentPosition[last] = position;
+    agents.pop_back();
+
+    agentCell[slot] = -1;
+    agentPosition[slot] = -1;
+}
+
+void luaPlacement::pushAgents(lua_State *L, int agents, int cell, int& count) const
+{
+    const vector<int>& slotsOfCell = cells[cell];
+
+    for (size_t i = 0; i < slotsOfCell.size(); i++)
+    {
+        lua_rawgeti(L, agents, slotsOfCell[i] + 1);
+        lua_rawseti(L, -2, ++count);
+    }
+}
@@ -0,0 +1,131 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*!
+  \file luaPlacement.h
+  \brief This file contains definitions about the native index of placements:
+                 luaPlacement class.
+*/
+
+#ifndef LUA_PLACEMENT_H
+#define LUA_PLACEMENT_H
+
+extern "C"
+{
+#include <lua.h>
+}
+
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+#include "luna.h"
+
+/**
+ * \brief
+ *  Index of the relations between Agents and Cells of a placement created with
+ *  native = true. Cells are identified by their positions in the CellularSpace and
+ *  Agents by slots, which are allocated when they enter a Cell and released when
+ *  they leave it. The Agents of each Cell are stored in a contiguous array, and each
+ *  Agent knows its position in this array, therefore entering, leaving, and moving
+ *  do not depend on the number of Agents. Leaving a Cell moves its last Agent to the
+ *  position of the Agent that left.
+ *  The Agents themselves are stored by Lua in a table indexed by the slots, which
+ *  is given as argument to the functions that return Agents.
+ *
+ */
+class luaPlacement
+{
+public:
+    ///< Data structure issued by Luna<T>
+    static const char className[];
+
+    ///< Data structure issued by Luna<T>
+    static Luna<luaPlacement>::RegType methods[];
+
+    /// Constructor
+    luaPlacement(lua_State *L);
+
+    /// Destructor
+    ~luaPlacement(void);
+
+    /// Creates the Cells of the placement. Cells are indexed by their coordinates
+    /// in order to answer queries by distance.
+    /// parameters: table with the x of each Cell, table with the y of each Cell
+    int config(lua_State *L);
+
+    /// Puts an Agent into a Cell. If the Agent is already within a Cell, it is moved.
+    /// parameters: Agent, position of the Cell
+    /// return: the slot of the Agent
+    int enter(lua_State *L);
+
+    /// Removes an Agent from its Cell, releasing its slot
+    /// parameters: Agent
+    /// return: the released slot, or nil if the Agent does not belong to any Cell
+    int leave(lua_State *L);
+
+    /// Gets the number of Agents within a Cell
+    /// parameters: position of the Cell
+    int size(lua_State *L);
+
+    /// Gets the slot of an Agent within a Cell
+    /// parameters: position of the Cell, position of the Agent within the Cell
+    /// return: the slot, or nil if the position does not exist
+    int get(lua_State *L);
+
+    /// Gets the Agents within a set of Cells
+    /// parameters: table of Agents indexed by slots, position of a Cell or table with positions
+    /// return: a table with the Agents
+    int getAgents(lua_State *L);
+
+    /// Gets the Agents within the Cells whose Euclidean distance to a given Cell is less
+    /// than or equal to a given value, including the given Cell itself
+    /// parameters: table of Agents indexed by slots, position of the Cell, distance
+    /// return: a table with the Agents
+    int radius(lua_State *L);
+
+private:
+    /// Gets the position of a Cell from the Lua stack, or raises an error if it does not exist
+    int toCell(lua_State *L, int index) const;
+
+    /// Gets the key of a pair of coordinates in the spatial index
+    static long long key(int x, int y);
+
+    /// Removes the Agent of a slot from its Cell
+    void remove(int slot);
+
+    /// Appends the Agents of a Cell to the table on the top of the stack
+    void pushAgents(lua_State *L, int agents, int cell, int& count) const;
+
+    vector< vector<int> > cells; ///< slots of the Agents within each Cell
+    vector<int> xs; ///< x of each Cell
+    vector<int> ys; ///< y of each Cell
+    unordered_map<long long, int> grid; ///< position of the Cell of each pair of coordinates
+
+    vector<int> agentCell; ///< Cell of each slot, or -1 if the slot is free
+    vector<int> agentPosition; ///< position of each slot within the Agents of its Cell
+    vector<int> freeSlots;
+    unordered_map<const void*, int> slots; ///< slot of each Agent within a Cell
+};
+
+#endif
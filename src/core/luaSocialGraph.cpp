@@ -0,0 +1,382 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "luaSocialGraph.h"
+
+extern "C"
+{
+#include <lauxlib.h>
+}
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+/// Raises the error message on the top of the stack through customError()
+static int raiseError(lua_State *L)
+{
+    lua_getglobal(L, "customError");
+    lua_insert(L, -2);
+    lua_call(L, 1, 0);
+    return 0;
+}
+
+luaSocialGraph::luaSocialGraph(lua_State *)
+{
+    offsets.push_back(0);
+}
+
+luaSocialGraph::~luaSocialGraph(void)
+{
+}
+
+// Each row samples without replacement from the other Agents using the algorithm
+// of Floyd, therefore it does not depend on the number of Agents of the Society.
+int luaSocialGraph::quantity(lua_State *L)
+{
+    int agents = (int) luaL_checknumber(L, 1);
+    int quantity = (int) luaL_checknumber(L, 2);
+    generator.seed((unsigned int) luaL_checknumber(L, 3));
+
+    int candidates = agents - 1;
+    if (quantity > candidates)
+    {
+        string msg = "It is not possible to connect such amount of agents (" + to_string((long long) quantity)
+            + "). The Society only has " + to_string((long long) agents) + " agents.";
+        lua_pushstring(L, msg.c_str());
+        return raiseError(L);
+    }
+
+    reset(agents);
+    connections.reserve((size_t) agents * quantity);
+
+    vector<char> chosen(agents, 0);
+    for (int i = 0; i < agents; i++)
+    {
+        size_t first = connections.size();
+
+        for (int j = candidates - quantity; j < candidates; j++)
+        {
+            int candidate = uniform_int_distribution<int>(0, j)(generator);
+            if (chosen[candidate])
+                candidate = j;
+
+            chosen[candidate] = 1;
+            connections.push_back(candidate < i ? candidate : candidate + 1);
+        }
+
+        for (size_t j = first; j < connections.size(); j++)
+        {
+            int candidate = connections[j];
+            chosen[candidate < i ? candidate : candidate - 1] = 0;
+        }
+
+        offsets.push_back((int) connections.size());
+    }
+
+    return 0;
+}
+
+// Instead of drawing a number for each pair of Agents, each row draws the distance
+// to the next connected Agent from a geometric distribution.
+int luaSocialGraph::probability(lua_State *L)
+{
+    int agents = (int) luaL_checknumber(L, 1);
+    double probability = luaL_checknumber(L, 2);
+    generator.seed((unsigned int) luaL_checknumber(L, 3));
+
+    int candidates = agents - 1;
+    double logq = log(1 - probability);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    reset(agents);
+    connections.reserve((size_t) (agents * (candidates * probability + 1)));
+
+    for (int i = 0; i < agents; i++)
+    {
+        for (long long candidate = -1; ; )
+        {
+            if (probability >= 1)
+                candidate++;
+            else
+                candidate += 1 + (long long) floor(log(1 - uniform(generator)) / logq);
+
+            if (candidate >= candidates)
+                break;
+
+            connections.push_back(candidate < i ? (int) candidate : (int) candidate + 1);
+        }
+
+        offsets.push_back((int) connections.size());
+    }
+
+    return 0;
+}
+
+int luaSocialGraph::cell(lua_State *L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    bool self = lua_toboolean(L, 2) != 0;
+
+    vector<int> cellOfAgent, first, agentsOfCell;
+    toVector(L, 1, cellOfAgent);
+    int agents = (int) cellOfAgent.size();
+    group(cellOfAgent, first, agentsOfCell);
+
+    reset(agents);
+    for (int i = 0; i < agents; i++)
+    {
+        int cell = cellOfAgent[i];
+
+        if (cell >= 0)
+        {
+            for (int j = first[cell]; j < first[cell + 1]; j++)
+            {
+                if (agentsOfCell[j] != i || self)
+                    connections.push_back(agentsOfCell[j]);
+            }
+        }
+
+        offsets.push_back((int) connections.size());
+    }
+
+    return 0;
+}
+
+int luaSocialGraph::neighbor(lua_State *L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    luaL_checktype(L, 2, LUA_TTABLE);
+
+    vector<int> cellOfAgent, first, agentsOfCell;
+    toVector(L, 1, cellOfAgent);
+    int agents = (int) cellOfAgent.size();
+    group(cellOfAgent, first, agentsOfCell);
+    int cells = (int) first.size() - 1;
+
+    reset(agents);
+    for (int i = 0; i < agents; i++)
+    {
+        int cell = cellOfAgent[i];
+
+        if (cell >= 0)
+        {
+            lua_rawgeti(L, 2, cell + 1);
+            int size = lua_istable(L, -1) ? (int) lua_rawlen(L, -1) : 0;
+
+            for (int n = 1; n <= size; n++)
+            {
+                lua_rawgeti(L, -1, n);
+                int neighborCell = (int) lua_tonumber(L, -1) - 1;
+                lua_pop(L, 1);
+
+                if (neighborCell < 0 || neighborCell >= cells)
+                    continue;
+
+                for (int j = first[neighborCell]; j < first[neighborCell + 1]; j++)
+                    connections.push_back(agentsOfCell[j]);
+            }
+
+            lua_pop(L, 1);
+        }
+
+        offsets.push_back((int) connections.size());
+    }
+
+    return 0;
+}
+
+int luaSocialGraph::symmetrize(lua_State *)
+{
+    int rows = (int) offsets.size() - 1;
+    vector<int> sizes(rows + 1, 0);
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = offsets[i]; j < offsets[i + 1]; j++)
+        {
+            sizes[i + 1]++;
+            sizes[connections[j] + 1]++;
+        }
+    }
+
+    for (int i = 0; i < rows; i++)
+        sizes[i + 1] += sizes[i];
+
+    vector<int> position(sizes.begin(), sizes.end() - 1);
+    vector<int> both(sizes[rows]);
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = offsets[i]; j < offsets[i + 1]; j++)
+        {
+            both[position[i]++] = connections[j];
+            both[position[connections[j]]++] = i;
+        }
+    }
+
+    reset(rows);
+    for (int i = 0; i < rows; i++)
+    {
+        vector<int>::iterator begin = both.begin() + sizes[i];
+        vector<int>::iterator end = both.begin() + sizes[i + 1];
+
+        sort(begin, end);
+        connections.insert(connections.end(), begin, unique(begin, end));
+        offsets.push_back((int) connections.size());
+    }
+
+    return 0;
+}
+
+int luaSocialGraph::size(lua_State *L)
+{
+    int row = toRow(L, 1);
+
+    lua_pushinteger(L, offsets[row + 1] - offsets[row]);
+    return 1;
+}
+
+int luaSocialGraph::copy(lua_State *L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    int row = toRow(L, 2);
+    int size = offsets[row + 1] - offsets[row];
+
+    lua_createtable(L, 0, size);
+    int result = lua_gettop(L);
+    lua_createtable(L, 0, size);
+    int weights = lua_gettop(L);
+
+    for (int j = offsets[row]; j < offsets[row + 1]; j++)
+    {
+        lua_rawgeti(L, 1, connections[j] + 1);
+        lua_pushstring(L, "id");
+        lua_rawget(L, -2);
+
+        if (!lua_isnil(L, -1))
+        {
+            lua_pushvalue(L, -1);
+            lua_pushvalue(L, -3);
+            lua_settable(L, result);
+            lua_pushinteger(L, 1);
+            lua_settable(L, weights);
+        }
+        else
+        {
+            lua_pop(L, 1);
+        }
+
+        lua_pop(L, 1);
+    }
+
+    return 2;
+}
+
+int luaSocialGraph::forEachConnection(lua_State *L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    int row = toRow(L, 2);
+    luaL_checktype(L, 4, LUA_TFUNCTION);
+
+    for (int j = offsets[row]; j < offsets[row + 1]; j++)
+    {
+        lua_pushvalue(L, 4);
+        lua_pushvalue(L, 3);
+        lua_rawgeti(L, 1, connections[j] + 1);
+        lua_pushinteger(L, 1);
+        lua_call(L, 3, 1);
+
+        if (lua_isboolean(L, -1) && !lua_toboolean(L, -1))
+        {
+            lua_pushboolean(L, 0);
+            return 1;
+        }
+
+        lua_pop(L, 1);
+    }
+
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+int luaSocialGraph::toRow(lua_State *L, int index) const
+{
+    lua_Integer row = (lua_Integer) luaL_checknumber(L, index);
+
+    if (row < 1 || row >= (lua_Integer) offsets.size())
+    {
+        string msg = "Row " + to_string((long long) row) + " does not belong to the SocialNetwork.";
+        lua_pushstring(L, msg.c_str());
+        raiseError(L);
+    }
+
+    return (int) row - 1;
+}
+
+void luaSocialGraph::toVector(lua_State *L, int index, vector<int>& values)
+{
+    int size = (int) lua_rawlen(L, index);
+
+    values.resize(size);
+    for (int i = 0; i < size; i++)
+    {
+        lua_rawgeti(L, index, i + 1);
+        values[i] = (int) lua_tonumber(L, -1) - 1;
+        lua_pop(L, 1);
+    }
+}
+
+void luaSocialGraph::group(const vector<int>& cellOfAgent, vector<int>& first, vector<int>& agentsOfCell) const
+{
+    int cells = 0;
+    for (size_t i = 0; i < cellOfAgent.size(); i++)
+        cells = max(cells, cellOfAgent[i] + 1);
+
+    first.assign(cells + 1, 0);
+    for (size_t i = 0; i < cellOfAgent.size(); i++)
+    {
+        if (cellOfAgent[i] >= 0)
+            first[cellOfAgent[i] + 1]++;
+    }
+
+    for (int i = 0; i < cells; i++)
+        first[i + 1] += first[i];
+
+    vector<int> position(first.begin(), first.end() - 1);
+    agentsOfCell.resize(first[cells]);
+
+    for (size_t i = 0; i < cellOfAgent.size(); i++)
+    {
+        if (cellOfAgent[i] >= 0)
+            agentsOfCell[position[cellOfAgent[i]]++] = (int) i;
+    }
+}
+
+void luaSocialGraph::reset(int rows)
+{
+    offsets.clear();
+    offsets.reserve(rows + 1);
+    offsets.push_back(0);
+    connections.clear();
+}
@@ -0,0 +1,126 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*!
+  \file luaSocialGraph.h
+  \brief This file contains definitions about the native storage of the SocialNetworks
+                 of a Society: luaSocialGraph class.
+*/
+
+#ifndef LUA_SOCIAL_GRAPH_H
+#define LUA_SOCIAL_GRAPH_H
+
+extern "C"
+{
+#include <lua.h>
+}
+
+#include <random>
+#include <vector>
+using namespace std;
+
+#include "luna.h"
+
+/**
+ * \brief
+ *  Compressed sparse row (CSR) storage for the SocialNetworks with the same name of all
+ *  the Agents of a Society, created with native = true. The connections of the i-th row
+ *  are stored from offsets[i] to offsets[i + 1] - 1 in the array of connections. Each
+ *  connection is the position of an Agent in the table of Agents kept by Lua, which is
+ *  given as argument to the functions that return Agents. All the connections have
+ *  weight one. The graph does not change after being built; SocialNetworks that are
+ *  changed by the modeler are copied back to Lua.
+ *
+ */
+class luaSocialGraph
+{
+public:
+    ///< Data structure issued by Luna<T>
+    static const char className[];
+
+    ///< Data structure issued by Luna<T>
+    static Luna<luaSocialGraph>::RegType methods[];
+
+    /// Constructor
+    luaSocialGraph(lua_State *L);
+
+    /// Destructor
+    ~luaSocialGraph(void);
+
+    /// Connects each Agent to a given number of other Agents randomly taken
+    /// parameters: number of Agents, number of connections, seed
+    int quantity(lua_State *L);
+
+    /// Connects each pair of Agents with a given probability, excluding the Agent itself
+    /// parameters: number of Agents, probability, seed
+    int probability(lua_State *L);
+
+    /// Connects each Agent to the Agents within the same Cell
+    /// parameters: table with the position of the Cell of each Agent (zero if the Agent
+    /// is not within any Cell), boolean indicating whether the Agent is connected to itself
+    int cell(lua_State *L);
+
+    /// Connects each Agent to the Agents within the neighbors of its Cell
+    /// parameters: table with the position of the Cell of each Agent (zero if the Agent
+    /// is not within any Cell), table with the positions of the neighbors of each Cell
+    int neighbor(lua_State *L);
+
+    /// Adds the connection from b to a for each connection from a to b
+    int symmetrize(lua_State *L);
+
+    /// Gets the number of connections of a row
+    /// parameters: row
+    int size(lua_State *L);
+
+    /// Copies a row to the tables of a SocialNetwork
+    /// parameters: table of Agents, row
+    /// return: table of connections and table of weights, both indexed by the id of the Agents
+    int copy(lua_State *L);
+
+    /// Calls a function for each connection of a row, stopping if it returns false
+    /// parameters: table of Agents, row, Agent that owns the row, function
+    /// return: false if the function returned false, true otherwise
+    int forEachConnection(lua_State *L);
+
+private:
+    /// Gets a row from the Lua stack, or raises an error if it does not exist
+    int toRow(lua_State *L, int index) const;
+
+    /// Reads a table of positions, converting them to zero-based values
+    static void toVector(lua_State *L, int index, vector<int>& values);
+
+    /// Groups the Agents by the Cells they belong
+    /// \param cellOfAgent is the Cell of each Agent, or -1
+    /// \param first receives the position of the first Agent of each Cell in agentsOfCell
+    /// \param agentsOfCell receives the Agents of each Cell, one Cell after the other
+    void group(const vector<int>& cellOfAgent, vector<int>& first, vector<int>& agentsOfCell) const;
+
+    /// Removes all the connections, reserving memory for a given number of rows
+    void reset(int rows);
+
+    vector<int> offsets; ///< position of the first connection of each row
+    vector<int> connections; ///< position of each connection in the table of Agents
+    mt19937 generator;
+};
+
+#endif
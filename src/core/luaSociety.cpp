@@ -35,6 +35,7 @@ of this software and its documentation.
 #include "../observer/types/observerLogFile.h"
 #include "../observer/types/observerTable.h"
 #include "../observer/types/observerUDPSender.h"
+#include "../observer/types/observerTCPSender.h"
 #include "../observer/types/agentObserverMap.h"
 #include "luaUtils.h"
 #include "terrameGlobals.h"
@@ -243,6 +244,7 @@ int luaSociety::createObserver(lua_State *)
         ObserverGraphic *obsGraphic = 0;
         ObserverLogFile *obsLog = 0;
         ObserverUDPSender *obsUDPSender = 0;
+        ObserverTCPSender *obsTCPSender = 0;
 
         int obsId = -1;
 
@@ -337,6 +339,24 @@ int luaSociety::createObserver(lua_State *)
             }
             break;
 
+        case TObsTCPSender:
+            obsTCPSender =(ObserverTCPSender *)
+                    SocietySubjectInterf::createObserver(TObsTCPSender);
+            if (obsTCPSender)
+            {
+                obsId = obsTCPSender->getId();
+                obsTCPSender->setCompress(compressDatagram);
+
+                if (obsVisible)
+                    obsTCPSender->show();
+            }
+            else
+            {
+                if (execModes != Quiet)
+                    qWarning("%s", qPrintable(TerraMEObserver::MEMORY_ALLOC_FAILED));
+            }
+            break;
+
         case TObsMap:
         default:
             if (execModes != Quiet)
@@ -351,11 +371,19 @@ int luaSociety::createObserver(lua_State *)
 
         if (obsLog)
         {
+            changes.attach(obsId);
             obsLog->setAttributes(obsAttribs);
             obsLog->setFileName(cols.at(0));
             obsLog->setSeparator(cols.at(1));
 			obsLog->setWriteMode(cols.at(2));
 
+            if (cols.size() > 5)
+            {
+                obsLog->setBufferSize(cols.at(3).toInt());
+                obsLog->setFlushInterval(cols.at(4).toDouble());
+                obsLog->setFormat(cols.at(5), cols.size() > 6 && cols.at(6) == "true");
+            }
+
             lua_pushnumber(luaL, obsId);
             lua_pushlightuserdata(luaL, (void*) obsLog);
 
@@ -364,6 +392,7 @@ int luaSociety::createObserver(lua_State *)
 
         if (obsText)
         {
+            changes.attach(obsId);
             obsText->setAttributes(obsAttribs);
             lua_pushnumber(luaL, obsId);
             lua_pushlightuserdata(luaL, (void*) obsText);
@@ -373,6 +402,7 @@ int luaSociety::createObserver(lua_State *)
 
         if (obsTable)
         {
+            changes.attach(obsId);
             obsTable->setColumnHeaders(cols);
             obsTable->setAttributes(obsAttribs);
 
@@ -426,6 +456,23 @@ int luaSociety::createObserver(lua_State *)
             return 2;
         }
 
+        if (obsTCPSender)
+        {
+            obsTCPSender->setAttributes(obsAttribs);
+            obsTCPSender->setPort(cols.at(0).toInt());
+
+            for (int i = 1; i < cols.size(); i++)
+            {
+                if (!cols.at(i).isEmpty())
+                    obsTCPSender->addHost(cols.at(i));
+            }
+
+            lua_pushnumber(luaL, obsId);
+            lua_pushlightuserdata(luaL, (void*) obsTCPSender);
+
+            return 2;
+        }
+
     return 0;
 }
 
@@ -575,7 +622,7 @@ QString luaSociety::pop(lua_State *luaL, QStringList& attribs)
 
 QString luaSociety::getChanges(QDataStream& in, int observerId, QStringList& attribs)
 {
-    return getAll(in, observerId, attribs);
+    return changes.filter(getAll(in, observerId, attribs), SocietySubjectInterf::getObserversCount());
 }
 
 #ifdef TME_BLACK_BOARD
@@ -585,33 +632,15 @@ QDataStream& luaSociety::getState(QDataStream& in, Subject *, int observerId, QS
 #endif
 
 {
-    int obsCurrentState = 0; //serverSession->getState(observerId);
     QString content;
 
-    switch (obsCurrentState)
-    {
-    case 0:
 #ifdef TME_BLACK_BOARD
-        content = getAll(in, observerId, observedAttribs);
+    // the BlackBoard builds one state for all the observers at each notify
+    content = getChanges(in, observerId, observedAttribs);
 #else
-        content = getAll(in, observerId, attribs);
+    content = getAll(in, observerId, attribs);
 #endif
-        // serverSession->setState(observerId, 1);
-        // if (execModes == Quiet)
-        // qWarning(QString("Observer %1 passou ao estado %2").arg(observerId).arg(1).toAscii().constData());
-        break;
 
-    case 1:
-#ifdef TME_BLACK_BOARD
-        content = getChanges(in, observerId, observedAttribs);
-#else
-        content = getChanges(in, observerId, attribs);
-#endif
-        // serverSession->setState(observerId, 0);
-        // if (execModes == Quiet)
-        // qWarning(QString("Observer %1 passou ao estado %2").arg(observerId).arg(0).toAscii().constData());
-        break;
-    }
     // cleans the stack
     // lua_settop(L, 0);
 
@@ -624,6 +653,7 @@ int luaSociety::kill(lua_State *luaL)
     int id = luaL_checknumber(luaL, 1);
 
     bool result = SocietySubjectInterf::kill(id);
+    changes.detach(id);
     lua_pushboolean(luaL, result);
     return 1;
 }
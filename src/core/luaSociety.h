@@ -37,6 +37,7 @@ extern "C"
 }
 #include "luna.h"
 #include "reference.h"
+#include "stateChanges.h"
 
 /**
 * \brief 
@@ -60,7 +61,12 @@ class luaSociety : public SocietySubjectInterf, public Reference<luaSociety>
 
     QString attrNeighName;
 
+    StateChanges changes; ///< last state sent to the observers
+
     QString getAll(QDataStream& in, int obsId, QStringList& attribs);
+
+    /// Gets the attributes that changed since the last state, if every observer keeps
+    /// the values it received. Otherwise, gets every attribute
     QString getChanges(QDataStream& in, int obsId, QStringList& attribs);
 
 public:
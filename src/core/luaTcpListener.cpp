@@ -0,0 +1,134 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "luaTcpListener.h"
+
+extern "C"
+{
+#include <lauxlib.h>
+}
+
+#include <QtEndian>
+
+#include "observerTCPSender.h"
+
+luaTcpListener::luaTcpListener(lua_State *)
+{
+    socket = 0;
+}
+
+luaTcpListener::~luaTcpListener(void)
+{
+    if (socket)
+        socket->abort();
+
+    server.close();
+}
+
+int luaTcpListener::listen(lua_State *L)
+{
+    int port = (int) luaL_checkinteger(L, 1);
+
+    lua_pushboolean(L, server.listen(QHostAddress::Any, (quint16) port));
+    return 1;
+}
+
+bool luaTcpListener::read(char *data, qint64 size, int timeout)
+{
+    qint64 received = 0;
+
+    while (received < size)
+    {
+        if (socket->bytesAvailable() == 0 && !socket->waitForReadyRead(timeout))
+            return false;
+
+        qint64 count = socket->read(data + received, size - received);
+        if (count < 0)
+            return false;
+
+        received += count;
+    }
+    return true;
+}
+
+int luaTcpListener::receive(lua_State *L)
+{
+    int timeout = (int) luaL_checkinteger(L, 1);
+
+    lua_newtable(L);
+
+    if (!socket)
+    {
+        if (!server.waitForNewConnection(timeout))
+            return 1;
+
+        socket = server.nextPendingConnection();
+    }
+
+    int position = 1;
+    bool finished = false;
+
+    while (!finished)
+    {
+        uchar header[5];
+        if (!read((char *) header, 5, timeout))
+            break;
+
+        quint32 size = qFromBigEndian<quint32>(header);
+        quint8 flags = header[4];
+
+        if (size == 0)
+            break;
+
+        QByteArray data((int) size - 1, 0);
+        if (size > 1 && !read(data.data(), size - 1, timeout))
+            break;
+
+        bool compressed = (flags & TCP_FRAME_COMPRESSED) != 0;
+        finished = (flags & TCP_FRAME_END) != 0;
+
+        if (compressed)
+            data = qUncompress(data);
+
+        lua_newtable(L);
+
+        lua_pushnumber(L, size);
+        lua_setfield(L, -2, "size");
+
+        lua_pushboolean(L, compressed);
+        lua_setfield(L, -2, "compressed");
+
+        lua_pushboolean(L, finished);
+        lua_setfield(L, -2, "finished");
+
+        if (!compressed || !data.isEmpty())
+        {
+            lua_pushlstring(L, data.constData(), data.size());
+            lua_setfield(L, -2, "data");
+        }
+
+        lua_rawseti(L, -2, position++);
+    }
+
+    return 1;
+}
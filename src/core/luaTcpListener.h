@@ -0,0 +1,86 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*!
+  \file luaTcpListener.h
+  \brief This file contains definitions about the reception of the frames sent by
+                 InternetSender using TCP: luaTcpListener class.
+*/
+
+#ifndef LUA_TCP_LISTENER_H
+#define LUA_TCP_LISTENER_H
+
+extern "C"
+{
+#include <lua.h>
+}
+
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+#include "luna.h"
+
+/**
+ * \brief
+ *  Receives the frames written by an ObserverTCPSender in a local port. Each frame
+ *  starts with its size as a 32-bit big-endian number (the flags plus the payload),
+ *  followed by one byte of flags and the payload. The payload of compressed frames is
+ *  uncompressed before being returned to Lua.
+ *
+ */
+class luaTcpListener
+{
+public:
+    ///< Data structure issued by Luna<T>
+    static const char className[];
+
+    ///< Data structure issued by Luna<T>
+    static Luna<luaTcpListener>::RegType methods[];
+
+    /// Constructor
+    luaTcpListener(lua_State *L);
+
+    /// Destructor
+    ~luaTcpListener(void);
+
+    /// Starts listening to a port in all the network interfaces
+    /// parameters: port
+    /// return: true if the port could be opened, false otherwise
+    int listen(lua_State *L);
+
+    /// Reads the frames of the first connection, until the end of the simulation,
+    /// the connection is closed, or nothing arrives within a given time
+    /// parameters: time to wait, in milliseconds
+    /// return: table of frames, each one with size, compressed, finished, and data.
+    /// data is nil if a compressed payload could not be uncompressed
+    int receive(lua_State *L);
+
+private:
+    /// Reads a given number of bytes, waiting for them if necessary
+    bool read(char *data, qint64 size, int timeout);
+
+    QTcpServer server;
+    QTcpSocket *socket;
+};
+
+#endif // LUA_TCP_LISTENER_H
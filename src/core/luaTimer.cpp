@@ -48,6 +48,8 @@ luaTimer::luaTimer(lua_State *L)
 /// Desctructor
 luaTimer::~luaTimer(void)
 {
+    // the queued Events are collected with the table of the Timer
+    events.clear();
 }
 
 /// Executes the luaTimer object
@@ -90,6 +92,112 @@ int luaTimer::reset(lua_State *)
     return 0;
 }
 
+/// Inserts a Lua Event in the queue of the Timer. Events with the same time and
+/// priority are executed in the order they were inserted.
+/// parameters: Event, time, priority
+int luaTimer::schedule(lua_State *L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    double time = luaL_checknumber(L, 2);
+    double priority = luaL_checknumber(L, 3);
+
+    pushQueue(L);
+    lua_pushvalue(L, 1);
+    events.push(time, priority, luaL_ref(L, -2));
+    lua_pop(L, 1);
+    return 0;
+}
+
+/// Gets the Lua Event on the head of the queue, or nil if it is empty
+int luaTimer::getFirst(lua_State *L)
+{
+    if (events.empty())
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    pushQueue(L);
+    lua_rawgeti(L, -1, events.top());
+    lua_remove(L, -2);
+    return 1;
+}
+
+/// Removes the Lua Event on the head of the queue and returns it
+int luaTimer::removeFirst(lua_State *L)
+{
+    if (events.empty())
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    int ref = events.top();
+    events.pop();
+
+    pushQueue(L);
+    lua_rawgeti(L, -1, ref);
+    luaL_unref(L, -2, ref);
+    lua_remove(L, -2);
+    return 1;
+}
+
+/// Gets a vector with the Lua Events in the order they will be executed
+int luaTimer::getEvents(lua_State *L)
+{
+    vector<int> refs;
+    events.sorted(refs);
+
+    pushQueue(L);
+    int queue = lua_gettop(L);
+
+    lua_createtable(L, (int) refs.size(), 0);
+    for (size_t i = 0; i < refs.size(); i++)
+    {
+        lua_rawgeti(L, queue, refs[i]);
+        lua_rawseti(L, -2, (int) i + 1);
+    }
+    lua_remove(L, queue);
+    return 1;
+}
+
+/// Removes all the Lua Events from the queue
+int luaTimer::clear(lua_State *L)
+{
+    events.clear();
+
+    Reference<luaTimer>::getReference(L);
+    lua_pushstring(L, "queue_");
+    lua_pushnil(L);
+    lua_rawset(L, -3);
+    lua_pop(L, 1);
+    return 0;
+}
+
+/// Gets the number of Lua Events in the queue
+int luaTimer::size(lua_State *L)
+{
+    lua_pushnumber(L, events.size());
+    return 1;
+}
+
+void luaTimer::pushQueue(lua_State *L)
+{
+    Reference<luaTimer>::getReference(L);
+    lua_pushstring(L, "queue_");
+    lua_rawget(L, -2);
+
+    if (!lua_istable(L, -1))
+    {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushstring(L, "queue_");
+        lua_pushvalue(L, -2);
+        lua_rawset(L, -4);
+    }
+    lua_remove(L, -2);
+}
+
 int luaTimer::createObserver(lua_State *luaL)
 {
     // recupero a referencia da celula
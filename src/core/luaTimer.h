@@ -32,6 +32,7 @@ of this software and its documentation.
 #include "luaUtils.h"
 #include "reference.h"
 #include "observerScheduler.h"
+#include "eventQueue.h"
 
 /**
 * \brief  
@@ -51,6 +52,13 @@ private:
 
     ObserverScheduler *obs;
 
+    EventQueue<int> events; ///< keys of the Lua Events in the queue_ table of the Timer
+
+    /// Pushes the table of the Timer that keeps the queued Lua Events, creating it if
+    /// necessary. The Events refer to the Timer as their parent, therefore they are kept
+    /// by the Timer itself instead of the registry, so that both can be collected.
+    void pushQueue(lua_State *L);
+
 public:
     ///< Data structure issued by Luna<T>
     static const char className[];
@@ -82,6 +90,25 @@ public:
     /// Resets the luaTimer
     int reset(lua_State* L);
 
+    /// Inserts a Lua Event in the queue of the Timer
+    /// parameters: Event, time, priority
+    int schedule(lua_State *L);
+
+    /// Gets the Lua Event on the head of the queue, or nil if it is empty
+    int getFirst(lua_State *L);
+
+    /// Removes the Lua Event on the head of the queue and returns it
+    int removeFirst(lua_State *L);
+
+    /// Gets a vector with the Lua Events in the order they will be executed
+    int getEvents(lua_State *L);
+
+    /// Removes all the Lua Events from the queue
+    int clear(lua_State *L);
+
+    /// Gets the number of Lua Events in the queue
+    int size(lua_State *L);
+
     /// Creates several types of observers to the luaCellularSpace object
     /// parameters: observer type, observeb attributes table, observer type parameters
     int createObserver(lua_State *L);
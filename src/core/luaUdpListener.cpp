@@ -0,0 +1,111 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "luaUdpListener.h"
+
+extern "C"
+{
+#include <lauxlib.h>
+}
+
+luaUdpListener::luaUdpListener(lua_State *)
+{
+}
+
+luaUdpListener::~luaUdpListener(void)
+{
+    socket.abort();
+}
+
+int luaUdpListener::listen(lua_State *L)
+{
+    int port = (int) luaL_checkinteger(L, 1);
+
+    lua_pushboolean(L, socket.bind(QHostAddress::Any, (quint16) port));
+    return 1;
+}
+
+int luaUdpListener::receive(lua_State *L)
+{
+    int timeout = (int) luaL_checkinteger(L, 1);
+    int quantity = (int) luaL_optinteger(L, 2, 0);
+
+    lua_newtable(L);
+
+    int position = 1;
+    bool finished = false;
+
+    while (!finished && ((quantity <= 0) || (position <= quantity)))
+    {
+        if (!socket.hasPendingDatagrams() && !socket.waitForReadyRead(timeout))
+            break;
+
+        while (!finished && socket.hasPendingDatagrams()
+               && ((quantity <= 0) || (position <= quantity)))
+        {
+            QByteArray datagram;
+            datagram.resize(socket.pendingDatagramSize());
+            socket.readDatagram(datagram.data(), datagram.size());
+
+            QByteArray data;
+            quint8 flags = 0;
+
+            if (!assembler.add(datagram, data, flags))
+                continue;
+
+            int size = data.size();
+            bool compressed = (flags & TerraMEObserver::UDP_FRAME_COMPRESSED) != 0;
+            finished = (flags & TerraMEObserver::UDP_FRAME_END) != 0;
+
+            if (compressed)
+                data = qUncompress(data);
+
+            lua_newtable(L);
+
+            lua_pushinteger(L, size);
+            lua_setfield(L, -2, "size");
+
+            lua_pushboolean(L, compressed);
+            lua_setfield(L, -2, "compressed");
+
+            lua_pushboolean(L, finished);
+            lua_setfield(L, -2, "finished");
+
+            if (!compressed || !data.isEmpty())
+            {
+                lua_pushlstring(L, data.constData(), data.size());
+                lua_setfield(L, -2, "data");
+            }
+
+            lua_rawseti(L, -2, position++);
+        }
+    }
+
+    return 1;
+}
+
+int luaUdpListener::lost(lua_State *L)
+{
+    lua_pushinteger(L, assembler.lost());
+    return 1;
+}
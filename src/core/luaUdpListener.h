@@ -0,0 +1,87 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*!
+  \file luaUdpListener.h
+  \brief This file contains definitions about the reception of the frames sent by
+                 InternetSender using UDP: luaUdpListener class.
+*/
+
+#ifndef LUA_UDP_LISTENER_H
+#define LUA_UDP_LISTENER_H
+
+extern "C"
+{
+#include <lua.h>
+}
+
+#include <QtNetwork/QUdpSocket>
+
+#include "luna.h"
+#include "udpFrame.h"
+
+/**
+ * \brief
+ *  Receives the frames sent by an ObserverUDPSender in a local port. The chunks of
+ *  each frame are reassembled by an UdpFrameAssembler, therefore the frames are
+ *  returned in order and the older frames completed late are discarded. The content
+ *  of compressed frames is uncompressed before being returned to Lua.
+ *
+ */
+class luaUdpListener
+{
+public:
+    ///< Data structure issued by Luna<T>
+    static const char className[];
+
+    ///< Data structure issued by Luna<T>
+    static Luna<luaUdpListener>::RegType methods[];
+
+    /// Constructor
+    luaUdpListener(lua_State *L);
+
+    /// Destructor
+    ~luaUdpListener(void);
+
+    /// Starts listening to a port in all the network interfaces
+    /// parameters: port
+    /// return: true if the port could be opened, false otherwise
+    int listen(lua_State *L);
+
+    /// Reads the frames until the end of the simulation, a given number of frames,
+    /// or nothing arrives within a given time
+    /// parameters: time to wait, in milliseconds, maximum number of frames (optional)
+    /// return: table of frames, each one with size, compressed, finished, and data.
+    /// data is nil if a compressed frame could not be uncompressed
+    int receive(lua_State *L);
+
+    /// Gets the number of frames discarded without all their chunks
+    /// return: the number of frames
+    int lost(lua_State *L);
+
+private:
+    QUdpSocket socket;
+    TerraMEObserver::UdpFrameAssembler assembler;
+};
+
+#endif // LUA_UDP_LISTENER_H
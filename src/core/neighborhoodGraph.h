@@ -0,0 +1,173 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*!
+  \file neighborhoodGraph.h
+  \brief This file contains definitions about the compressed storage of the neighborhoods of a
+                 CellularSpace: NeighborhoodGraph class.
+*/
+
+#ifndef NEIGHBORHOOD_GRAPH_H
+#define NEIGHBORHOOD_GRAPH_H
+
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+#include <QHash>
+
+#include "neighborhood.h"
+
+/**
+ * \brief
+ *  Compressed sparse row (CSR) storage for the neighborhoods with the same name of all the
+ *  cells of a CellularSpace. The neighbors of the i-th row are stored from offsets[i] to
+ *  offsets[i + 1] - 1 in the arrays of neighbors and weights, following the order of their
+ *  coordinates, as in the CellNeighborhood composite. Each neighbor is the position of a
+ *  cell in the array of nodes.
+ *
+ */
+class NeighborhoodGraph
+{
+public:
+    /// Constructor
+    NeighborhoodGraph() { offsets.push_back(0); }
+
+    /// Appends the neighbors of a CellNeighborhood as a new row.
+    /// \param neighborhood is the neighborhood being copied
+    /// \return the index of the row
+    int addRow(CellNeighborhood& neighborhood)
+    {
+        CellNeighborhood::iterator theIterator = neighborhood.begin();
+        while (theIterator != neighborhood.end())
+        {
+            CellIndex indx = theIterator->first;
+
+            neighbors.push_back(addNode(indx, theIterator->second));
+            weights.push_back(neighborhood.getWeight(indx));
+            theIterator++;
+        }
+
+        offsets.push_back((int) neighbors.size());
+        return (int) offsets.size() - 2;
+    }
+
+    /// Appends rows whose neighbors are already positions in the array of nodes
+    /// \param sizes is the number of neighbors of each row
+    /// \param rowNeighbors is the position of each neighbor in the array of nodes
+    /// \param rowWeights is the weight of each neighbor
+    void addRows(const vector<int>& sizes, const vector<int>& rowNeighbors,
+                 const vector<double>& rowWeights)
+    {
+        neighbors.insert(neighbors.end(), rowNeighbors.begin(), rowNeighbors.end());
+        weights.insert(weights.end(), rowWeights.begin(), rowWeights.end());
+
+        for (size_t i = 0; i < sizes.size(); i++)
+            offsets.push_back(offsets.back() + sizes[i]);
+    }
+
+    /// Gets the position of a cell in the array of nodes, adding it if necessary
+    /// \param indx is the coordinate of the cell
+    /// \param cell is a pointer to the cell
+    int addNode(const CellIndex& indx, Cell* cell)
+    {
+        QHash<Cell*, int>::const_iterator it = nodesIndex.constFind(cell);
+        if (it != nodesIndex.constEnd())
+            return it.value();
+
+        nodes.push_back(cell);
+        indexes.push_back(indx);
+        nodesIndex.insert(cell, (int) nodes.size() - 1);
+        return (int) nodes.size() - 1;
+    }
+
+    /// Copies a row to a CellNeighborhood
+    /// \param row is the index of the row
+    /// \param neighborhood is the neighborhood that receives the neighbors
+    void copyRow(int row, CellNeighborhood& neighborhood)
+    {
+        for (int pos = begin(row); pos < end(row); pos++)
+        {
+            CellIndex indx = getIndex(pos);
+            neighborhood.add(indx, getCell(pos), weights[pos]);
+        }
+    }
+
+    /// Gets the position of the first neighbor of a row
+    int begin(int row) const { return offsets[row]; }
+
+    /// Gets the position after the last neighbor of a row
+    int end(int row) const { return offsets[row + 1]; }
+
+    /// Gets the number of neighbors of a row
+    int size(int row) const { return offsets[row + 1] - offsets[row]; }
+
+    /// Gets the cell of a neighbor
+    /// \param pos is the position of the neighbor
+    Cell* getCell(int pos) const { return nodes[neighbors[pos]]; }
+
+    /// Gets the coordinate of a neighbor
+    /// \param pos is the position of the neighbor
+    const CellIndex& getIndex(int pos) const { return indexes[neighbors[pos]]; }
+
+    /// Gets the weight of a neighbor
+    /// \param pos is the position of the neighbor
+    double getWeight(int pos) const { return weights[pos]; }
+
+    /// Sets the weight of a neighbor
+    /// \param pos is the position of the neighbor
+    /// \param weight is a double number
+    void setWeight(int pos, double weight) { weights[pos] = weight; }
+
+    /// Searches for the first neighbor of a row with a given coordinate
+    /// \param row is the index of the row
+    /// \param indx is the coordinate of the neighbor
+    /// \return the position of the neighbor or -1 if it does not belong to the row
+    int find(int row, const CellIndex& indx) const
+    {
+        int first = begin(row), last = end(row);
+
+        while (first < last)
+        {
+            int middle = first + (last - first) / 2;
+            if (getIndex(middle) < indx)
+                first = middle + 1;
+            else
+                last = middle;
+        }
+
+        if ((first < end(row)) && (getIndex(first) == indx))
+            return first;
+        return -1;
+    }
+
+private:
+    vector<int> offsets; ///< position of the first neighbor of each row
+    vector<int> neighbors; ///< position of each neighbor in the array of nodes
+    vector<double> weights; ///< weight of each neighbor
+    vector<Cell*> nodes; ///< the cells that are neighbors of some row
+    vector<CellIndex> indexes; ///< the coordinate of each node
+    QHash<Cell*, int> nodesIndex; ///< position of each cell in the array of nodes
+};
+
+#endif
@@ -0,0 +1,389 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "parallelForEachCell.h"
+#include "luaCell.h"
+#include "luaCellularSpace.h"
+#include "luaNeighborhood.h"
+
+extern "C"
+{
+#include <lauxlib.h>
+#include <lualib.h>
+}
+
+#include <algorithm>
+#include <thread>
+
+#if LUA_VERSION_NUM < 502
+#define LUA_OK 0
+#endif
+
+/// Name of the metatable of the cell proxies within the worker lua_States
+static const char CELL_PROXY[] = "TeParallelCell";
+
+/// A cell as seen by the function executed in parallel
+struct CellProxy
+{
+    luaCellularSpace *store;
+    luaCell *cell;
+    int slot;
+    bool past; ///< true for the past of the cell and for its neighbors, which are read-only
+};
+
+static void pushCellProxy(lua_State *L, luaCellularSpace *store, luaCell *cell, bool past)
+{
+    CellProxy *proxy = (CellProxy*) lua_newuserdata(L, sizeof(CellProxy));
+    proxy->store = store;
+    proxy->cell = cell;
+    proxy->slot = cell->getStoreSlot();
+    proxy->past = past;
+#if LUA_VERSION_NUM >= 502
+    luaL_setmetatable(L, CELL_PROXY);
+#else
+    luaL_getmetatable(L, CELL_PROXY);
+    lua_setmetatable(L, -2);
+#endif
+}
+
+/// __index of the cell proxies. The first upvalue is the table of native attributes.
+static int cellProxyIndex(lua_State *L)
+{
+    CellProxy *proxy = (CellProxy*) luaL_checkudata(L, 1, CELL_PROXY);
+    const char *key = luaL_checkstring(L, 2);
+    string name(key);
+
+    if (name == "x")
+    {
+        lua_pushinteger(L, proxy->cell->getIndex().first);
+        return 1;
+    }
+    if (name == "y")
+    {
+        lua_pushinteger(L, proxy->cell->getIndex().second);
+        return 1;
+    }
+    if (name == "past")
+    {
+        if (proxy->past)
+            lua_pushnil(L);
+        else
+            pushCellProxy(L, proxy->store, proxy->cell, true);
+        return 1;
+    }
+
+    lua_getfield(L, lua_upvalueindex(1), key);
+    if (lua_isnil(L, -1))
+        return luaL_error(L, "Attribute '%s' is not stored natively and cannot be used in a parallel forEachCell.", key);
+
+    int attribute = (int) lua_tointeger(L, -1);
+    proxy->store->pushAttribute(L, attribute, proxy->slot, proxy->past);
+    return 1;
+}
+
+/// __newindex of the cell proxies. The first upvalue is the table of native attributes.
+static int cellProxyNewIndex(lua_State *L)
+{
+    CellProxy *proxy = (CellProxy*) luaL_checkudata(L, 1, CELL_PROXY);
+    const char *key = luaL_checkstring(L, 2);
+
+    if (proxy->past)
+        return luaL_error(L, "Attribute '%s' cannot be changed: the past and the neighbors are read-only in a parallel forEachCell.", key);
+
+    lua_getfield(L, lua_upvalueindex(1), key);
+    if (lua_isnil(L, -1))
+        return luaL_error(L, "Attribute '%s' is not stored natively and cannot be used in a parallel forEachCell.", key);
+
+    int attribute = (int) lua_tointeger(L, -1);
+    proxy->store->setAttribute(attribute, proxy->slot, luaL_checknumber(L, 3), false);
+    return 0;
+}
+
+/// forEachNeighbor(cell, [name], f) within the worker lua_States
+static int cellProxyForEachNeighbor(lua_State *L)
+{
+    CellProxy *proxy = (CellProxy*) luaL_checkudata(L, 1, CELL_PROXY);
+    string name = "1";
+    int func = 2;
+
+    if (!lua_isfunction(L, 2))
+    {
+        name = luaL_checkstring(L, 2);
+        func = 3;
+    }
+    luaL_checktype(L, func, LUA_TFUNCTION);
+
+    NeighCmpstInterf& neighborhoods = proxy->cell->getNeighborhoods();
+    NeighCmpstInterf::iterator it = neighborhoods.find(name);
+    if (it == neighborhoods.end())
+        return luaL_error(L, "Neighborhood '%s' does not exist.", name.c_str());
+
+    vector<Cell*> neighbors;
+    vector<double> weights;
+    ((luaNeighborhood*) it->second)->getNeighbors(neighbors, weights);
+
+    for (size_t i = 0; i < neighbors.size(); i++)
+    {
+        luaCell *neighbor = (luaCell*) neighbors[i];
+        if (neighbor->getStore() != proxy->store)
+            return luaL_error(L, "Neighbors from other CellularSpaces cannot be used in a parallel forEachCell.");
+
+        lua_pushvalue(L, func);
+        lua_pushvalue(L, 1);
+        pushCellProxy(L, proxy->store, neighbor, true);
+        lua_pushnumber(L, weights[i]);
+        lua_call(L, 3, 1);
+
+        bool stop = lua_isboolean(L, -1) && !lua_toboolean(L, -1);
+        lua_pop(L, 1);
+
+        if (stop)
+        {
+            lua_pushboolean(L, false);
+            return 1;
+        }
+    }
+
+    lua_pushboolean(L, true);
+    return 1;
+}
+
+static string errorMessage(lua_State *L)
+{
+    const char *msg = lua_tostring(L, -1);
+    return msg ? string(msg) : string("Error in a parallel forEachCell.");
+}
+
+static int dumpWriter(lua_State *, const void *data, size_t size, void *bytecode)
+{
+    ((string*) bytecode)->append((const char*) data, size);
+    return 0;
+}
+
+ParallelForEachCell::ParallelForEachCell(luaCellularSpace *store, const vector<luaCell*>& cells)
+    : store(store), cells(cells), stop(false), result(true)
+{
+}
+
+bool ParallelForEachCell::execute(lua_State *L, const vector<string>& attributes, int threads)
+{
+    int func = lua_gettop(L);
+    this->attributes = attributes;
+
+    for (int i = 1; ; i++)
+    {
+        const char *name = lua_getupvalue(L, func, i);
+        if (!name)
+            break;
+
+        Upvalue upvalue;
+        upvalue.name = name;
+        upvalue.environment = string(name) == "_ENV";
+        upvalue.type = lua_type(L, -1);
+        upvalue.isInteger = false;
+        upvalue.integer = 0;
+        upvalue.number = 0;
+
+        if (!upvalue.environment)
+        {
+            switch (upvalue.type)
+            {
+            case LUA_TNIL:
+                break;
+            case LUA_TBOOLEAN:
+                upvalue.number = lua_toboolean(L, -1);
+                break;
+            case LUA_TNUMBER:
+#if LUA_VERSION_NUM >= 503
+                upvalue.isInteger = lua_isinteger(L, -1);
+#endif
+                upvalue.integer = lua_tointeger(L, -1);
+                upvalue.number = lua_tonumber(L, -1);
+                break;
+            case LUA_TSTRING:
+                upvalue.text = lua_tostring(L, -1);
+                break;
+            default:
+                error = string("Variable '") + name + "' (" + lua_typename(L, upvalue.type)
+                        + ") cannot be used in a parallel forEachCell. Only numbers, strings and booleans can be shared.";
+                lua_pop(L, 1);
+                return false;
+            }
+        }
+
+        upvalues.push_back(upvalue);
+        lua_pop(L, 1);
+    }
+
+    lua_pushvalue(L, func);
+#if LUA_VERSION_NUM >= 503
+    lua_dump(L, dumpWriter, &bytecode, 0);
+#else
+    lua_dump(L, dumpWriter, &bytecode);
+#endif
+    lua_pop(L, 1);
+
+    int size = (int) cells.size();
+    threads = std::max(1, std::min(threads, size));
+
+    vector<std::thread> workers;
+    for (int t = 1; t < threads; t++)
+        workers.push_back(std::thread(&ParallelForEachCell::run, this,
+                                      (int) ((long) size * t / threads),
+                                      (int) ((long) size * (t + 1) / threads)));
+
+    run(0, size / threads);
+
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+
+    return result;
+}
+
+void ParallelForEachCell::run(int begin, int end)
+{
+    lua_State *L = luaL_newstate();
+    luaL_openlibs(L);
+
+    lua_createtable(L, 0, (int) attributes.size());
+    for (size_t i = 0; i < attributes.size(); i++)
+    {
+        lua_pushinteger(L, (int) i);
+        lua_setfield(L, -2, attributes[i].c_str());
+    }
+    int attributesTable = lua_gettop(L);
+
+    luaL_newmetatable(L, CELL_PROXY);
+    lua_pushvalue(L, attributesTable);
+    lua_pushcclosure(L, cellProxyIndex, 1);
+    lua_setfield(L, -2, "__index");
+    lua_pushvalue(L, attributesTable);
+    lua_pushcclosure(L, cellProxyNewIndex, 1);
+    lua_setfield(L, -2, "__newindex");
+    lua_pop(L, 2);
+
+    lua_pushcfunction(L, cellProxyForEachNeighbor);
+    lua_setglobal(L, "forEachNeighbor");
+
+    if (luaL_loadbuffer(L, bytecode.data(), bytecode.size(), "forEachCell") != LUA_OK)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = errorMessage(L);
+        stop = true;
+        lua_close(L);
+        return;
+    }
+
+    int func = lua_gettop(L);
+    for (size_t i = 0; i < upvalues.size(); i++)
+    {
+        const Upvalue& upvalue = upvalues[i];
+
+        if (upvalue.environment)
+#if LUA_VERSION_NUM >= 502
+            lua_pushglobaltable(L);
+#else
+            lua_pushvalue(L, LUA_GLOBALSINDEX);
+#endif
+        else if (upvalue.type == LUA_TBOOLEAN)
+            lua_pushboolean(L, (int) upvalue.number);
+        else if ((upvalue.type == LUA_TNUMBER) && upvalue.isInteger)
+            lua_pushinteger(L, upvalue.integer);
+        else if (upvalue.type == LUA_TNUMBER)
+            lua_pushnumber(L, upvalue.number);
+        else if (upvalue.type == LUA_TSTRING)
+            lua_pushlstring(L, upvalue.text.data(), upvalue.text.size());
+        else
+            lua_pushnil(L);
+
+        lua_setupvalue(L, func, (int) i + 1);
+    }
+
+    for (int i = begin; (i < end) && !stop; i++)
+    {
+        lua_pushvalue(L, func);
+        pushCellProxy(L, store, cells[i], false);
+        lua_pushinteger(L, i + 1);
+
+        if (lua_pcall(L, 2, 1, 0) != LUA_OK)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error.empty())
+                error = errorMessage(L);
+            stop = true;
+        }
+        else if (lua_isboolean(L, -1) && !lua_toboolean(L, -1))
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            result = false;
+            stop = true;
+        }
+        lua_pop(L, 1);
+    }
+
+    // each thread has its own copy of the upvalues, so assignments to them cannot be merged
+    for (size_t i = 0; i < upvalues.size(); i++)
+    {
+        if (upvalues[i].environment || unchanged(L, func, (int) i + 1))
+            continue;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error.empty())
+            error = "Variable '" + upvalues[i].name + "' cannot be changed in a parallel forEachCell,"
+                    " as each thread has its own copy of the variables from outside the function.";
+        stop = true;
+        break;
+    }
+
+    lua_close(L);
+}
+
+bool ParallelForEachCell::unchanged(lua_State *L, int func, int index) const
+{
+    const Upvalue& upvalue = upvalues[index - 1];
+    lua_getupvalue(L, func, index);
+
+    bool same = lua_type(L, -1) == upvalue.type;
+    if (same && (upvalue.type == LUA_TBOOLEAN))
+        same = lua_toboolean(L, -1) == (int) upvalue.number;
+    else if (same && (upvalue.type == LUA_TNUMBER) && upvalue.isInteger)
+    {
+#if LUA_VERSION_NUM >= 503
+        same = lua_isinteger(L, -1) && (lua_tointeger(L, -1) == upvalue.integer);
+#endif
+    }
+    else if (same && (upvalue.type == LUA_TNUMBER))
+    {
+        double value = lua_tonumber(L, -1);
+        same = (value == upvalue.number) || ((value != value) && (upvalue.number != upvalue.number));
+    }
+    else if (same && (upvalue.type == LUA_TSTRING))
+    {
+        size_t size;
+        const char *text = lua_tolstring(L, -1, &size);
+        same = string(text, size) == upvalue.text;
+    }
+
+    lua_pop(L, 1);
+    return same;
+}
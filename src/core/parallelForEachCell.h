@@ -0,0 +1,108 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*!
+  \file parallelForEachCell.h
+  \brief This file contains definitions about the parallel traversal of the cells of a
+                 CellularSpace: ParallelForEachCell class.
+*/
+
+#ifndef PARALLEL_FOR_EACH_CELL_H
+#define PARALLEL_FOR_EACH_CELL_H
+
+extern "C"
+{
+#include <lua.h>
+}
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+using namespace std;
+
+class luaCell;
+class luaCellularSpace;
+
+/**
+ * \brief
+ *  Applies a Lua function to the cells of a CellularSpace using several threads. Each thread
+ *  has its own lua_State, where the function is loaded from its bytecode. Upvalues can only
+ *  be numbers, strings, booleans or nil. The cells are seen by the function as proxies of the
+ *  native attributes: the cell can change its present values, while its past and its
+ *  neighbors can only be read and return the past values. As the writes go directly to the
+ *  native arrays, they are visible to the main lua_State when the threads finish.
+ *
+ */
+class ParallelForEachCell
+{
+public:
+    /// Constructor
+    /// \param store is the luaCellularSpace that stores the native attributes
+    /// \param cells are the cells to be traversed, in the order of the CellularSpace
+    ParallelForEachCell(luaCellularSpace *store, const vector<luaCell*>& cells);
+
+    /// Executes the function on the top of the Lua stack for all the cells
+    /// \param L is the main Lua stack
+    /// \param attributes are the names of the native attributes, following their indexes
+    /// \param threads is the number of threads
+    /// \return false if the function returned false for some cell
+    bool execute(lua_State *L, const vector<string>& attributes, int threads);
+
+    /// Gets the error raised by the function, if any
+    const string& getError() const { return error; }
+
+private:
+    struct Upvalue
+    {
+        string name;
+        bool environment;
+        int type;
+        bool isInteger; ///< numbers that are integers in the main lua_State keep their subtype
+        lua_Integer integer;
+        double number;
+        string text;
+    };
+
+    /// Executes the function for the cells from begin to end - 1 in a new lua_State
+    void run(int begin, int end);
+
+    /// Checks whether an upvalue of the function in a worker lua_State still has the value
+    /// copied from the main lua_State, as the changes made by the threads would be lost
+    /// \param L is the worker lua_State
+    /// \param func is the position of the function in the stack
+    /// \param index is the position of the upvalue
+    bool unchanged(lua_State *L, int func, int index) const;
+
+    luaCellularSpace *store;
+    const vector<luaCell*>& cells;
+    string bytecode;
+    vector<Upvalue> upvalues;
+    vector<string> attributes;
+    std::atomic<bool> stop; ///< set when some thread must stop
+    std::mutex mutex; ///< protects result and error
+    bool result;
+    string error;
+};
+
+#endif // PARALLEL_FOR_EACH_CELL_H
@@ -73,5 +73,17 @@ public:
 
         return indexCellPair.second;
     }
+
+    /// Gets the number of changes in the Region, used to detect them
+    unsigned long getVersion()
+    {
+        return this->pImpl_->version();
+    }
+
+    /// Gets a pointer that identifies the content of the Region, which is shared by its copies
+    const void* getContent()
+    {
+        return this->pImpl_;
+    }
 };
 #endif
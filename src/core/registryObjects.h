@@ -74,6 +74,7 @@ Luna<luaNeighborhood>::RegType luaNeighborhood::methods[] = {
 	method(luaNeighborhood, setWeight),
 	method(luaNeighborhood, getCellNeighbor),
 	method(luaNeighborhood, getNeighbor),
+	method(luaNeighborhood, getNeighborsAndWeights),
 	//method(luaNeighborhood, getNeighbor_), // for debugging
 	method(luaNeighborhood, first),
 	method(luaNeighborhood, last),
@@ -122,6 +123,9 @@ Luna<luaCell>::RegType luaCell::methods[] = {
 	method(luaCell, setNeighborhood),
 	method(luaCell, getNeighborhood),
 	method(luaCell, synchronize),
+	method(luaCell, setStore),
+	method(luaCell, getAttribute),
+	method(luaCell, setAttribute),
 	method(luaCell, getReference),
 	method(luaCell, setReference),
 	method(luaCell, addNeighborhood),
@@ -157,6 +161,16 @@ Luna<luaCellularSpace>::RegType luaCellularSpace::methods[] = {
 	method(luaCellularSpace, addAttrName),
 	method(luaCellularSpace, clear),
 	method(luaCellularSpace, size),
+	method(luaCellularSpace, readCsv),
+	method(luaCellularSpace, readPgm),
+	method(luaCellularSpace, compactNeighborhood),
+	method(luaCellularSpace, createNeighborhood),
+	method(luaCellularSpace, forEachCellParallel),
+	method(luaCellularSpace, addAttribute),
+	method(luaCellularSpace, synchronizeAttributes),
+	method(luaCellularSpace, saveAttributes),
+	method(luaCellularSpace, restoreAttributes),
+	method(luaCellularSpace, reduce),
 	method(luaCellularSpace, addCell),
 	method(luaCellularSpace, setWhereClause),
 
@@ -313,6 +327,14 @@ Luna<luaTcpSender>::RegType luaTcpSender::methods[] = {
         {0, 0}
 };
 
+const char luaTcpListener::className[] = "TeTcpListener";
+
+Luna<luaTcpListener>::RegType luaTcpListener::methods[] = {
+        method(luaTcpListener, listen),
+        method(luaTcpListener, receive),
+        {0, 0}
+};
+
 const char luaUdpSender::className[] = "TeUdpSender";
 
 Luna<luaUdpSender>::RegType luaUdpSender::methods[] = {
@@ -320,6 +342,64 @@ Luna<luaUdpSender>::RegType luaUdpSender::methods[] = {
         {0, 0}
 };
 
+const char luaUdpListener::className[] = "TeUdpListener";
+
+Luna<luaUdpListener>::RegType luaUdpListener::methods[] = {
+        method(luaUdpListener, listen),
+        method(luaUdpListener, receive),
+        method(luaUdpListener, lost),
+        {0, 0}
+};
+
+const char luaDataFrame::className[] = "TeDataFrame";
+
+Luna<luaDataFrame>::RegType luaDataFrame::methods[] = {
+        method(luaDataFrame, config),
+        method(luaDataFrame, size),
+        method(luaDataFrame, getColumns),
+        method(luaDataFrame, add),
+        method(luaDataFrame, remove),
+        method(luaDataFrame, get),
+        method(luaDataFrame, set),
+        method(luaDataFrame, getColumn),
+        method(luaDataFrame, setColumn),
+        method(luaDataFrame, sum),
+        method(luaDataFrame, mean),
+        method(luaDataFrame, minimum),
+        method(luaDataFrame, maximum),
+        method(luaDataFrame, quantile),
+        method(luaDataFrame, save),
+        method(luaDataFrame, load),
+        {0, 0}
+};
+
+const char luaPlacement::className[] = "TePlacement";
+
+Luna<luaPlacement>::RegType luaPlacement::methods[] = {
+        method(luaPlacement, config),
+        method(luaPlacement, enter),
+        method(luaPlacement, leave),
+        method(luaPlacement, size),
+        method(luaPlacement, get),
+        method(luaPlacement, getAgents),
+        method(luaPlacement, radius),
+        {0, 0}
+};
+
+const char luaSocialGraph::className[] = "TeSocialGraph";
+
+Luna<luaSocialGraph>::RegType luaSocialGraph::methods[] = {
+        method(luaSocialGraph, quantity),
+        method(luaSocialGraph, probability),
+        method(luaSocialGraph, cell),
+        method(luaSocialGraph, neighbor),
+        method(luaSocialGraph, symmetrize),
+        method(luaSocialGraph, size),
+        method(luaSocialGraph, copy),
+        method(luaSocialGraph, forEachConnection),
+        {0, 0}
+};
+
 //****************************** TIME ***********************************************//
 //----------------------------------------------------------------------------------------------
 const char luaMessage::className[] = "TeMessage";
@@ -361,6 +441,12 @@ Luna<luaTimer>::RegType luaTimer::methods[] =
 	method(luaTimer, isEmpty),
 	method(luaTimer, reset),
 	method(luaTimer, execute),
+	method(luaTimer, schedule),
+	method(luaTimer, getFirst),
+	method(luaTimer, removeFirst),
+	method(luaTimer, getEvents),
+	method(luaTimer, clear),
+	method(luaTimer, size),
 
 	method(luaTimer, getReference),
 	method(luaTimer, setReference),
@@ -391,6 +477,8 @@ Luna<luaEnvironment>::RegType luaEnvironment::methods[] =
 	method(luaEnvironment, createObserver),
 	method(luaEnvironment, notify),
 	method(luaEnvironment, kill),
+	method(luaEnvironment, checkpoint),
+	method(luaEnvironment, restore),
 	{0, 0}
 };
 
@@ -50,6 +50,7 @@ of this software and its documentation.
 
 #include "bridge.h"
 #include "composite.h"
+#include "eventQueue.h"
 
 #include "event.h"
 #include "message.h"
@@ -65,10 +66,10 @@ extern bool step;
 
 /**
 * \brief
-*  Event-Message Pair Composite Handle Type.
+*  Event-Message Pair priority queue, ordered by time, priority and insertion order.
 *
 */
-typedef CompositeInterface<multimapComposite<Event, Message*> > EventMessagePairCompositeInterf;
+typedef EventQueue<pair<Event, Message*> > EventMessageQueue;
 
 /**
 * \brief
@@ -111,14 +112,8 @@ public:
     /// \return A copy to the Event object on Event-Message head
     Event getEvent(void)
 	{
-        EventMessagePairCompositeInterf::iterator iterator = eventMessageQueue.begin();
-        pair<Event, Message*> eventMessagePair;
-
-        if (iterator != eventMessageQueue.end())
-        {
-            eventMessagePair.first = iterator->first;
-            return eventMessagePair.first;
-        }
+        if (!eventMessageQueue.empty())
+            return eventMessageQueue.top().first;
 
         return time_;
     }
@@ -135,7 +130,7 @@ public:
         pair<Event, Message*> eventMessagePair;
         eventMessagePair.first = event;
         eventMessagePair.second = message;
-        eventMessageQueue.add(eventMessagePair);
+        eventMessageQueue.push(event.getTime(), event.getPriority(), eventMessagePair);
     }
 
     /// Executes the Scheduler object. Only one simulation time step is executed.
@@ -143,34 +138,27 @@ public:
     /// \return A reference to Event object which has triggered the Message object
     Event& execute()
 	{
-        pair<Event, Message*> eventMessagePair;
-        EventMessagePairCompositeInterf::iterator iterator;
-
-        iterator = eventMessageQueue.begin();
-        if (iterator != eventMessageQueue.end())
+        if (!eventMessageQueue.empty())
         {
-            Event& event = eventMessagePair.first = iterator->first;
-            Message *message = eventMessagePair.second = iterator->second;
+            pair<Event, Message*> eventMessagePair = eventMessageQueue.top();
+            Event& event = eventMessagePair.first;
+            Message *message = eventMessagePair.second;
 
             time_ = event.getTime();
 
             Message msg = *message; // it's Important to keep the message implementation alive
-            eventMessageQueue.erase(iterator);
+            eventMessageQueue.pop();
 
             if (message->execute(event))
 			{
-                eventMessagePair.first.setTime(double(time_.getTime() + event.getPeriod()));
-                eventMessageQueue.add(eventMessagePair);
+                event.setTime(double(time_.getTime() + event.getPeriod()));
+                add(event, message);
             }
-
-            iterator = eventMessageQueue.begin();
         }
 
         if (!eventMessageQueue.empty())
-        {
-            Event& event =(Event&)iterator->first;
-            return event;
-        }
+            return const_cast<Event&>(eventMessageQueue.top().first);
+
         return time_;
     }
 
@@ -182,16 +170,13 @@ public:
 	{
         Event event;
         Message *message;
-        pair<Event, Message*> eventMessagePair;
-        EventMessagePairCompositeInterf::iterator iterator;
 
-        iterator = eventMessageQueue.begin();
-        while (iterator != eventMessageQueue.end() && time_.getTime() <= finalTime)
+        while (!eventMessageQueue.empty() && time_.getTime() <= finalTime)
         {
             while (paused) qApp->processEvents();
 
-            event = eventMessagePair.first = iterator->first;
-            message = eventMessagePair.second = iterator->second;
+            event = eventMessageQueue.top().first;
+            message = eventMessageQueue.top().second;
 
             if (event.getTime() > finalTime)
 			{
@@ -201,16 +186,14 @@ public:
 
             time_ = event.getTime();
             Message msg = *message; // it's Important to keep the message implementation alive
-            eventMessageQueue.erase(iterator);
+            eventMessageQueue.pop();
 
             if (message->execute(event))
 			{
-                eventMessagePair.first.setTime(double(time_.getTime() + event.getPeriod()));
-                eventMessageQueue.add(eventMessagePair);
+                event.setTime(double(time_.getTime() + event.getPeriod()));
+                add(event, message);
             }
 
-            iterator = eventMessageQueue.begin();
-
             if (step) paused = true;
         }
 		return finalTime;
@@ -227,7 +210,7 @@ public:
     bool empty(void) { return eventMessageQueue.empty(); }
 
 public:
-    EventMessagePairCompositeInterf eventMessageQueue; ///< Event-Message Pair queue
+    EventMessageQueue eventMessageQueue; ///< Event-Message Pair queue
 };
 
 /**
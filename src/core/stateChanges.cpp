@@ -0,0 +1,93 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "stateChanges.h"
+
+#include <QStringList>
+
+#include "../observer/observerGlobals.h"
+
+using namespace TerraMEObserver;
+
+StateChanges::StateChanges()
+{
+}
+
+void StateChanges::attach(int observerId)
+{
+    observers.insert(observerId);
+}
+
+void StateChanges::detach(int observerId)
+{
+    observers.remove(observerId);
+}
+
+QString StateChanges::filter(const QString& state, int observersCount)
+{
+    // id, subject type, number of attributes, number of elements, and the
+    // attributes as sequences of name, type and value
+    QStringList tokens = state.split(PROTOCOL_SEPARATOR);
+    int attributes = (tokens.size() > 3) ? tokens.at(2).toInt() : -1;
+
+    bool partial = (observersCount > 0) && (observers.size() == observersCount)
+        && (received == observers) && (attributes >= 0) && (tokens.at(3) == "0")
+        && (tokens.size() >= 4 + 3 * attributes);
+
+    received = observers;
+
+    if ((attributes < 0) || (tokens.size() < 4 + 3 * attributes))
+    {
+        values.clear();
+        return state;
+    }
+
+    QStringList changes;
+    int counter = 0;
+
+    if (!partial)
+        values.clear();
+
+    for (int i = 0; i < attributes; i++)
+    {
+        int j = 4 + 3 * i;
+        QString value = tokens.at(j + 1) + PROTOCOL_SEPARATOR + tokens.at(j + 2);
+        QHash<QString, QString>::iterator it = values.find(tokens.at(j));
+
+        if ((it != values.end()) && (it.value() == value))
+            continue;
+
+        values.insert(tokens.at(j), value);
+        changes << tokens.at(j) << tokens.at(j + 1) << tokens.at(j + 2);
+        counter++;
+    }
+
+    if (!partial)
+        return state;
+
+    // the elements and separators after the attributes are kept
+    QStringList result;
+    result << tokens.at(0) << tokens.at(1) << QString::number(counter) << tokens.at(3);
+    result << changes << tokens.mid(4 + 3 * attributes);
+    return result.join(PROTOCOL_SEPARATOR);
+}
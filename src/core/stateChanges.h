@@ -0,0 +1,71 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*!
+  \file stateChanges.h
+  \brief This file contains definitions about the partial states of Cells and Societies: StateChanges class.
+*/
+
+#ifndef STATE_CHANGES_H
+#define STATE_CHANGES_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+/**
+ * \brief
+ *  Removes from the states of a Subject the attributes that did not change since
+ *  the previous state. TextScreen, Table and LogFile keep the last value of each
+ *  attribute, therefore they can draw partial states. The BlackBoard shares the
+ *  same state among the observers of a Subject, so the states are partial only
+ *  when every observer keeps its values and received the previous state.
+ *
+ */
+class StateChanges
+{
+public:
+    /// Constructor
+    StateChanges();
+
+    /// Registers an observer that keeps the values it receives
+    /// \param observerId the id of the observer
+    void attach(int observerId);
+
+    /// Removes an observer
+    /// \param observerId the id of the observer
+    void detach(int observerId);
+
+    /// Removes the attributes that did not change from a complete state
+    /// \param state a complete state in the text protocol
+    /// \param observersCount the number of observers of the Subject
+    /// \return the partial state, or the complete state if some observer needs it
+    QString filter(const QString& state, int observersCount);
+
+private:
+    QHash<QString, QString> values; ///< type and value of each attribute in the last state
+    QSet<int> observers; ///< observers that keep the values they receive
+    QSet<int> received; ///< observers when the last state was built
+};
+
+#endif
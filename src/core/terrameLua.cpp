@@ -30,6 +30,7 @@ of this software and its documentation.
 #include <QLoggingCategory>
 
 #include "Downloader.h"
+#include "csvReader.h"
 #include "blackBoard.h"
 #include "protocol.pb.h"
 
@@ -152,7 +153,12 @@ void registerClasses()
     Luna<luaTable>::Register(L);
     Luna<luaLogFile>::Register(L);
     Luna<luaTcpSender>::Register(L);
+    Luna<luaTcpListener>::Register(L);
     Luna<luaUdpSender>::Register(L);
+    Luna<luaUdpListener>::Register(L);
+    Luna<luaDataFrame>::Register(L);
+    Luna<luaPlacement>::Register(L);
+    Luna<luaSocialGraph>::Register(L);
 }
 
 int cpp_runcommand(lua_State *L)
@@ -393,6 +399,9 @@ int main(int argc, char *argv[])
 	lua_pushcfunction(L, cpp_restartobservercounter);
 	lua_setglobal(L, "cpp_restartobservercounter");
 
+	lua_pushcfunction(L, luaReadCsv);
+	lua_setglobal(L, "cpp_readcsv");
+
 	lua_pushcfunction(L, cpp_putenv);
 	lua_setglobal(L, "cpp_putenv");
 
@@ -336,7 +336,6 @@ public:
     }
 
     int synchronize(lua_State *L) {
-        Cell::synchronize(sizeof(luaCell));
         return 0;
     }
 
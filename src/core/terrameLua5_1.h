@@ -136,7 +136,12 @@ luaCell * findCell(luaCellularSpace*, CellIndex&);
 #include "luaTable.h"
 #include "luaLogFile.h"
 #include "luaTcpSender.h"
+#include "luaTcpListener.h"
 #include "luaUdpSender.h"
+#include "luaUdpListener.h"
+#include "luaDataFrame.h"
+#include "luaPlacement.h"
+#include "luaSocialGraph.h"
 
 #endif // TERRAME_LUA_5_1_H
 
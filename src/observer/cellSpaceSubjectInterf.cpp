@@ -25,6 +25,7 @@ of this software and its documentation.
 
 #include "types/agentObserverMap.h"
 #include "types/observerUDPSender.h"
+#include "types/observerTCPSender.h"
 
 #include "types/observerTextScreen.h"
 #include "types/observerGraphic.h"
@@ -57,6 +58,10 @@ Observer * CellSpaceSubjectInterf::createObserver(TypesOfObservers type)
             obs = new ObserverUDPSender(this);
             break;
 
+        case TObsTCPSender:
+            obs = new ObserverTCPSender(this);
+            break;
+
         case TObsMap:
             obs = new AgentObserverMap(this);
             break;
@@ -105,6 +110,11 @@ bool CellSpaceSubjectInterf::kill(int id)
             delete(ObserverUDPSender *)obs;
             break;
 
+        case TObsTCPSender:
+           ((ObserverTCPSender *)obs)->close();
+            delete(ObserverTCPSender *)obs;
+            break;
+
         case TObsMap:
            ((AgentObserverMap *)obs)->close();
             delete(AgentObserverMap *)obs;
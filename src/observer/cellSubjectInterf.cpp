@@ -28,6 +28,7 @@ of this software and its documentation.
 #include "types/observerTextScreen.h"
 #include "types/observerGraphic.h"
 #include "types/observerUDPSender.h"
+#include "types/observerTCPSender.h"
 #include "types/agentObserverMap.h"
 
 Observer * CellSubjectInterf::createObserver(TypesOfObservers type)
@@ -53,6 +54,10 @@ Observer * CellSubjectInterf::createObserver(TypesOfObservers type)
             obs = new ObserverUDPSender(this);
             break;
 
+        case TObsTCPSender:
+            obs = new ObserverTCPSender(this);
+            break;
+
 		case TObsNeigh:
 			obs = new AgentObserverMap(this);
 			break;
@@ -95,6 +100,11 @@ bool CellSubjectInterf::kill(int id)
             delete(ObserverUDPSender *)obs;
             break;
 
+        case TObsTCPSender:
+           ((ObserverTCPSender *)obs)->close();
+            delete(ObserverTCPSender *)obs;
+            break;
+
         case TObsTextScreen:
            ((ObserverTextScreen *)obs)->close();
             delete(ObserverTextScreen *)obs;
@@ -25,6 +25,7 @@ of this software and its documentation.
 
 #include <QDebug>
 #include <math.h>
+#include <algorithm>
 
 using namespace TerraMEObserver;
 
@@ -153,6 +154,129 @@ unsigned int ObsLegend::getIdxColor() const
 
 //////////////////////////////////////////////////////////////////////////////////////////// ATTRIBUTES
 
+LegendLookup::LegendLookup()
+    : mode(TObsEqualSteps), overlapped(false)
+{
+}
+
+bool LegendLookup::changed(const QVector<ObsLegend> &legend, GroupingMode mode) const
+{
+    if ((legend.size() != colors.size()) || (mode != this->mode))
+        return true;
+
+    for (int i = 0; i < legend.size(); i++)
+    {
+        const ObsLegend &leg = legend.at(i);
+
+        if ((leg.getColor().rgb() != colors.at(i)) || (leg.getFrom() != fromText.at(i))
+            || (leg.getTo() != toText.at(i)))
+            return true;
+    }
+    return false;
+}
+
+void LegendLookup::compile(const QVector<ObsLegend> &legend, GroupingMode mode)
+{
+    if (!changed(legend, mode))
+        return;
+
+    int size = legend.size();
+
+    this->mode = mode;
+    from.resize(size);
+    to.resize(size);
+    fromText.resize(size);
+    toText.resize(size);
+    colors.resize(size);
+    uniqueValues.clear();
+    texts.clear();
+
+    for (int i = 0; i < size; i++)
+    {
+        const ObsLegend &leg = legend.at(i);
+
+        from[i] = leg.getFromNumber();
+        to[i] = leg.getToNumber();
+        fromText[i] = leg.getFrom();
+        toText[i] = leg.getTo();
+        colors[i] = leg.getColor().rgb();
+
+        // the first item of a value has priority
+        if (!texts.contains(fromText.at(i)))
+            texts.insert(fromText.at(i), i);
+
+        double value = to.at(i) == 0 ? 0 : to.at(i); // -0 and 0 are equal
+        if ((value == value) && !uniqueValues.contains(value))
+            uniqueValues.insert(value, i);
+    }
+
+    slices.resize(size);
+    for (int i = 0; i < size; i++)
+        slices[i] = i;
+
+    std::stable_sort(slices.begin(), slices.end(), [this](int a, int b)
+    {
+        return from.at(a) < from.at(b);
+    });
+
+    overlapped = false;
+    for (int i = 0; i < size; i++)
+    {
+        int k = slices.at(i);
+
+        if ((from.at(k) != from.at(k)) || (to.at(k) != to.at(k))
+            || ((i + 1 < size) && (to.at(k) > from.at(slices.at(i + 1)))))
+        {
+            overlapped = true;
+            break;
+        }
+    }
+}
+
+bool LegendLookup::isEmpty() const
+{
+    return colors.isEmpty();
+}
+
+int LegendLookup::indexOf(double value) const
+{
+    if (mode == TObsUniqueValue)
+        return uniqueValues.value(value == 0 ? 0 : value, -1);
+
+    if (overlapped)
+    {
+        for (int j = 0; j < from.size(); j++)
+        {
+            if ((from.at(j) <= value) && (value < to.at(j)))
+                return j;
+        }
+        return -1;
+    }
+
+    // last slice whose minimum is not greater than the value
+    QVector<int>::const_iterator it = std::upper_bound(slices.constBegin(), slices.constEnd(), value,
+        [this](double v, int k)
+        {
+            return v < from.at(k);
+        });
+
+    if (it == slices.constBegin())
+        return -1;
+
+    int k = *(it - 1);
+    return ((from.at(k) <= value) && (value < to.at(k))) ? k : -1;
+}
+
+int LegendLookup::indexOf(const QString &value) const
+{
+    return texts.value(value, -1);
+}
+
+QRgb LegendLookup::color(int index) const
+{
+    return colors.at(index);
+}
+
 Attributes::Attributes(QString name, int contSize, double width, double height) : attribName(name)
 {
     containersSize = contSize;
@@ -411,6 +535,12 @@ void Attributes::addLegend(ObsLegend leg)
     legend->push_back(leg);
 }
 
+const LegendLookup & Attributes::getLegendLookup()
+{
+    legendLookup.compile(*legend, groupMode);
+    return legendLookup;
+}
+
 void Attributes::setMaxValue(double m)
 {
     maxValue = m;
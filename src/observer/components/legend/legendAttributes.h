@@ -26,6 +26,7 @@ of this software and its documentation.
 
 #include <QtCore/QString>
 #include <QtCore/QVector>
+#include <QtCore/QHash>
 #include <QImage>
 #include <QFont>
 #include <QPair>
@@ -167,6 +168,69 @@ private:
     double toNumber;
 };
 
+/**
+ * \brief Compiled form of a legend used to find the item of each value.
+ * Numeric slices are kept sorted by their minimum value and found by a
+ * binary search, while unique values and texts are found in hash tables.
+ * The result is the same of a linear search returning the first item
+ * that matches the value.
+ * \file legendAttributes.h
+ */
+class LegendLookup
+{
+public:
+    /**
+     * Default constructor
+     */
+    LegendLookup();
+
+    /**
+     * Compiles a legend, if it differs from the last one compiled
+     * \param legend reference to the legend items
+     * \param mode the grouping mode of the legend
+     * \see ObsLegend, \see GroupingMode
+     */
+    void compile(const QVector<ObsLegend> &legend, GroupingMode mode);
+
+    /**
+     * Returns \a true if the legend does not have items
+     */
+    bool isEmpty() const;
+
+    /**
+     * Gets the index of the legend item of a numeric value or -1 if
+     * no item matches it
+     * \param value a numeric value
+     */
+    int indexOf(double value) const;
+
+    /**
+     * Gets the index of the legend item of a text or -1 if no item matches it
+     * \param value a text
+     * \see QString
+     */
+    int indexOf(const QString &value) const;
+
+    /**
+     * Gets the color of a legend item
+     * \param index the item index
+     */
+    QRgb color(int index) const;
+
+private:
+    bool changed(const QVector<ObsLegend> &legend, GroupingMode mode) const;
+
+    GroupingMode mode;
+    QVector<double> from, to;
+    QVector<QString> fromText, toText;
+    QVector<QRgb> colors;
+
+    QVector<int> slices;        // items sorted by their minimum value
+    bool overlapped;            // the slices overlap, so they are searched linearly
+    QHash<double, int> uniqueValues;
+    QHash<QString, int> texts;
+};
+
 /**
  * \file legendAttributes.h
  * \brief Attributes of observation in the spacial observers
@@ -275,6 +339,13 @@ public:
      */
     void addLegend(ObsLegend leg);
 
+    /**
+     * Gets the legend compiled for searching the item of each value.
+     * It is compiled again only when the legend or the grouping mode change.
+     * \see LegendLookup
+     */
+    const LegendLookup & getLegendLookup();
+
     /**
      * Sets the maximum value
      * \param m maximum value to a attribute
@@ -617,6 +688,7 @@ private:
     QVector<QString> *textValues; //modificar para template
     QVector<bool> *boolValues; //modificar para template
     QVector<ObsLegend> *legend;
+    LegendLookup legendLookup;
     vector<ColorBar> colorBarVec;
     vector<ColorBar> stdColorBarVec;
     QStringList labelList, valueList;
@@ -0,0 +1,206 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "legendQuantile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+using namespace TerraMEObserver;
+
+QuantileSketch::QuantileSketch(int k)
+    : k(k), count(0), odd(false), min(HUGE_VAL), max(-HUGE_VAL), levels(1)
+{
+}
+
+void QuantileSketch::add(double value)
+{
+    count++;
+    min = std::min(min, value);
+    max = std::max(max, value);
+
+    levels[0].push_back(value);
+    if ((int) levels[0].size() >= capacity(0))
+        compress();
+}
+
+void QuantileSketch::merge(const QuantileSketch &other)
+{
+    if (other.count == 0)
+        return;
+
+    count += other.count;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+
+    if (levels.size() < other.levels.size())
+        levels.resize(other.levels.size());
+
+    for (size_t h = 0; h < other.levels.size(); h++)
+        levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+
+    compress();
+}
+
+quint64 QuantileSketch::size() const
+{
+    return count;
+}
+
+QVector<double> QuantileSketch::valuesAt(const QVector<quint64> &positions) const
+{
+    std::vector< std::pair<double, quint64> > weighted;
+
+    for (size_t h = 0; h < levels.size(); h++)
+    {
+        quint64 weight = (quint64) 1 << h;
+        for (size_t i = 0; i < levels[h].size(); i++)
+            weighted.push_back(std::make_pair(levels[h][i], weight));
+    }
+
+    std::sort(weighted.begin(), weighted.end());
+
+    QVector<double> result;
+    size_t item = 0;
+    quint64 accumulated = weighted.empty() ? 0 : weighted[0].second;
+
+    for (int i = 0; i < positions.size(); i++)
+    {
+        quint64 position = positions.at(i);
+
+        if (position == 0)
+        {
+            result.append(min);
+            continue;
+        }
+
+        if (position + 1 >= count)
+        {
+            result.append(max);
+            continue;
+        }
+
+        // the weights of the items represent how many values of the stream they replace
+        while ((accumulated <= position) && (item + 1 < weighted.size()))
+            accumulated += weighted[++item].second;
+
+        result.append(weighted[item].first);
+    }
+
+    return result;
+}
+
+int QuantileSketch::capacity(int level) const
+{
+    // levels below the top one shrink geometrically, as proposed for the KLL sketch
+    int depth = (int) levels.size() - 1 - level;
+    return std::max(8, (int) ceil(k * pow(2.0 / 3.0, depth)));
+}
+
+void QuantileSketch::compress()
+{
+    for (size_t h = 0; h < levels.size(); h++)
+    {
+        if ((int) levels[h].size() < capacity((int) h))
+            continue;
+
+        if (h + 1 == levels.size())
+            levels.push_back(std::vector<double>());
+
+        std::vector<double> &level = levels[h];
+        std::sort(level.begin(), level.end());
+
+        // an odd number of values keeps the last one in this level
+        size_t pairs = level.size() / 2;
+        for (size_t i = 0; i < pairs; i++)
+            levels[h + 1].push_back(level[2 * i + (odd ? 1 : 0)]);
+
+        odd = !odd;
+
+        if (level.size() % 2)
+        {
+            double last = level.back();
+            level.clear();
+            level.push_back(last);
+        }
+        else
+            level.clear();
+    }
+}
+
+/// Summarizes the values from begin to end - 1
+static void sketchValues(const double *values, int begin, int end, QuantileSketch *sketch)
+{
+    for (int i = begin; i < end; i++)
+        sketch->add(values[i]);
+}
+
+QVector<double> TerraMEObserver::orderStatistics(const QVector<double> &values, const QVector<int> &positions)
+{
+    QVector<double> result;
+    int size = values.size();
+
+    if (size == 0)
+        return result;
+
+    if (size <= QUANTILE_EXACT_LIMIT)
+    {
+        std::vector<double> copy(values.constBegin(), values.constEnd());
+        int previous = 0;
+
+        // the values before the previous position are not greater than it
+        for (int i = 0; i < positions.size(); i++)
+        {
+            int position = positions.at(i);
+            std::nth_element(copy.begin() + previous, copy.begin() + position, copy.end());
+            result.append(copy[position]);
+            previous = position;
+        }
+
+        return result;
+    }
+
+    int threads = std::max(1, std::min((int) std::thread::hardware_concurrency(), size / QUANTILE_EXACT_LIMIT + 1));
+    std::vector<QuantileSketch> sketches(threads);
+    std::vector<std::thread> pool;
+
+    for (int t = 1; t < threads; t++)
+        pool.push_back(std::thread(sketchValues, values.constData(), (int) ((qint64) size * t / threads),
+                                   (int) ((qint64) size * (t + 1) / threads), &sketches[t]));
+
+    sketchValues(values.constData(), 0, size / threads, &sketches[0]);
+
+    for (size_t t = 0; t < pool.size(); t++)
+        pool[t].join();
+
+    for (int t = 1; t < threads; t++)
+        sketches[0].merge(sketches[t]);
+
+    QVector<quint64> ranks;
+    for (int i = 0; i < positions.size(); i++)
+        ranks.append(positions.at(i));
+
+    return sketches[0].valuesAt(ranks);
+}
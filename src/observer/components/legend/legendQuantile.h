@@ -0,0 +1,114 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#ifndef LEGEND_QUANTILE_H
+#define LEGEND_QUANTILE_H
+
+#include <QtCore/QVector>
+#include <QtGlobal>
+
+#include <vector>
+
+namespace TerraMEObserver {
+
+/// Maximum number of values whose quantiles are computed exactly
+static const int QUANTILE_EXACT_LIMIT = 1 << 21;
+
+/// Parameter k of the sketch, which defines the size of its largest level
+static const int QUANTILE_SKETCH_SIZE = 1024;
+
+/**
+ * \brief Mergeable summary of a stream of numeric values used to compute
+ * approximate quantiles without keeping or sorting all the values.
+ * It follows the KLL sketch: values are stored in levels and each value
+ * of level h represents 2^h values of the stream. When a level is full,
+ * it is sorted and half of its values (alternately the ones in even or
+ * odd positions) move to the next level. Lower levels have smaller
+ * capacities, therefore the sketch uses O(k) memory and the error of the
+ * rank of a quantile is proportional to n / k. The minimum and the
+ * maximum are exact.
+ * \file legendQuantile.h
+ */
+class QuantileSketch
+{
+public:
+    /**
+     * Constructor
+     * \param k the capacity of the largest level
+     */
+    QuantileSketch(int k = QUANTILE_SKETCH_SIZE);
+
+    /**
+     * Adds a value to the sketch
+     */
+    void add(double value);
+
+    /**
+     * Adds all the values summarized by another sketch
+     * \param other a sketch with the same k
+     */
+    void merge(const QuantileSketch &other);
+
+    /**
+     * Gets the number of values added to the sketch
+     */
+    quint64 size() const;
+
+    /**
+     * Gets the approximate values at given positions of the sorted stream
+     * \param positions the positions, in ascending order, between zero and size() - 1
+     */
+    QVector<double> valuesAt(const QVector<quint64> &positions) const;
+
+private:
+    /**
+     * Gets the number of values a level can store before being compacted
+     */
+    int capacity(int level) const;
+
+    /**
+     * Compacts the levels that exceed their capacities
+     */
+    void compress();
+
+    int k;
+    quint64 count;
+    bool odd;       // the values in odd positions move to the next level in the next compaction
+    double min, max;
+    std::vector< std::vector<double> > levels;
+};
+
+/**
+ * Gets the values at given positions of the sorted values without sorting them.
+ * Up to QUANTILE_EXACT_LIMIT values, each position is found by nth_element,
+ * otherwise the values are summarized by QuantileSketch, using one sketch for
+ * each thread.
+ * \param values the values, which are not changed
+ * \param positions the positions, in ascending order, between zero and the number of values - 1
+ * \return the value at each position
+ */
+QVector<double> orderStatistics(const QVector<double> &values, const QVector<int> &positions);
+
+} // namespace TerraMEObserver
+
+#endif // LEGEND_QUANTILE_H
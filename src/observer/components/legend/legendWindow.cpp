@@ -34,6 +34,7 @@ class ObsLegend;
 
 #include <cmath>
 #include "terrameGlobals.h"
+#include "legendQuantile.h"
 
 #define MAXSLICES 255
 
@@ -852,50 +853,47 @@ void LegendWindow::groupByQuantil(double fix, Attributes *attrib)
     QVector<ObsLegend> *vecLegend = attrib->getLegend();
     vecLegend->clear();
 
-    // Causava modifica??es permanentes na estrutura, fato que
-    // gerava discord?ncia nos dados ap?s altera??es na legenda
-    // quando feitas depois do t?rmino do modelo
-    //QVector<double> *values = attrib->getNumericValues();
-    std::vector<double> values = attrib->getNumericValues()->toStdVector();
-    qStableSort(values.begin(), values.end());
+    // Os valores observados nao sao ordenados nem modificados. Apenas os
+    // limites de cada fatia sao calculados (ver orderStatistics)
+    const QVector<double> *values = attrib->getNumericValues();
+    int size = values->size();
+
+    if (size == 0)
+        return;
 
     int precision = precisionComboBox->currentText().toInt();
 
-    double step = values.size() /(rows * 1.0);
+    double step = size /(rows * 1.0);
+
+    // posicoes, nos valores ordenados, do inicio de cada fatia e do maior valor
+    QVector<int> positions;
+    positions.append(0);
+    for (int n = 1; (int)(step *(double)n + 0.5) < size; n++)
+        positions.append((int)(step *(double)n + 0.5));
+    positions.append(size - 1);
 
-    int	n = 0;
-    std::vector<double>::iterator it = values.begin();
+    QVector<double> breaks = orderStatistics(*values, positions);
 
 #ifdef DEBUB_OBSERVER
-    qDebug() << "values.end(): " << values.size();
+    qDebug() << "values.end(): " << size;
     qDebug() << "teColorVec->size(): " << teColorVec->size();
     qDebug() << "step: " << step;
 #endif
 
-    while (it < values.end())
+    for (int n = 1; n < breaks.size(); n++)
     {
         QString from;
 
-        if (it == values.begin())
-            from = QString("%1").arg(*it - fix , 0, 'f', precision);
+        if (n == 1)
+            from = QString("%1").arg(breaks.at(0) - fix , 0, 'f', precision);
         else
-            from = QString("%1").arg(*it, 0, 'f', precision);
-
-        int p =(int)(step *(double)++n + 0.5);
-        it = values.begin() + p;
+            from = QString("%1").arg(breaks.at(n - 1), 0, 'f', precision);
 
         QString to;
-        if (it < values.end())
-        {
-            to = QString("%1").arg(*it, 0, 'f', precision);
-        }
+        if (n < breaks.size() - 1)
+            to = QString("%1").arg(breaks.at(n), 0, 'f', precision);
         else
-        {
-            if (it != values.end())
-                to = QString("%1").arg(*(it-1), 0, 'f', precision);
-            else
-                to = QString("%1").arg(*(it-1) + fix , 0, 'f', precision);
-        }
+            to = QString("%1").arg(breaks.at(n) + fix , 0, 'f', precision);
 
         QString label = QString("%1 ~ %2").arg(from).arg(to);
 
@@ -906,7 +904,6 @@ void LegendWindow::groupByQuantil(double fix, Attributes *attrib)
         leg.setOccurrence(0);
 
         // recupera a cor j? dividida entre os slices
-        // n - 1 pq o "n" ? pre-incrementado(++n)
         leg.setColor(teColorVec->at(n - 1).red_,
                 teColorVec->at(n - 1).green_,
                 teColorVec->at(n - 1).blue_);
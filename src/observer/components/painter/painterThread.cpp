@@ -26,6 +26,9 @@ of this software and its documentation.
 #include <QtGui/QPainter>
 #include <QDebug>
 #include <time.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
 #include "terrameGlobals.h"
 
 #include "../legend/legendAttributes.h"
@@ -36,6 +39,25 @@ extern ExecutionModes execModes;
 
 using namespace TerraMEObserver;
 
+// Minimum number of cells drawn by each rasterizer thread
+static const int MIN_CELLS_PER_THREAD = 4096;
+
+/// Fills a square of the image, clipping it to the image bounds
+static void fillCell(uchar *bits, int bytesPerLine, int width, int height,
+                     int left, int top, int side, QRgb color)
+{
+    int right = std::min(left + side, width);
+    int bottom = std::min(top + side, height);
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+
+    for (int row = top; row < bottom; row++)
+    {
+        QRgb *line = (QRgb *) (bits + row * bytesPerLine);
+        std::fill(line + left, line + right, color);
+    }
+}
+
 PainterThread::PainterThread(QObject *parent)
     : QThread(parent)
 {
@@ -107,6 +129,13 @@ void PainterThread::drawAttrib(QPainter *p, Attributes *attrib)
     if (attrib->getType() == TObsAgent)
         return;
 
+    if ((attrib->getType() != TObsNeighborhood)
+        && ((attrib->getDataType() == TObsNumber) || (attrib->getDataType() == TObsText)))
+    {
+        rasterize(attrib);
+        return;
+    }
+
     //---- Desenha o atributo
     p->begin(attrib->getImage());
 
@@ -118,6 +147,7 @@ void PainterThread::drawAttrib(QPainter *p, Attributes *attrib)
 		QColor color(Qt::white);
                 QVector<QMap<QString, QList<double> > > *neighborhoods = attrib->getNeighValues();
 		QVector<ObsLegend> *vecLegend = attrib->getLegend();
+		const LegendLookup &lookup = attrib->getLegendLookup();
 
 		QPen pen = p->pen();
 		pen.setStyle(Qt::SolidLine);
@@ -163,26 +193,9 @@ void PainterThread::drawAttrib(QPainter *p, Attributes *attrib)
 					}
 					else
 					{
-						for (int j = 0; j < vecLegend->size(); j++)
-						{
-							ObsLegend leg = vecLegend->at(j);
-							if (attrib->getGroupMode() == 3)
-							{
-								if (weight == leg.getTo().toDouble())
-								{
-									pen.setColor(leg.getColor());
-									break;
-								}
-							}
-							else
-							{
-								if ((leg.getFrom().toDouble() <= weight) && (weight < leg.getTo().toDouble()))
-								{
-									pen.setColor(leg.getColor());
-									break;
-								}
-							}
-						}
+						int index = lookup.indexOf(weight);
+						if (index >= 0)
+							pen.setColor(lookup.color(index));
 					}
 					p->setPen(pen);
 
@@ -197,125 +210,107 @@ void PainterThread::drawAttrib(QPainter *p, Attributes *attrib)
 		}
 	}
 	//@RAIAN: FIM
-	else
-	{
-		if (attrib->getDataType() == TObsNumber)
-		{
-			QColor color(Qt::white);
-			QVector<double> *values = attrib->getNumericValues();
-			QVector<ObsLegend> *vecLegend = attrib->getLegend();
-
-			double x = -1.0, y = -1.0, v = 0.0;
+    p->end();
+}
 
-			int vSize = values->size();
-			int xSize = attrib->getXsValue()->size();
-			int ySize = attrib->getYsValue()->size();
 
-			for (int pos = 0; (pos < vSize && pos < xSize && pos < ySize); pos++)
-			{
-				v = values->at(pos);
+void PainterThread::rasterize(Attributes *attrib)
+{
+    const QVector<double> &xs = *attrib->getXsValue();
+    const QVector<double> &ys = *attrib->getYsValue();
+    bool numeric = attrib->getDataType() == TObsNumber;
+    int size = std::min(xs.size(), ys.size());
+    size = std::min(size, numeric ? attrib->getNumericValues()->size()
+                                  : attrib->getTextValues()->size());
+
+    if (size == 0)
+        return;
 
-				// Corrige o bug gerando quando um agente morre
-				if (attrib->getXsValue()->isEmpty() || attrib->getXsValue()->size() == pos)
-					break;
+    // compiled in this thread, so that the workers only read it
+    const LegendLookup &lookup = attrib->getLegendLookup();
+    bool noLegend = lookup.isEmpty();
 
-				x = attrib->getXsValue()->at(pos);
-				y = attrib->getYsValue()->at(pos);
+    double minValue = attrib->getMinValue();
+    double val2Color = attrib->getVal2Color();
+    const QVector<double> *numbers = attrib->getNumericValues();
+    const QVector<QString> *strings = attrib->getTextValues();
 
-				if (vecLegend->isEmpty())
-				{
-					v = v - attrib->getMinValue();
+    int random = qrand() % 256;
+    QRgb randomColor = qRgb(random, random, random);
+    QRgb white = qRgb(255, 255, 255);
 
-					double c = v * attrib->getVal2Color();
-					if ((c >= 0) && (c <= 255))
-					{
-						color.setRgb(c, c, c);
-					}
-					else
-					{
-						color.setRgb(255, 255, 255);
-					}
-					p->setBrush(color);
-				}
-				else
-				{
-					for (int j = 0; j < vecLegend->size(); j++)
-					{
-						p->setBrush(Qt::white);
+    QImage *image = attrib->getImage();
+    uchar *bits = image->bits();
+    int bytesPerLine = image->bytesPerLine();
+    int width = image->width();
+    int height = image->height();
+    int side = attrib->getType() == TObsAutomaton ? SIZE_AUTOMATON : SIZE_CELL;
 
-						const ObsLegend &leg = vecLegend->at(j);
-						if (attrib->getGroupMode() == TObsUniqueValue) // valor ?nico 3
-						{
-							if (v == leg.getToNumber())
-							{
-								p->setBrush(leg.getColor());
-								break;
-							}
-						}
-						else
-						{
-							if ((leg.getFromNumber() <= v) && (v < leg.getToNumber()))
-							{
-								p->setBrush(leg.getColor());
-								break;
-							}
-						}
-					}
-				}
-				if ((x >= 0) && (y >= 0))
-					draw(p, attrib->getType(), x, y);
-			}
-		}
-		else if (attrib->getDataType() == TObsText)
-		{
-			QVector<QString> *values = attrib->getTextValues();
-			QVector<ObsLegend> *vecLegend = attrib->getLegend();
-
-            int random = qrand() % 256;
-			double x = -1.0, y = -1.0;
+    auto worker = [&](int begin, int end)
+    {
+        for (int pos = begin; pos < end; pos++)
+        {
+            double x = xs.at(pos);
+            double y = ys.at(pos);
+
+            if ((x < 0) || (y < 0))
+                continue;
+
+            QRgb color = white;
+
+            if (numeric)
+            {
+                double v = numbers->at(pos);
+
+                if (noLegend)
+                {
+                    double c = (v - minValue) * val2Color;
+                    if ((c >= 0) && (c <= 255))
+                        color = qRgb((int) c, (int) c, (int) c);
+                }
+                else
+                {
+                    int index = lookup.indexOf(v);
+                    if (index >= 0)
+                        color = lookup.color(index);
+                }
+            }
+            else if (noLegend)
+            {
+                color = randomColor;
+            }
+            else
+            {
+                int index = lookup.indexOf(strings->at(pos));
+                if (index >= 0)
+                    color = lookup.color(index);
+            }
+
+            fillCell(bits, bytesPerLine, width, height,
+                     qRound(SIZE_CELL * x), qRound(SIZE_CELL * y), side, color);
+        }
+    };
 
-			int vSize = values->size();
-			int xSize = attrib->getXsValue()->size();
-			int ySize = attrib->getYsValue()->size();
+    int threads = std::min((int) std::thread::hardware_concurrency(), size / MIN_CELLS_PER_THREAD);
 
-			for (int pos = 0; (pos < vSize && pos < xSize && pos < ySize); pos++)
-			{
-				const QString & v = values->at(pos);
+    if (threads <= 1)
+    {
+        worker(0, size);
+        return;
+    }
 
-				// Corrige o bug gerando quando um agente morre
-				if (attrib->getXsValue()->isEmpty() || attrib->getXsValue()->size() == pos)
-					break;
+    std::vector<std::thread> pool;
+    int chunk = (size + threads - 1) / threads;
 
-				x = attrib->getXsValue()->at(pos);
-				y = attrib->getYsValue()->at(pos);
+    for (int t = 1; t < threads; t++)
+        pool.push_back(std::thread(worker, t * chunk, std::min(size, (t + 1) * chunk)));
 
-				if (vecLegend->isEmpty())
-				{
-					p->setBrush(QColor(random, random, random));
-				}
-				else
-				{
-					p->setBrush(Qt::white);
-					for (int j = 0; j < vecLegend->size(); j++)
-					{
-						const ObsLegend &leg = vecLegend->at(j);
-						if (v == leg.getFrom())
-						{
-							p->setBrush(leg.getColor());
-							break;
-						}
-					}
-				}
+    worker(0, std::min(size, chunk));
 
-				if ((x >= 0) && (y >= 0))
-					draw(p, attrib->getType(), x, y);
-			}
-		}
-	}
-    p->end();
+    for (size_t t = 0; t < pool.size(); t++)
+        pool[t].join();
 }
 
-
 //void PainterThread::setVectorPos(QVector<double> *xs, QVector<double> *ys)
 //{
 //QMutexLocker locker(&mutex);
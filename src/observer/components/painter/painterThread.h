@@ -109,6 +109,16 @@ private:
      */
     void draw(QPainter *p, TypesOfSubjects subjType , double &x, double &y);
 
+    /**
+     * Draws the numeric and textual values of a cell attribute writing
+     * the pixels of each cell directly in the attribute image. The cells
+     * are split among threads, each one computing the color and filling
+     * the rectangles of its cells.
+     * \param attrib a pointer to an attribute
+     * \see Attributes
+     */
+    void rasterize(Attributes *attrib);
+
 	//@RAIAN: Desenha a vizinhanca
 		/// Draws a Neighborhood object
 		/// \author Raian Vargas Maretto
@@ -33,6 +33,9 @@ of this software and its documentation.
 // Observers
 #include "../../types/agentObserverMap.h"
 
+// Time, in milliseconds, to wait for the chunks of an incomplete frame before requesting them
+static const int NACK_INTERVAL = 50;
+
 //class ObserverThread : public QThread
 //{
 //    // Q_OBJECT
@@ -63,6 +66,13 @@ Receiver::Receiver(QWidget *parent) :
     udpSocket = new QUdpSocket(this);
     connect(udpSocket, SIGNAL(readyRead()), this, SLOT(processPendingDatagrams()));
 
+    senderPort = 0;
+    clock.start();
+
+    nackTimer = new QTimer(this);
+    connect(nackTimer, SIGNAL(timeout()), this, SLOT(requestMissingChunks()));
+    nackTimer->start(NACK_INTERVAL);
+
     blindButtonClicked();
 }
 
@@ -121,98 +131,106 @@ void Receiver::blindButtonClicked()
     ui->lblReceiverStatus->setText(QString("Socket state: \"%1\", Port: %2").arg(state).arg(port));
 }
 
-// TENTATIVA 3
 void Receiver::processPendingDatagrams()
 {
-    // int totalDatagrams = 0;
-    bool compressDatagram = false;
-    qint64 dataSize = -1.0, pos = 0;
-    qint64 datagramSize = -1; // , dataRemainder = -1.0;
-
     QHostAddress host;
-    quint16 port;
+    quint16 port = 0;
 
-    QByteArray datagram;
-    do
+    while (udpSocket->hasPendingDatagrams())
     {
+        QByteArray datagram;
         datagram.resize(udpSocket->pendingDatagramSize());
         udpSocket->readDatagram(datagram.data(), datagram.size(), &host, &port);
-    } while (udpSocket->hasPendingDatagrams());
-
 
-    QByteArray data, auxData;
-    QDataStream in(&datagram, QIODevice::ReadOnly);
-    // in.setVersion(QDataStream::Qt_4_6);
+        msgReceiver++;
 
-    // Reserva o espa?o necess?rio para o stream transmitido
-    in >> dataSize;         // tamanho total do stream enviado
-    in >> datagramSize;     // tamanho do datagrama enviado
+        QByteArray data;
+        quint8 flags = 0;
 
-    in >> pos;  // indice do dado recebido
-    in >> compressDatagram; // flag formato do datagrama transmitido
-    in >> auxData; // dado recebido
+        if (!assembler.add(datagram, data, flags))
+            continue;
 
-    // totalDatagrams = dataSize / datagramSize;
+        if (flags & TerraMEObserver::UDP_FRAME_COMPRESSED)
+            data = qUncompress(data);
 
-    if ((completeData.isEmpty()))
-          completeData = QByteArray('\0', dataSize);
+        if (flags & TerraMEObserver::UDP_FRAME_END)
+        {
+            if (obsMap)
+            {
+                obsMap->close();
+                delete obsMap;
+                obsMap = 0;
+            }
 
+            msgReceiver = 0;
+            statesReceiver = 0;
+            assembler.clear();
+            requested.clear();
 
-    if (compressDatagram)
-    {
-        data = qUncompress(auxData);
-    }
-    else
-    {
-        data = auxData;
-    }
+            ui->logEdit->appendPlainText("Simulation fineshed!\n");
+            continue;
+        }
 
-    msgReceiver++;
-    ui->lblMessageStatus->setText("Datagrams received: " + QString::number(msgReceiver));
+        processDatagram(data);
+        statesReceiver++;
 
-    if ((pos > -1)) // && (data != COMPLETE_STATE.toLatin1()))
-    {
-        // redimensiona o objeto e insere lixo
-        // msg.insert((int)pos, data);
-        completeData.replace((int)pos, data.size(), data);
+        ui->lblStatesStatus->setText("States received: " +  QString::number(statesReceiver));
 
-        message = tr("Messages received: %1. From: %2, Port: %3")
-            .arg(msgReceiver).arg(host.toString()).arg(port);
+        message = tr("States received: %1. From: %2, Port: %3. Lost: %4\n")
+            .arg(statesReceiver).arg(host.toString()).arg(port).arg(assembler.lost());
 
         ui->logEdit->appendPlainText(
             QDateTime::currentDateTime().toString("MM/dd/yyyy, hh:mm:ss: ") + message);
     }
-    else
+
+    ui->lblMessageStatus->setText("Datagrams received: " + QString::number(msgReceiver));
+
+    if (port != 0)
     {
-        if (data == COMPLETE_STATE.toLatin1())
-        {
-            processDatagram(completeData);
-            completeData.clear();
-            statesReceiver++;
+        senderHost = host;
+        senderPort = port;
+        requestMissingChunks();
+    }
+}
+
+void Receiver::requestMissingChunks()
+{
+    if (senderPort == 0)
+        return;
 
-            ui->lblStatesStatus->setText("States received: " +  QString::number(statesReceiver));
+    QList<quint32> frames = assembler.incomplete();
+    QHash<quint32, qint64> current;
+    qint64 now = clock.elapsed();
 
-            message = tr("States received: %1. From: %2, Port: %3\n")
-                .arg(statesReceiver).arg(host.toString()).arg(port);
+    for (int i = 0; i < frames.size(); i++)
+    {
+        quint32 frame = frames.at(i);
 
-            ui->logEdit->appendPlainText(
-                QDateTime::currentDateTime().toString("MM/dd/yyyy, hh:mm:ss: ") + message);
-        }
-        else
+        // a newer frame has just arrived, the missing chunks might still be in flight
+        if (!requested.contains(frame))
         {
-            if (data == COMPLETE_SIMULATION.toLatin1())
-            {
-                obsMap->close();
-                delete obsMap;
-                obsMap = 0;
+            current.insert(frame, now + NACK_INTERVAL);
+            continue;
+        }
 
-                msgReceiver = 0;
-                statesReceiver = 0;
+        if (requested.value(frame) > now)
+        {
+            current.insert(frame, requested.value(frame));
+            continue;
+        }
 
-                 ui->logEdit->appendPlainText("Simulation fineshed!\n");
-            }
+        // requests at most 512 chunks per datagram
+        QVector<quint16> missing = assembler.missing(frame);
+        for (int pos = 0; pos < missing.size(); pos += 512)
+        {
+            QByteArray nack = TerraMEObserver::UdpFrameEncoder::nack(frame, missing.mid(pos, 512));
+            udpSocket->writeDatagram(nack, senderHost, senderPort);
         }
+
+        current.insert(frame, now + NACK_INTERVAL);
     }
+
+    requested = current;
 }
 
 
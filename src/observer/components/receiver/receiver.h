@@ -25,8 +25,13 @@ of this software and its documentation.
 #define DIALOG_H
 
 #include <QDialog>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QTimer>
 #include <QUdpSocket>
 
+#include "../../types/udpSender/udpFrame.h"
+
 namespace TerraMEObserver {
 class AgentObserverMap;
 }
@@ -74,6 +79,14 @@ public slots:
      */
     void processPendingDatagrams();
 
+    /**
+     * Asks the last sender for the chunks of the incomplete frames. A frame
+     * is requested only after waiting NACK_INTERVAL milliseconds for the
+     * chunks still in flight, and requested again at every interval while
+     * it is incomplete and within the window of the assembler
+     */
+    void requestMissingChunks();
+
 private:
     /**
      * \deprecated Processes the datagram
@@ -91,9 +104,15 @@ private:
 
 
     int msgReceiver, statesReceiver;
-    QByteArray completeData;
     QString message;
 
+    TerraMEObserver::UdpFrameAssembler assembler;
+    QHash<quint32, qint64> requested; // time of the next request of each frame
+    QElapsedTimer clock;
+    QTimer *nackTimer;
+    QHostAddress senderHost;
+    quint16 senderPort;
+
     Ui::receiverGUI *ui;
     QUdpSocket *udpSocket;
     TerraMEObserver::AgentObserverMap *obsMap;
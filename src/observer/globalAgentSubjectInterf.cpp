@@ -28,6 +28,7 @@ of this software and its documentation.
 #include "types/observerTextScreen.h"
 #include "types/observerGraphic.h"
 #include "types/observerUDPSender.h"
+#include "types/observerTCPSender.h"
 #include "types/observerStateMachine.h"
 
 //#include "types/agentObserverMap.h"
@@ -54,6 +55,10 @@ Observer * GlobalAgentSubjectInterf::createObserver(TypesOfObservers typeObserve
             obs = new ObserverUDPSender(this);
             break;
 
+        case TObsTCPSender:
+            obs = new ObserverTCPSender(this);
+            break;
+
         case TObsStateMachine:
             obs = new ObserverStateMachine(this);
             break;
@@ -99,6 +104,11 @@ bool GlobalAgentSubjectInterf::kill(int id)
             delete(ObserverUDPSender *)obs;
             break;
 
+        case TObsTCPSender:
+           ((ObserverTCPSender *)obs)->close();
+            delete(ObserverTCPSender *)obs;
+            break;
+
         case TObsTextScreen:
            ((ObserverTextScreen *)obs)->close();
             delete(ObserverTextScreen *)obs;
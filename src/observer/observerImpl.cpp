@@ -351,6 +351,11 @@ void SubjectImpl::notifyObservers(double time)
     }
 }
 
+int SubjectImpl::getObserversCount() const
+{
+    return (int) observers.size();
+}
+
 const TypesOfSubjects SubjectImpl::getSubjectType()
 {
     return TObsUnknown;
@@ -193,6 +193,11 @@ public:
      */
     void notifyObservers(double time);
 
+    /**
+     * Gets the number of Observers attached to the Subject
+     */
+    int getObserversCount() const;
+
     /**
      * \copydoc TerraMEObserver::Subject::getType
      */
@@ -103,6 +103,11 @@ void SubjectInterf::notify(double time)
     SubjectInterf::pImpl_->notifyObservers(time);
 }
 
+int SubjectInterf::getObserversCount() const
+{
+    return SubjectInterf::pImpl_->getObserversCount();
+}
+
 int SubjectInterf::getId() const
 {
     return SubjectInterf::pImpl_->getId();
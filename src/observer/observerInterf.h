@@ -161,6 +161,11 @@ public:
      */
     void notify(double time);
 
+    /**
+     * Gets the number of Observers attached to the Subject
+     */
+    int getObserversCount() const;
+
     /**
      * \copydoc TerraMEObserver::Subject::getState
      */
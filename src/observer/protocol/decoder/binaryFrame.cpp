@@ -0,0 +1,474 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "binaryFrame.h"
+#include "../../observer.h"
+
+#include <string.h>
+
+using namespace TerraMEObserver;
+
+static inline qint64 align8(qint64 value)
+{
+    return (value + 7) & ~((qint64) 7);
+}
+
+static inline quint16 hostFlags()
+{
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    return BINARY_FRAME_BIG_ENDIAN;
+#else
+    return 0;
+#endif
+}
+
+//////////////////////////////////////////////////////////// BinaryFrameWriter
+
+BinaryFrameWriter::BinaryFrameWriter(int id, TypesOfSubjects type)
+    : subjectId(id), subjectType(type), rowCount(0), delta(false), sequence(0), base(0)
+{
+}
+
+void BinaryFrameWriter::setDelta(bool d)
+{
+    delta = d;
+}
+
+int BinaryFrameWriter::addColumn(const QString &name, TypesOfData type)
+{
+    QHash<QString, int>::const_iterator it = columnsIndex.constFind(name);
+    if (it != columnsIndex.constEnd())
+        return it.value();
+
+    Column col;
+    col.name = name;
+    col.type = type;
+    col.mixed = false;
+
+    columns.append(col);
+    columnsIndex.insert(name, columns.size() - 1);
+    return columns.size() - 1;
+}
+
+void BinaryFrameWriter::setSequence(quint32 s)
+{
+    sequence = s;
+}
+
+void BinaryFrameWriter::setBase(quint32 b)
+{
+    base = b;
+}
+
+void BinaryFrameWriter::addRow()
+{
+    rowCount++;
+}
+
+int BinaryFrameWriter::rows() const
+{
+    return rowCount;
+}
+
+QStringList BinaryFrameWriter::getMixedColumns() const
+{
+    QStringList names;
+
+    for (int i = 0; i < columns.size(); i++)
+    {
+        if (columns.at(i).mixed)
+            names.append(columns.at(i).name);
+    }
+    return names;
+}
+
+void BinaryFrameWriter::fill(Column &col, int size)
+{
+    while (col.valid.size() < size)
+    {
+        switch (col.type)
+        {
+        case TObsBool:
+            col.bools.append(0);
+            break;
+
+        case TObsText:
+            col.textEnds.append(col.text.size());
+            break;
+
+        case TObsNumber:
+        default:
+            col.numbers.append(0);
+            break;
+        }
+        col.valid.append(0);
+    }
+}
+
+bool BinaryFrameWriter::accept(Column &col, TypesOfData type)
+{
+    if (col.type == TObsUnknownData)
+        col.type = type;
+
+    if (col.type != type)
+    {
+        col.mixed = true;
+        return false;
+    }
+
+    fill(col, rowCount - 1);
+    return col.valid.size() < rowCount;
+}
+
+void BinaryFrameWriter::setNumber(int column, double value)
+{
+    Column &col = columns[column];
+
+    if (!accept(col, TObsNumber))
+        return;
+
+    col.numbers.append(value);
+    col.valid.append(1);
+}
+
+void BinaryFrameWriter::setBool(int column, bool value)
+{
+    Column &col = columns[column];
+
+    if (!accept(col, TObsBool))
+        return;
+
+    col.bools.append(value);
+    col.valid.append(1);
+}
+
+void BinaryFrameWriter::setText(int column, const char *value, int size)
+{
+    Column &col = columns[column];
+
+    if (!accept(col, TObsText))
+        return;
+
+    col.text.append(value, size);
+    col.textEnds.append(col.text.size());
+    col.valid.append(1);
+}
+
+QByteArray BinaryFrameWriter::toByteArray()
+{
+    QVector<QByteArray> names;
+    qint64 schemaSize = 0;
+
+    for (int i = 0; i < columns.size(); i++)
+    {
+        // a column without values is sent as a numeric one
+        if (columns[i].type == TObsUnknownData)
+            columns[i].type = TObsNumber;
+
+        fill(columns[i], rowCount);
+
+        names.append(columns.at(i).name.toUtf8());
+        schemaSize += sizeof(BinaryColumnHeader) + align8(names.last().size());
+    }
+
+    QVector<BinaryColumnHeader> schema(columns.size());
+    qint64 offset = sizeof(BinaryFrameHeader) + schemaSize;
+
+    for (int i = 0; i < columns.size(); i++)
+    {
+        const Column &col = columns.at(i);
+        BinaryColumnHeader &colHeader = schema[i];
+
+        colHeader.dataType = col.type;
+        colHeader.nameSize = names.at(i).size();
+        colHeader.offset = offset;
+        colHeader.maskOffset = 0;
+
+        switch (col.type)
+        {
+        case TObsBool:
+            colHeader.size = rowCount;
+            break;
+
+        case TObsText:
+            colHeader.size = (rowCount + 1) * sizeof(quint32) + col.text.size();
+            break;
+
+        case TObsNumber:
+        default:
+            colHeader.size = rowCount * sizeof(double);
+            break;
+        }
+        offset += align8(colHeader.size);
+
+        if (col.valid.contains(0))
+        {
+            colHeader.maskOffset = offset;
+            offset += align8(rowCount);
+        }
+    }
+
+    QByteArray frame(offset, '\0');
+    char *out = frame.data();
+
+    BinaryFrameHeader header;
+    memcpy(header.magic, BINARY_FRAME_MAGIC, sizeof(header.magic));
+    header.version = BINARY_FRAME_VERSION;
+    header.flags = hostFlags() | (delta ? BINARY_FRAME_DELTA : 0);
+    header.subjectId = subjectId;
+    header.subjectType = subjectType;
+    header.rows = rowCount;
+    header.columns = columns.size();
+    header.schemaSize = schemaSize;
+    header.sequence = sequence;
+    header.base = base;
+    header.reserved = 0;
+    memcpy(out, &header, sizeof(header));
+
+    char *schemaOut = out + sizeof(header);
+    for (int i = 0; i < columns.size(); i++)
+    {
+        memcpy(schemaOut, &schema.at(i), sizeof(BinaryColumnHeader));
+        schemaOut += sizeof(BinaryColumnHeader);
+        memcpy(schemaOut, names.at(i).constData(), names.at(i).size());
+        schemaOut += align8(names.at(i).size());
+    }
+
+    for (int i = 0; i < columns.size(); i++)
+    {
+        const Column &col = columns.at(i);
+        char *colOut = out + schema.at(i).offset;
+
+        switch (col.type)
+        {
+        case TObsBool:
+            memcpy(colOut, col.bools.constData(), rowCount);
+            break;
+
+        case TObsText:
+        {
+            quint32 zero = 0;
+            memcpy(colOut, &zero, sizeof(quint32));
+            memcpy(colOut + sizeof(quint32), col.textEnds.constData(),
+                   rowCount * sizeof(quint32));
+            memcpy(colOut + (rowCount + 1) * sizeof(quint32),
+                   col.text.constData(), col.text.size());
+            break;
+        }
+
+        case TObsNumber:
+        default:
+            memcpy(colOut, col.numbers.constData(), rowCount * sizeof(double));
+            break;
+        }
+
+        if (schema.at(i).maskOffset)
+            memcpy(out + schema.at(i).maskOffset, col.valid.constData(), rowCount);
+    }
+
+    return frame;
+}
+
+//////////////////////////////////////////////////////////// BinaryFrameReader
+
+// Returns true if the range [offset, offset + length) is within a buffer of the given size
+static bool fits(quint64 offset, quint64 length, quint64 size)
+{
+    return (offset <= size) && (length <= size - offset);
+}
+
+// Checks if the payload of a column has the size of its type and, for the text
+// columns, if the offsets of the rows are ordered and within the content
+static bool validColumn(const BinaryColumnHeader &colHeader, quint32 rows, const char *col)
+{
+    switch (colHeader.dataType)
+    {
+    case TObsNumber:
+        return colHeader.size >= (quint64) rows * sizeof(double);
+
+    case TObsBool:
+        return colHeader.size >= (quint64) rows;
+
+    case TObsText:
+    {
+        quint64 offsetsSize = ((quint64) rows + 1) * sizeof(quint32);
+        if (colHeader.size < offsetsSize)
+            return false;
+
+        quint64 contentSize = colHeader.size - offsetsSize;
+        quint32 previous = 0;
+
+        for (quint64 i = 0; i <= rows; i++)
+        {
+            quint32 end;
+            memcpy(&end, col + i * sizeof(quint32), sizeof(quint32));
+
+            if ((end < previous) || (end > contentSize))
+                return false;
+            previous = end;
+        }
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+BinaryFrameReader::BinaryFrameReader(const char *d, int s)
+    : data(d), size(s), valid(false)
+{
+    if (!isBinaryFrame(data, size) || (size < (int) sizeof(BinaryFrameHeader)))
+        return;
+
+    memcpy(&header, data, sizeof(header));
+
+    if ((header.version != BINARY_FRAME_VERSION)
+        || ((header.flags & BINARY_FRAME_BIG_ENDIAN) != hostFlags()))
+        return;
+
+    if (sizeof(BinaryFrameHeader) + (qint64) header.schemaSize > (qint64) size)
+        return;
+
+    const char *schemaIn = data + sizeof(BinaryFrameHeader);
+    const char *schemaEnd = schemaIn + header.schemaSize;
+
+    for (quint32 i = 0; i < header.columns; i++)
+    {
+        BinaryColumnHeader colHeader;
+
+        if (schemaIn + sizeof(BinaryColumnHeader) > schemaEnd)
+            return;
+        memcpy(&colHeader, schemaIn, sizeof(BinaryColumnHeader));
+        schemaIn += sizeof(BinaryColumnHeader);
+
+        if (((quint64) (schemaEnd - schemaIn) < colHeader.nameSize)
+                || !fits(colHeader.offset, colHeader.size, size)
+                || ((colHeader.maskOffset != 0) && !fits(colHeader.maskOffset, header.rows, size))
+                || !validColumn(colHeader, header.rows, data + colHeader.offset))
+            return;
+
+        names.append(QString::fromUtf8(schemaIn, colHeader.nameSize));
+        schemaIn += align8(colHeader.nameSize);
+        schema.append(colHeader);
+    }
+    valid = true;
+}
+
+bool BinaryFrameReader::isBinaryFrame(const char *d, int s)
+{
+    return (s >= (int) sizeof(BINARY_FRAME_MAGIC))
+        && (memcmp(d, BINARY_FRAME_MAGIC, sizeof(BINARY_FRAME_MAGIC)) == 0);
+}
+
+bool BinaryFrameReader::isValid() const
+{
+    return valid;
+}
+
+bool BinaryFrameReader::isDelta() const
+{
+    return valid && (header.flags & BINARY_FRAME_DELTA);
+}
+
+quint32 BinaryFrameReader::getSequence() const
+{
+    return valid ? header.sequence : 0;
+}
+
+quint32 BinaryFrameReader::getBase() const
+{
+    return valid ? header.base : 0;
+}
+
+int BinaryFrameReader::getSubjectId() const
+{
+    return header.subjectId;
+}
+
+TypesOfSubjects BinaryFrameReader::getSubjectType() const
+{
+    return (TypesOfSubjects) header.subjectType;
+}
+
+int BinaryFrameReader::rows() const
+{
+    return valid ? header.rows : 0;
+}
+
+int BinaryFrameReader::columns() const
+{
+    return schema.size();
+}
+
+int BinaryFrameReader::indexOf(const QString &name) const
+{
+    return names.indexOf(name);
+}
+
+const QString & BinaryFrameReader::columnName(int column) const
+{
+    return names.at(column);
+}
+
+TypesOfData BinaryFrameReader::columnType(int column) const
+{
+    return (TypesOfData) schema.at(column).dataType;
+}
+
+bool BinaryFrameReader::isNull(int column, int row) const
+{
+    quint64 maskOffset = schema.at(column).maskOffset;
+    return (maskOffset != 0) && (data[maskOffset + row] == 0);
+}
+
+double BinaryFrameReader::number(int column, int row) const
+{
+    double value;
+    memcpy(&value, data + schema.at(column).offset + row * sizeof(double), sizeof(double));
+    return value;
+}
+
+bool BinaryFrameReader::boolean(int column, int row) const
+{
+    return data[schema.at(column).offset + row] != 0;
+}
+
+QString BinaryFrameReader::text(int column, int row) const
+{
+    int textSize = 0;
+    const char *content = rawText(column, row, textSize);
+    return QString::fromUtf8(content, textSize);
+}
+
+const char * BinaryFrameReader::rawText(int column, int row, int &textSize) const
+{
+    const char *col = data + schema.at(column).offset;
+    quint32 begin, end;
+
+    memcpy(&begin, col + row * sizeof(quint32), sizeof(quint32));
+    memcpy(&end, col + (row + 1) * sizeof(quint32), sizeof(quint32));
+
+    textSize = end - begin;
+    return col + (header.rows + 1) * sizeof(quint32) + begin;
+}
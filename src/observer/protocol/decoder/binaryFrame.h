@@ -0,0 +1,338 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#ifndef BINARY_FRAME_H
+#define BINARY_FRAME_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "../../observerGlobals.h"
+
+namespace TerraMEObserver {
+
+/// Identifies a binary frame inside a serialized state
+static const char BINARY_FRAME_MAGIC[4] = {'T', 'M', 'B', 'F'};
+
+/// Version of the binary frame layout
+static const quint16 BINARY_FRAME_VERSION = 3;
+
+/// Flag set when the frame was written by a big-endian host
+static const quint16 BINARY_FRAME_BIG_ENDIAN = 0x0001;
+
+/// Flag set when the frame carries only the rows changed since its base frame
+static const quint16 BINARY_FRAME_DELTA = 0x0002;
+
+/// Column of a delta frame that holds the position of each row in the complete frame
+static const QString DELTA_INDEX_KEY = "@index";
+
+/**
+ * \brief Header of a binary frame.
+ * A frame is composed by this header, followed by the schema (one
+ * BinaryColumnHeader plus the column name for each attribute) and
+ * by the contiguous columns, each one aligned in 8 bytes.
+ * Numeric columns are arrays of double, boolean columns are arrays of
+ * bytes and text columns are an array of (rows + 1) offsets followed
+ * by the UTF-8 content of the rows. A column with rows without a value
+ * is followed by a validity mask, one byte per row (zero for the rows
+ * without a value), also aligned in 8 bytes.
+ * \file binaryFrame.h
+ */
+struct BinaryFrameHeader
+{
+    char magic[4];
+    quint16 version;
+    quint16 flags;
+    qint32 subjectId;
+    qint32 subjectType;
+    quint32 rows;
+    quint32 columns;
+    quint32 schemaSize;
+    quint32 sequence;
+    quint32 base; ///< oldest frame that a delta frame patches
+    quint32 reserved;
+};
+
+/**
+ * \brief Describes one column of a binary frame.
+ * \file binaryFrame.h
+ */
+struct BinaryColumnHeader
+{
+    quint32 dataType;
+    quint32 nameSize;
+    quint64 offset;
+    quint64 size;
+    quint64 maskOffset; ///< offset of the validity mask, zero if every row has a value
+};
+
+/**
+ * \brief Builds a columnar binary frame from the rows of a Subject.
+ * The column type is defined by the first value written in it. Values
+ * of other types are not converted: their rows are left without a value
+ * and the column is reported by getMixedColumns(). Rows without a value
+ * are marked in the validity mask of the column.
+ * \file binaryFrame.h
+ */
+class BinaryFrameWriter
+{
+public:
+    /**
+     * Constructor
+     * \param subjectId the unique identifier of the Subject
+     * \param subjectType the type of the Subject
+     * \see TypesOfSubjects
+     */
+    BinaryFrameWriter(int subjectId, TypesOfSubjects subjectType);
+
+    /**
+     * Adds a column to the schema and returns its index.
+     * If the column already exists, returns the index of it.
+     * \param name the attribute name
+     * \param type the column type. If it is unknown, the first value defines it
+     * \see QString, \see TypesOfData
+     */
+    int addColumn(const QString &name, TypesOfData type = TObsUnknownData);
+
+    /**
+     * Marks the frame as a delta frame
+     * \param delta boolean, if \a true the frame carries only changed rows
+     */
+    void setDelta(bool delta);
+
+    /**
+     * Sets the sequence number of the frame, given by the Subject
+     * \param sequence the sequence number, zero if the frame is not numbered
+     */
+    void setSequence(quint32 sequence);
+
+    /**
+     * Sets the base of a delta frame. The delta carries every row changed
+     * after the frame \a base, so it patches any frame drawn from \a base
+     * to the one just before it.
+     * \param base the sequence number of the oldest frame it patches
+     */
+    void setBase(quint32 base);
+
+    /**
+     * Starts a new row. Every value set after this call belongs to it.
+     */
+    void addRow();
+
+    /**
+     * Sets a numeric value in the current row
+     * \param column the column index
+     * \param value the numeric value
+     */
+    void setNumber(int column, double value);
+
+    /**
+     * Sets a boolean value in the current row
+     * \param column the column index
+     * \param value the boolean value
+     */
+    void setBool(int column, bool value);
+
+    /**
+     * Sets a textual value in the current row
+     * \param column the column index
+     * \param value a pointer to an UTF-8 string
+     * \param size the number of bytes of \a value
+     */
+    void setText(int column, const char *value, int size);
+
+    /**
+     * Gets the number of rows
+     */
+    int rows() const;
+
+    /**
+     * Gets the names of the columns that received values of more than one type
+     * \see QStringList
+     */
+    QStringList getMixedColumns() const;
+
+    /**
+     * Serializes the frame
+     * \return the frame in a contiguous byte array
+     * \see QByteArray
+     */
+    QByteArray toByteArray();
+
+private:
+    struct Column
+    {
+        QString name;
+        TypesOfData type;
+        QVector<double> numbers;
+        QVector<uchar> bools;
+        QVector<quint32> textEnds;
+        QByteArray text;
+        QVector<uchar> valid;
+        bool mixed;
+    };
+
+    /**
+     * Fills the column with rows without a value until \a size
+     */
+    void fill(Column &col, int size);
+
+    /**
+     * Prepares the column to receive a value in the current row
+     * \return \a false if the column has another type or the row already has a value
+     */
+    bool accept(Column &col, TypesOfData type);
+
+    QVector<Column> columns;
+    QHash<QString, int> columnsIndex;
+    int subjectId;
+    TypesOfSubjects subjectType;
+    int rowCount;
+    bool delta;
+    quint32 sequence;
+    quint32 base;
+};
+
+/**
+ * \brief Zero-copy reader of a binary frame.
+ * It does not own nor copy the frame content, so the memory must be
+ * kept alive while the reader is in use.
+ * \file binaryFrame.h
+ */
+class BinaryFrameReader
+{
+public:
+    /**
+     * Constructor. The frame is only valid if every column, mask and text
+     * offset lies within the given size, as the frames come from the network
+     * \param data a pointer to the beginning of the frame
+     * \param size the number of bytes of the frame
+     */
+    BinaryFrameReader(const char *data, int size);
+
+    /**
+     * Checks if \a data starts with a binary frame
+     * \param data a pointer to the data
+     * \param size the number of bytes of \a data
+     */
+    static bool isBinaryFrame(const char *data, int size);
+
+    /**
+     * Returns \a true if the frame is well formed
+     */
+    bool isValid() const;
+
+    /**
+     * Returns \a true if the frame carries only the changed rows
+     */
+    bool isDelta() const;
+
+    /**
+     * Gets the sequence number of the frame
+     */
+    quint32 getSequence() const;
+
+    /**
+     * Gets the sequence number of the oldest frame patched by a delta frame
+     */
+    quint32 getBase() const;
+
+    /**
+     * Gets the unique identifier of the Subject
+     */
+    int getSubjectId() const;
+
+    /**
+     * Gets the type of the Subject
+     */
+    TypesOfSubjects getSubjectType() const;
+
+    /**
+     * Gets the number of rows
+     */
+    int rows() const;
+
+    /**
+     * Gets the number of columns
+     */
+    int columns() const;
+
+    /**
+     * Gets the index of a column or -1 if it does not exist
+     * \param name the attribute name
+     */
+    int indexOf(const QString &name) const;
+
+    /**
+     * Gets the name of a column
+     */
+    const QString & columnName(int column) const;
+
+    /**
+     * Gets the data type of a column
+     * \see TypesOfData
+     */
+    TypesOfData columnType(int column) const;
+
+    /**
+     * Returns \a true if a row of a column does not have a value
+     */
+    bool isNull(int column, int row) const;
+
+    /**
+     * Gets a value of a numeric column
+     */
+    double number(int column, int row) const;
+
+    /**
+     * Gets a value of a boolean column
+     */
+    bool boolean(int column, int row) const;
+
+    /**
+     * Gets a value of a text column
+     * \see QString
+     */
+    QString text(int column, int row) const;
+
+    /**
+     * Gets a pointer to the UTF-8 content of a text column value
+     * \param size receives the number of bytes of the value
+     */
+    const char * rawText(int column, int row, int &size) const;
+
+private:
+    const char *data;
+    int size;
+    bool valid;
+    BinaryFrameHeader header;
+    QVector<BinaryColumnHeader> schema;
+    QVector<QString> names;
+};
+
+} // namespace TerraMEObserver
+
+#endif // BINARY_FRAME_H
@@ -22,9 +22,13 @@ of this software and its documentation.
 *************************************************************************************/
 
 #include "decoder.h"
+#include "binaryFrame.h"
 
+#include <QBuffer>
 #include <QStringList>
 
+#include <limits>
+
 using namespace TerraMEObserver;
 
 Decoder::Decoder(QHash<QString, Attributes *> *map) : mapAttributes(map) {}
@@ -55,6 +59,205 @@ bool Decoder::decode(const QString &protocol,
     return ret;
 }
 
+// Rows without a value are drawn as the cells without the attribute
+static double numberValue(const BinaryFrameReader &reader, int column, int row)
+{
+    if (reader.isNull(column, row))
+        return std::numeric_limits<double>::quiet_NaN();
+
+    if (reader.columnType(column) == TObsBool)
+        return reader.boolean(column, row) ? 1 : 0;
+
+    return reader.number(column, row);
+}
+
+static QString textValue(const BinaryFrameReader &reader, int column, int row)
+{
+    if (reader.isNull(column, row))
+        return VALUE_NOT_INFORMED;
+
+    if (reader.columnType(column) == TObsBool)
+        return reader.boolean(column, row) ? "true" : "false";
+
+    return reader.text(column, row);
+}
+
+// Boolean columns are drawn as numbers (0 and 1), unless the legend uses texts
+static TypesOfData valueType(const BinaryFrameReader &reader, int column, Attributes *attrib)
+{
+    TypesOfData type = reader.columnType(column);
+
+    if (type == TObsBool)
+        return attrib->getDataType() == TObsText ? TObsText : TObsNumber;
+
+    return type;
+}
+
+bool Decoder::decode(const QByteArray &frame, Attributes *attrib)
+{
+    BinaryFrameReader reader(frame.constData(), frame.size());
+
+    if (!reader.isValid())
+        return false;
+
+    parentSubjectType = reader.getSubjectType();
+
+    if (reader.isDelta())
+        return patch(reader, attrib);
+
+    int rows = reader.rows();
+    int xCol = reader.indexOf("x");
+    int yCol = reader.indexOf("y");
+    int valueCol = reader.indexOf(attrib->getName());
+
+    QVector<double> *xs = attrib->getXsValue();
+    QVector<double> *ys = attrib->getYsValue();
+
+    if ((xCol >= 0) && (reader.columnType(xCol) == TObsNumber))
+    {
+        xs->reserve(xs->size() + rows);
+        for (int i = 0; i < rows; i++)
+            xs->append(reader.number(xCol, i));
+    }
+
+    if ((yCol >= 0) && (reader.columnType(yCol) == TObsNumber))
+    {
+        ys->reserve(ys->size() + rows);
+        for (int i = 0; i < rows; i++)
+            ys->append(reader.number(yCol, i));
+    }
+
+    if (valueCol < 0)
+        return true;
+
+    switch (valueType(reader, valueCol, attrib))
+    {
+        case TObsNumber:
+            if (attrib->getDataType() == TObsUnknownData)
+                attrib->setDataType(TObsNumber);
+
+            attrib->getNumericValues()->reserve(rows);
+            for (int i = 0; i < rows; i++)
+                attrib->addValue(numberValue(reader, valueCol, i));
+            break;
+
+        case TObsText:
+            if (attrib->getDataType() == TObsUnknownData)
+                attrib->setDataType(TObsText);
+
+            attrib->getTextValues()->reserve(rows);
+            for (int i = 0; i < rows; i++)
+                attrib->addValue(textValue(reader, valueCol, i));
+            break;
+
+        case TObsDateTime:
+        default:
+            break;
+    }
+    return true;
+}
+
+bool Decoder::patch(const BinaryFrameReader &reader, Attributes *attrib)
+{
+    int indexCol = reader.indexOf(DELTA_INDEX_KEY);
+    int xCol = reader.indexOf("x");
+    int yCol = reader.indexOf("y");
+    int valueCol = reader.indexOf(attrib->getName());
+
+    if (indexCol < 0)
+        return false;
+
+    QVector<double> *xs = attrib->getXsValue();
+    QVector<double> *ys = attrib->getYsValue();
+    QVector<double> *numbers = attrib->getNumericValues();
+    QVector<QString> *texts = attrib->getTextValues();
+
+    TypesOfData type = (valueCol < 0) ? TObsUnknownData : valueType(reader, valueCol, attrib);
+
+    // the values kept by the attribute must be the ones of the previous frame
+    if (((type == TObsNumber) && (numbers->size() != xs->size()))
+        || ((type == TObsText) && (texts->size() != xs->size())))
+        return false;
+
+    for (int i = 0; i < reader.rows(); i++)
+    {
+        int row = (int) reader.number(indexCol, i);
+
+        if ((row < 0) || (row >= xs->size()) || (row >= ys->size()))
+            return false;
+
+        if (xCol >= 0)
+            (*xs)[row] = reader.number(xCol, i);
+
+        if (yCol >= 0)
+            (*ys)[row] = reader.number(yCol, i);
+
+        if (type == TObsNumber)
+            (*numbers)[row] = numberValue(reader, valueCol, i);
+        else if (type == TObsText)
+            (*texts)[row] = textValue(reader, valueCol, i);
+    }
+    return true;
+}
+
+bool Decoder::isDelta(const QByteArray &frame)
+{
+    return BinaryFrameReader(frame.constData(), frame.size()).isDelta();
+}
+
+quint32 Decoder::getSequence(const QByteArray &frame)
+{
+    return BinaryFrameReader(frame.constData(), frame.size()).getSequence();
+}
+
+quint32 Decoder::getBase(const QByteArray &frame)
+{
+    return BinaryFrameReader(frame.constData(), frame.size()).getBase();
+}
+
+bool Decoder::readState(QDataStream &state, QByteArray &frame, QString &protocol)
+{
+    QIODevice *device = state.device();
+    int prefixSize = sizeof(quint32) + sizeof(BINARY_FRAME_MAGIC);
+    QByteArray prefix;
+
+    if (device)
+        prefix = device->peek(prefixSize);
+
+    // a QString is serialized as its size followed by UTF-16 characters,
+    // therefore it never begins with the magic of a binary frame
+    if ((prefix.size() < prefixSize)
+        || (!BinaryFrameReader::isBinaryFrame(prefix.constData() + sizeof(quint32),
+                                              prefix.size() - sizeof(quint32))))
+    {
+        state >> protocol;
+        return false;
+    }
+
+    QBuffer *buffer = qobject_cast<QBuffer *>(device);
+    if (buffer)
+    {
+        quint32 size = 0;
+        state >> size;
+
+        const QByteArray &data = buffer->data();
+        qint64 pos = buffer->pos();
+
+        if (pos + size <= data.size())
+        {
+            // shares the memory of the buffer instead of copying the frame
+            frame = QByteArray::fromRawData(data.constData() + pos, size);
+            state.skipRawData(size);
+            return true;
+        }
+        frame.clear();
+        return false;
+    }
+
+    state >> frame;
+    return true;
+}
+
 bool Decoder::interpret(QStringList &tokens, int &idx,
                         QVector<double> &xs, QVector<double> &ys)
 {
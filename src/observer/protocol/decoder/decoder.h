@@ -33,6 +33,8 @@ of this software and its documentation.
 
 namespace TerraMEObserver {
 
+class BinaryFrameReader;
+
 /**
  * \brief Decoder class for comunication protocol
  * \author Antonio Jos? da Cunha Rodrigues
@@ -63,7 +65,58 @@ public:
      */
     bool decode(const QString &protocol, QVector<double> &xs, QVector<double> &ys);
 
+    /**
+     * Decodes the values of an attribute from a binary frame. The frame
+     * is read in place, without splitting or copying it.
+     * \param frame the state in the binary format
+     * \param attrib a pointer to the attribute that receives the values
+     * \see BinaryFrameReader
+     * \see QByteArray
+     */
+    bool decode(const QByteArray &frame, Attributes *attrib);
+
+    /**
+     * Reads the next state of a serialized stream. The subjects send a
+     * binary frame or, for backward compatibility, a text state.
+     * \param state the serialized state
+     * \param frame receives the binary frame, sharing the stream memory
+     * when it is possible
+     * \param protocol receives the state in the text format
+     * \return \a true if the state is a binary frame
+     * \see QDataStream, \see QByteArray, \see QString
+     */
+    static bool readState(QDataStream &state, QByteArray &frame, QString &protocol);
+
+    /**
+     * Checks if a binary frame carries only the rows changed since its
+     * base frame. The values of a delta frame are patched in place,
+     * so the attribute must not be cleared before decoding it.
+     * \param frame the state in the binary format
+     * \see QByteArray
+     */
+    static bool isDelta(const QByteArray &frame);
+
+    /**
+     * Gets the sequence number of a binary frame
+     * \param frame the state in the binary format
+     * \return the sequence number or zero if the frame is not numbered
+     */
+    static quint32 getSequence(const QByteArray &frame);
+
+    /**
+     * Gets the sequence number of the oldest frame patched by a delta frame
+     * \param frame the state in the binary format
+     */
+    static quint32 getBase(const QByteArray &frame);
+
 private:
+    /**
+     * Patches the values of an attribute with the rows of a delta frame
+     * \param reader the delta frame
+     * \param attrib a pointer to the attribute that holds the previous values
+     */
+    bool patch(const BinaryFrameReader &reader, Attributes *attrib);
+
     /**
      * Copy constructor
      */
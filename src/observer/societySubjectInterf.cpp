@@ -28,6 +28,7 @@ of this software and its documentation.
 #include "types/observerTextScreen.h"
 #include "types/observerGraphic.h"
 #include "types/observerUDPSender.h"
+#include "types/observerTCPSender.h"
 #include "types/agentObserverMap.h"
 
 Observer * SocietySubjectInterf::createObserver(TypesOfObservers type)
@@ -49,6 +50,10 @@ Observer * SocietySubjectInterf::createObserver(TypesOfObservers type)
         case TObsUDPSender:
             obs = new ObserverUDPSender(this);
             break;
+
+        case TObsTCPSender:
+            obs = new ObserverTCPSender(this);
+            break;
 		case TObsNeigh:
 			obs = new AgentObserverMap(this);
 			break;
@@ -90,6 +95,11 @@ bool SocietySubjectInterf::kill(int id)
             delete(ObserverUDPSender *)obs;
             break;
 
+        case TObsTCPSender:
+           ((ObserverTCPSender *)obs)->close();
+            delete(ObserverTCPSender *)obs;
+            break;
+
         case TObsTextScreen:
            ((ObserverTextScreen *)obs)->close();
             delete(ObserverTextScreen *)obs;
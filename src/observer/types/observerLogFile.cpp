@@ -22,10 +22,12 @@ of this software and its documentation.
 *************************************************************************************/
 
 #include "observerLogFile.h"
+#include "../protocol/decoder/binaryFrame.h"
 
 #include <QApplication>
 #include <QMessageBox>
 #include <QTextStream>
+#include <QtEndian>
 
 ObserverLogFile::ObserverLogFile() : QObject()
 {
@@ -41,12 +43,21 @@ ObserverLogFile::ObserverLogFile(Subject *subj)
 ObserverLogFile::~ObserverLogFile()
 {
     // wait();
+    close();
+    delete block;
 }
 
 void ObserverLogFile::init()
 {
     observerType = TObsLogFile;
     subjectType = TObsUnknown;
+    subjectId = -1;
+
+    block = 0;
+    bufferSize = 0;
+    flushInterval = 0;
+    binary = false;
+    compress = false;
 
     paused = false;
     header = false;
@@ -70,11 +81,7 @@ bool ObserverLogFile::draw(QDataStream &state)
     state >> msg;
     QStringList tokens = msg.split(PROTOCOL_SEPARATOR);
 
-    //double num;
-    //QString text;
-    //bool b;
-
-    //QString subjectId = tokens.at(0);
+    subjectId = tokens.at(0).toInt();
     subjectType =(TypesOfSubjects) tokens.at(1).toInt();
     int qtdParametros = tokens.at(2).toInt();
     //int nroElems = tokens.at(3).toInt();
@@ -82,33 +89,19 @@ bool ObserverLogFile::draw(QDataStream &state)
 
     for (int i = 0; i < qtdParametros; i++)
     {
-        QString key = tokens.at(j);
+        int col = attribColumns.value(tokens.at(j), -1);
         j++;
         int typeOfData = tokens.at(j).toInt();
         j++;
 
-        bool contains = attribList.contains(key);
-
-        switch (typeOfData)
+        if (col >= 0)
         {
-            case(TObsBool):
-                if (contains)
-                    valuesList.replace(attribList.indexOf(key),
-                                      (tokens.at(j).toInt() ? "true" : "false"));
-                break;
-
-            case(TObsDateTime):
-                //break;
+            valuesTypes[col] = typeOfData;
 
-            case(TObsNumber):
-                if (contains)
-                    valuesList.replace(attribList.indexOf(key), tokens.at(j));
-                break;
-
-            default:
-                if (contains)
-                    valuesList.replace(attribList.indexOf(key), tokens.at(j));
-                break;
+            if (typeOfData == TObsBool)
+                valuesList[col] = tokens.at(j).toInt() ? "true" : "false";
+            else
+                valuesList[col] = tokens.at(j);
         }
         j++;
     }
@@ -119,6 +112,9 @@ bool ObserverLogFile::draw(QDataStream &state)
 
 void ObserverLogFile::setFileName(QString name)
 {
+    if (file.isOpen())
+        close();
+
     fileName = name;
 }
 
@@ -129,9 +125,19 @@ void ObserverLogFile::setSeparator(QString sep)
 
 void ObserverLogFile::setAttributes(QStringList &attribs)
 {
+    // the rows of the binary block have the previous columns
+    closeBlock();
+
     attribList = attribs;
+    attribColumns.clear();
+    valuesList.clear();
+    valuesTypes.fill(TObsUnknownData, attribList.size());
+
     for (int i = 0; i < attribList.size(); i++)
+    {
         valuesList.insert(i, QString("")); // lista dos itens na ordem em que aparecem
+        attribColumns.insert(attribList.at(i), i);
+    }
     header = true;
 }
 
@@ -140,59 +146,155 @@ bool ObserverLogFile::headerDefined()
     return header;
 }
 
-bool ObserverLogFile::write()
+bool ObserverLogFile::open()
 {
-    QFile file(fileName);
+    if (file.isOpen())
+        return true;
 
+    file.setFileName(fileName);
+
+    // the file is always appended, so other observers can share it
+    QIODevice::OpenMode openMode = QIODevice::WriteOnly | QIODevice::Append;
+    if (!binary)
+        openMode |= QIODevice::Text;
     if (mode == QString("w"))
-    {
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
-        {
-            QMessageBox::information(0, QObject::tr("Erro ao abrir arquivo"),
-                                     QObject::tr("N?o foi poss?vel abrir o arquivo de log \"%1\".\n%2")
-                                     .arg(this->fileName).arg(file.errorString()	));
-            return false;
-        }
+        openMode |= QIODevice::Truncate;
 
-        QString headers;
-        for (int i = 0; i < attribList.size(); ++i)
-        {
-            headers += attribList.at(i);
+    if (!file.open(openMode))
+    {
+        QMessageBox::information(0, QObject::tr("Erro ao abrir arquivo"),
+                                 QObject::tr("N?o foi poss?vel abrir o arquivo de log \"%1\".\n%2")
+                                 .arg(this->fileName).arg(file.errorString()	));
+        return false;
+    }
 
-            if (i < attribList.size() - 1)
-                headers += separator;
-        }
-        header = false;
+    if (mode == QString("w") && !binary)
+    {
+        QString headers = attribList.join(separator);
         headers += "\n";
-        file.write(headers.toLatin1().data(),  qstrlen(headers.toLatin1().data()));
+        buffer.append(headers.toLatin1());
+    }
+
+    header = false;
+    mode = "w+";
+    lastFlush.start();
+    return true;
+}
+
+void ObserverLogFile::writeRow()
+{
+    // a column keeps a single type, therefore a value of another type starts a new block
+    for (int i = 0; block && (i < valuesList.size()); i++)
+    {
+        if ((valuesTypes.at(i) != TObsUnknownData) && (blockTypes.at(i) != TObsUnknownData)
+            && (valuesTypes.at(i) != blockTypes.at(i)))
+            closeBlock();
+    }
+
+    if (!block)
+    {
+        block = new BinaryFrameWriter(subjectId, subjectType);
+        blockTypes.fill(TObsUnknownData, attribList.size());
 
-        mode = "w+";
+        for (int i = 0; i < attribList.size(); i++)
+            block->addColumn(attribList.at(i));
     }
-    else
+
+    block->addRow();
+
+    for (int i = 0; i < valuesList.size(); i++)
     {
-        if (!file.open(QIODevice::Append | QIODevice::Text))
+        switch (valuesTypes.at(i))
         {
-            QMessageBox::information(0, QObject::tr("Erro ao abrir arquivo"),
-                                     QObject::tr("N?o foi poss?vel abrir o arquivo de log \"%1\".\n%2")
-                                     .arg(this->fileName).arg(file.errorString()	));
-            return false;
+            case TObsBool:
+                block->setBool(i, valuesList.at(i) == "true");
+                break;
+
+            case TObsNumber:
+                block->setNumber(i, valuesList.at(i).toDouble());
+                break;
+
+            case TObsText:
+            {
+                QByteArray text = valuesList.at(i).toUtf8();
+                block->setText(i, text.constData(), text.size());
+                break;
+            }
+
+            default:
+                // attributes not received yet stay null, without defining the column type
+                continue;
         }
+        blockTypes[i] = valuesTypes.at(i);
     }
+}
+
+void ObserverLogFile::closeBlock()
+{
+    if (!block)
+        return;
 
-    QString text;
-    for (int i = 0; i < valuesList.size(); ++i)
+    if (block->rows() > 0)
     {
-        text += valuesList.at(i);
+        QByteArray data = block->toByteArray();
+        if (compress)
+            data = qCompress(data, 1);
+
+        uchar size[4];
+        qToBigEndian<quint32>(data.size(), size);
+        buffer.append((const char *) size, 4);
+        buffer.append(data);
+    }
+
+    delete block;
+    block = 0;
+}
+
+bool ObserverLogFile::write()
+{
+    if (!open())
+        return false;
+
+    int pending;
 
-        if (i < attribList.size() - 1) text += separator;
+    if (binary)
+    {
+        writeRow();
+        pending = buffer.size() + block->rows() * attribList.size() * sizeof(double);
+    }
+    else
+    {
+        buffer.append(valuesList.join(separator).toLatin1());
+        buffer.append('\n');
+        pending = buffer.size();
     }
 
-    text.append("\n");
-    file.write(text.toLatin1().data(), qstrlen(text.toLatin1().data()));
-    file.close();
+    if (pending >= bufferSize
+        || (flushInterval > 0 && lastFlush.elapsed() >= flushInterval))
+        return flush();
+
     return true;
 }
 
+bool ObserverLogFile::flush()
+{
+    if (!file.isOpen())
+        return true;
+
+    closeBlock();
+
+    bool ok = true;
+    if (!buffer.isEmpty())
+    {
+        ok = file.write(buffer) == buffer.size();
+        buffer.clear();
+    }
+
+    file.flush();
+    lastFlush.restart();
+    return ok;
+}
+
 void ObserverLogFile::setWriteMode(QString mode)
 {
     this->mode = mode;
@@ -203,6 +305,22 @@ QString ObserverLogFile::getWriteMode()
     return mode;
 }
 
+void ObserverLogFile::setBufferSize(int size)
+{
+    bufferSize = size;
+}
+
+void ObserverLogFile::setFlushInterval(double seconds)
+{
+    flushInterval = (qint64) (seconds * 1000);
+}
+
+void ObserverLogFile::setFormat(QString format, bool compress)
+{
+    binary = format == QString("binary");
+    this->compress = binary && compress;
+}
+
 void ObserverLogFile::run()
 {
     ////while (!paused)
@@ -225,6 +343,8 @@ QStringList ObserverLogFile::getAttributes()
 int ObserverLogFile::close()
 {
     // QThread::exit(0);
+    flush();
+    file.close();
     return 0;
 }
 
@@ -30,6 +30,10 @@ of this software and its documentation.
 #include <QString>
 #include <QStringList>
 #include <QFile>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QVector>
 #include <QThread>
 #include <QCloseEvent>
 
@@ -37,6 +41,8 @@ of this software and its documentation.
 
 namespace TerraMEObserver {
 
+class BinaryFrameWriter;
+
 /**
  * \brief Saves the observed attributes in a log file
  * \see QObject
@@ -127,6 +133,38 @@ public:
      */
     QString getWriteMode();
 
+    /**
+     * Sets the number of bytes kept in memory before writing them into the file
+     * \param size the buffer size in bytes. If it is zero, each update
+     * is written and flushed as soon as it arrives
+     */
+    void setBufferSize(int size = 0);
+
+    /**
+     * Sets the maximum time that an update can wait in the buffer
+     * \param seconds the interval in seconds. If it is zero, the buffer
+     * is written only when it is full or when the observer is closed
+     */
+    void setFlushInterval(double seconds = 0);
+
+    /**
+     * Sets the format of the file
+     * \param format "csv" for text lines or "binary" for a sequence of
+     * columnar blocks. Each binary block is a 32 bits big-endian size
+     * followed by a BinaryFrameWriter frame with the buffered updates.
+     * Attributes without a value are null in the block and a new block
+     * starts whenever an attribute changes its type
+     * \param compress boolean, if \a true each binary block is compressed
+     * with qCompress
+     * \see QString
+     */
+    void setFormat(QString format = "csv", bool compress = false);
+
+    /**
+     * Writes the buffered updates into the file
+     */
+    bool flush();
+
     /**
      * Gets the type of observer
      * \see TypesOfObservers
@@ -166,17 +204,45 @@ private:
      */
     bool write();
 
+    /**
+     * Opens the file in the first write, using the write mode
+     */
+    bool open();
+
+    /**
+     * Appends the current values as a row of the binary block
+     */
+    void writeRow();
+
+    /**
+     * Moves the binary block to the buffer
+     */
+    void closeBlock();
+
 
     TypesOfObservers observerType;
     TypesOfSubjects subjectType;
+    int subjectId;
 
     QStringList attribList, valuesList;
+    QHash<QString, int> attribColumns;
+    QVector<int> valuesTypes;
     QString fileName;
     QString separator;
     bool header;
     //WriteMode mode;
     QString mode;
 
+    QFile file;
+    QByteArray buffer;
+    BinaryFrameWriter *block;
+    QVector<int> blockTypes; ///< type of each column of the binary block
+    int bufferSize;
+    qint64 flushInterval;
+    QElapsedTimer lastFlush;
+    bool binary;
+    bool compress;
+
     bool paused;
 };
 
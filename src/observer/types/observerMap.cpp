@@ -90,6 +90,7 @@ void ObserverMap::init()
     legendWindow = 0;		// ponteiro para LegendWindow, instanciado no m?todo setHeaders
 
     builtLegend = 0;
+    frameReceived = 0;
     positionZoomVec = -1;
     zoomIdx = 11;
     actualZoom = 1.;
@@ -127,7 +128,21 @@ bool ObserverMap::draw(QDataStream &state)
 {
     bool decoded = false;
     QString msg;
-    state >> msg;
+    QByteArray frame;
+    bool binary = Decoder::readState(state, frame, msg);
+    bool delta = binary && Decoder::isDelta(frame);
+    quint32 sequence = binary ? Decoder::getSequence(frame) : 0;
+
+    // a delta frame carries the rows changed after its base, so it
+    // patches any frame drawn from the base on
+    if (delta && ((frameReceived == 0) || (frameReceived < Decoder::getBase(frame))
+                  || (frameReceived >= sequence)))
+    {
+        frameReceived = 0;
+        return false;
+    }
+
+    bool complete = true;
 
     QList<Attributes *> listAttribs = mapAttributes->values();
     Attributes * attrib = 0;
@@ -138,17 +153,25 @@ bool ObserverMap::draw(QDataStream &state)
         attrib = listAttribs.at(i);
         if (attrib->getType() == TObsCell)
         {
-            attrib->clear();
+            if (!delta)
+                attrib->clear();
 
-            decoded = protocolDecoder->decode(msg, *attrib->getXsValue(), *attrib->getYsValue());
+            if (binary)
+                decoded = protocolDecoder->decode(frame, attrib);
+            else
+                decoded = protocolDecoder->decode(msg, *attrib->getXsValue(), *attrib->getYsValue());
             if (decoded)
                 painterWidget->plotMap(attrib);
+            else
+                complete = false;
         }
         qApp->processEvents();
     }
 
     connectTreeLayerSlot(true);
 
+    frameReceived = complete ? sequence : 0;
+
     // cria a legenda e exibe na tela
 	//@RAIAN: Troquei esta comparacao porque nao estava criando a legenda da segunda camada (No meu caso, a vizinhanca)
     //if (/*decoded &&*/ legendWindow && (builtLegend < 1))
@@ -590,6 +613,11 @@ QTreeWidget * ObserverMap::getTreeLayers()
     return treeLayers;
 }
 
+quint32 ObserverMap::getFrameReceived() const
+{
+    return frameReceived;
+}
+
 const QSize ObserverMap::getCellSpaceSize()
 {
     return QSize(newWidthCellSpace, newHeightCellSpace);
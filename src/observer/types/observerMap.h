@@ -123,6 +123,13 @@ public:
      */
     const QSize getCellSpaceSize();
 
+    /**
+     * Gets the sequence number of the last binary frame completely drawn.
+     * The Subject only sends a delta frame whose base is not after this frame.
+     * \return the sequence number or zero if the map does not hold a numbered frame
+     */
+    quint32 getFrameReceived() const;
+
 	void save(string, string);
 
     /**
@@ -330,6 +337,7 @@ private:
     LegendWindow *legendWindow;
     Decoder *protocolDecoder;
     int builtLegend;
+    quint32 frameReceived;
 
     bool needResizeImage;
     double 	newWidthCellSpace, newHeightCellSpace;
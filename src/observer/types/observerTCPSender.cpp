@@ -23,154 +23,216 @@ of this software and its documentation.
 
 #include "observerTCPSender.h"
 
-#include <QtNetwork>
-
-//#include "senderGUI.h"
-//#include "tcpSocketTask.h"
-
-//#include "taskManager.h"
-//#include "worker.h"
-
-#ifdef TME_BLACK_BOARD
-	#include "blackBoard.h"
-//	#include "subjectAttributes.h"
-#endif
+#include <QApplication>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <QtNetwork/QTcpSocket>
 
 using namespace TerraMEObserver;
 
-//ObserverTCPSender::ObserverTCPSender(Subject *subj, QObject *parent)
-//    : QObject(parent), ObserverInterf(subj)
-//{
-//	int i = 1;
-/*
+// Time, in milliseconds, to wait for a connection or for writing a frame
+static const int TCP_TIMEOUT = 1000;
+static const int COMPRESS_RATIO = 6;
+
+ObserverTCPSender::ObserverTCPSender(Subject *subj)
+    : QThread(), ObserverInterf(subj)
+{
     observerType = TObsTCPSender;
-    subjectType = subj->getType(); // TO_DO: Changes it to Observer pattern
-    tcpSocketTask = 0;
+    subjectType = TObsUnknown;
 
-    //tcpSocketTask = new TcpSocketTask();
-    //tcpSocketTask->setCompress(false);
+    port = DEFAULT_PORT;
+    compress = false;
 
-    //connect(tcpSocketTask, SIGNAL(messageSent(const QString &)), this, SLOT(messageSent(const QString &)));
-    //connect(tcpSocketTask, SIGNAL(messageFailed(const QString &)), this, SLOT(messageFailed(const QString &)));
-    //connect(tcpSocketTask, SIGNAL(statusMessage(int, int)), this, SLOT(statusMessage(int, int)));
-    //// connect(tcpSocketTask, SIGNAL(connected()), this, SLOT(connected()));
+    queueSize = DEFAULT_TCP_QUEUE_SIZE;
+    dropped = 0;
+    stateCount = 0;
+    sentCount = 0;
+    closing = false;
+    finished = false;
 
-    senderGUI = new SenderGUI();
+    senderGUI = new UdpSenderGUI();
     senderGUI->setWindowTitle("TCP Sender");
+    senderGUI->setCompressDatagram(compress);
 
-    addresses = new QList<QHostAddress>();
-*/
-//}
+    start(QThread::IdlePriority);
+}
 
-//ObserverTCPSender::~ObserverTCPSender()
-//{
-//	int i = 1;
-/*
-    // tcpSocketTask->disconnectFromHost();
-    // tcpSocketTask->waitForDisconnected(2000);
+ObserverTCPSender::~ObserverTCPSender()
+{
+    close();
+    delete senderGUI;
+}
 
-    // delete tcpSocketTask; tcpSocketTask = 0;
-    delete senderGUI; senderGUI = 0;
-    delete addresses; addresses = 0;
-*/
-//}
+const TypesOfObservers ObserverTCPSender::getType()
+{
+    return observerType;
+}
 
-bool ObserverTCPSender::draw(QDataStream& state)
+bool ObserverTCPSender::draw(QDataStream &state)
 {
-/*
-    bool drew = false;
+    QString msg;
+    state >> msg;
 
-    QByteArray stateAux;
-    state >> stateAux;
+    enqueue(msg.toLatin1(), 0);
+
+    int sent, lost;
+    {
+        QMutexLocker locker(&mutex);
+        sent = sentCount;
+        lost = dropped;
+    }
+
+    stateCount++;
+    senderGUI->setStateSent(sent);
+    senderGUI->setMessagesSent(stateCount);
+
+    if (lost > 0)
+        senderGUI->setSpeed(QObject::tr("%1 states discarded").arg(lost));
+
+    qApp->processEvents();
+    return true;
+}
+
+void ObserverTCPSender::enqueue(const QByteArray &data, quint8 flags)
+{
+    QMutexLocker locker(&mutex);
 
-    // qDebug() << "stateAux.size(): " << stateAux.size();
+    if (closing || finished)
+        return;
 
-    if (!stateAux.isEmpty())
+    if (flags & TCP_FRAME_END)
+        finished = true;
+
+    // the end of the simulation is never discarded
+    for (int i = 0; (queue.size() >= queueSize) && (i < queue.size()); )
+    {
+        if (queue.at(i).flags & TCP_FRAME_END)
+        {
+            i++;
+        }
+        else
+        {
+            queue.removeAt(i);
+            dropped++;
+        }
+    }
+
+    Frame frame;
+    frame.data = data;
+    frame.flags = flags;
+    queue.append(frame);
+
+    pending.wakeOne();
+}
+
+void ObserverTCPSender::run()
+{
+    QList<QTcpSocket *> sockets;
+
+    forever
     {
-        static bool socket = false;
-        if (!socket)
+        Frame frame;
+        bool compressed;
+        QStringList targets;
+        int targetPort;
+        {
+            QMutexLocker locker(&mutex);
+
+            while (queue.isEmpty() && !closing)
+                pending.wait(&mutex);
+
+            if (queue.isEmpty())
+                break;
+
+            frame = queue.takeFirst();
+            compressed = compress;
+            targets = hosts;
+            targetPort = port;
+
+            while (sockets.size() < hosts.size())
+                sockets.append(new QTcpSocket());
+        }
+
+        if (compressed)
         {
-            tcpSocketTask = new TcpSocketTask();
-
-            connect(tcpSocketTask, SIGNAL(messageSent(const QString &)),
-            		senderGUI, SLOT(appendMessage(const QString &)));
-                // , Qt::DirectConnection);
-            connect(tcpSocketTask, SIGNAL(messageFailed(const QString &)),
-            		senderGUI, SLOT(messageFailed(const QString &)));
-            connect(tcpSocketTask, SIGNAL(statusMessages(int)),
-            		senderGUI, SLOT(statusMessages(int)) //, Qt::DirectConnection);
-            connect(tcpSocketTask, SIGNAL(statusStates(int)),
-            		senderGUI, SLOT(statusStates(int)) //, Qt::DirectConnection);
-            // connect(tcpSocketTask, SIGNAL(disconnected()), this, SLOT(deleteLater()));
-            connect(tcpSocketTask, SIGNAL(connected()), this, SLOT(connected()));
-            connect(tcpSocketTask, SIGNAL(speed(const QString &)),
-            		senderGUI, SLOT(setSpeed(const QString &)) //, Qt::DirectConnection);
-
-            connect(this, SIGNAL(addState(const QByteArray &)),
-            		tcpSocketTask, SLOT(addState(const QByteArray &)),
-                Qt::DirectConnection);
-                // Qt::QueuedConnection);
-            connect(this, SIGNAL(setModelTimeSignal(double)),
-            		tcpSocketTask, SLOT(setModelTime(double)),
-                Qt::DirectConnection);
-            connect(this, SIGNAL(abort()), tcpSocketTask, SLOT(abort()),
-                Qt::DirectConnection);
-
-            tcpSocketTask->setCompress(compressed);
-            tcpSocketTask->connectToHost(addresses->first(), port);
-
-            // const BagOfTasks::Worker *w = tcpSocketTask->runExclusively();
-            // tcpSocketTask->moveToThread((QThread *) w);
-            tcpSocketTask->moveToThread((QThread *) tcpSocketTask->runExclusively());
-
-            socket = true;
+            frame.data = qCompress(frame.data, COMPRESS_RATIO);
+            frame.flags |= TCP_FRAME_COMPRESSED;
         }
 
-        BagOfTasks::TaskManager::getInstance().add(tcpSocketTask);
-        emit addState(stateAux);
-        qApp->processEvents();
+        bool sent = send(sockets, targets, targetPort, frame.data, frame.flags);
 
-        drew = true;
+        QMutexLocker locker(&mutex);
+        if (sent)
+        {
+            sentCount++;
+        }
+        else if (closing)
+        {
+            // the hosts are unreachable, so the observer does not wait for them
+            dropped += queue.size();
+            queue.clear();
+        }
     }
-    else
+
+    for (int i = 0; i < sockets.size(); i++)
     {
-        senderGUI->appendMessage(
-        		tr("The retrieved state is empty. There is nothing to do."));
+        QTcpSocket *socket = sockets.at(i);
+
+        if (socket->state() == QAbstractSocket::ConnectedState)
+        {
+            socket->disconnectFromHost();
+
+            if (socket->state() != QAbstractSocket::UnconnectedState)
+                socket->waitForDisconnected(TCP_TIMEOUT);
+        }
+        delete socket;
     }
+}
 
-    qApp->processEvents();
-    return drew;
-*/
-	return true;
+bool ObserverTCPSender::send(QList<QTcpSocket *> &sockets, const QStringList &targets,
+    int targetPort, const QByteArray &data, quint8 flags)
+{
+    uchar header[5];
+    qToBigEndian<quint32>(data.size() + 1, header);
+    header[4] = flags;
+
+    bool sent = true;
+
+    for (int i = 0; i < sockets.size(); i++)
+    {
+        QTcpSocket *socket = sockets.at(i);
+
+        if (socket->state() != QAbstractSocket::ConnectedState)
+        {
+            socket->abort();
+            socket->connectToHost(targets.at(i), targetPort);
+
+            if (!socket->waitForConnected(TCP_TIMEOUT))
+            {
+                sent = false;
+                continue;
+            }
+        }
+
+        socket->write((const char *) header, 5);
+        socket->write(data);
+
+        while (socket->bytesToWrite() > 0)
+        {
+            if (!socket->waitForBytesWritten(TCP_TIMEOUT))
+            {
+                socket->abort();
+                sent = false;
+                break;
+            }
+        }
+    }
+    return sent;
 }
 
 void ObserverTCPSender::setAttributes(QStringList &attribs)
 {
-/*
     attribList = attribs;
-
-#ifdef TME_BLACK_BOARD
-    SubjectAttributes *subjAttr = BlackBoard::getInstance().insertSubject(getSubjectId());
-    if (subjAttr)
-        subjAttr->setSubjectType(getSubjectType());
-#endif
-
-//#ifdef TME_BLACK_BOARD_
-//    Attributes *attrib = 0;
-//
-//    for (int i = 0; i < attribList.size(); i++)
-//    {
-//        if ((attribList.at(i) != "x") && (attribList.at(i) != "y"))
-//        {
-//            attrib =(Attributes *) &BlackBoard::getInstance()
-//                .addAttribute(getSubjectId(), attribList.at(i));
-//
-//            attrib->setVisible(true);
-//            attrib->setObservedBy(observerType);
-//        }
-//    }
-//#endif
-*/
 }
 
 QStringList ObserverTCPSender::getAttributes()
@@ -178,63 +240,66 @@ QStringList ObserverTCPSender::getAttributes()
     return attribList;
 }
 
-const TypesOfObservers ObserverTCPSender::getType() const
+void ObserverTCPSender::setPort(int prt)
 {
-    return observerType;
+    QMutexLocker locker(&mutex);
+    port = prt;
+    senderGUI->setPort(port);
+}
+
+int ObserverTCPSender::getPort()
+{
+    return port;
 }
 
 void ObserverTCPSender::addHost(const QString & host)
 {
-    addresses->append(QHostAddress(host));
+    QMutexLocker locker(&mutex);
+    hosts.append(host);
 }
 
-int ObserverTCPSender::close()
+void ObserverTCPSender::setCompress(bool on)
 {
-/*
-    emit abort();
-    senderGUI->close();
-*/
-    return 0;
+    QMutexLocker locker(&mutex);
+    compress = on;
+    senderGUI->setCompressDatagram(compress);
 }
 
-void ObserverTCPSender::show()
+void ObserverTCPSender::setQueueSize(int size)
 {
- //   senderGUI->showNormal();
+    QMutexLocker locker(&mutex);
+    queueSize = size < 1 ? 1 : size;
 }
 
-void ObserverTCPSender::setCompress(bool compress)
+int ObserverTCPSender::getDropped()
 {
-//    compressed = compress;
-//    senderGUI->setCompress(compress);
+    QMutexLocker locker(&mutex);
+    return dropped;
 }
 
 void ObserverTCPSender::setModelTime(double time)
 {
-//    if (time == -1)
-//        emit setModelTimeSignal(time);
+    if (time == -1)
+        enqueue(COMPLETE_SIMULATION.toLatin1(), TCP_FRAME_END);
 }
 
-bool ObserverTCPSender::connectTo(quint16 prt)
+int ObserverTCPSender::close()
 {
-    port = prt;
+    // killing the observer also ends the simulation for the hosts
+    enqueue(COMPLETE_SIMULATION.toLatin1(), TCP_FRAME_END);
 
-    //if (addresses->size() > 1)
-    //    qDebug() << "ObserverTCPSender - Sends for more than one client simultaneously did not implement yet";
+    {
+        QMutexLocker locker(&mutex);
+        closing = true;
+        pending.wakeOne();
+    }
 
-    //if (tcpSocketTask->connectToHost(addresses->first(), port))
-    //{
-    //    senderGUI->appendMessage(SenderGUI::tr("Connected on %1:%2 ")
-    //        .arg(addresses->first().toString())
-    //        .arg(port));
-    //    return true;
-    //}
-    //senderGUI->appendMessage(SenderGUI::tr("Conection fail: '%1'").arg(tcpSocketTask->errorString()));
-    return false;
+    wait();
+    senderGUI->close();
+    return 0;
 }
 
-void ObserverTCPSender::connected()
+void ObserverTCPSender::show()
 {
-    // Used only for debugging
-//    senderGUI->appendMessage("conectou!!");
+    senderGUI->showNormal();
 }
-
@@ -24,34 +24,55 @@ of this software and its documentation.
 #ifndef OBSERVER_TCPSENDER_H
 #define OBSERVER_TCPSENDER_H
 
-#include <QHostAddress>
+#include "../observerInterf.h"
+#include "udpSender/udpSenderGUI.h"
+
+#include <QByteArray>
 #include <QList>
+#include <QMutex>
 #include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
 
-#include "observerInterf.h"
-
-class SenderGUI;
+class QTcpSocket;
 
 namespace TerraMEObserver {
 
-class TcpSocketTask;
+/// Flag of a TCP frame whose payload was compressed with qCompress
+static const quint8 TCP_FRAME_COMPRESSED = 0x01;
+
+/// Flag of the TCP frame sent at the end of the simulation
+static const quint8 TCP_FRAME_END = 0x02;
+
+/// Default maximum number of states waiting to be sent
+static const int DEFAULT_TCP_QUEUE_SIZE = 8;
 
 /**
  * \brief Sends the attributes observed via TCP Protocol
+ * Each state is sent as a frame composed by its size (a 32 bits big-endian
+ * integer counting the flags and the payload), one byte of flags and the
+ * payload. The frames are sent by a thread of the observer, so the simulation
+ * never waits for the network. When the queue of states is full, the oldest
+ * state is discarded, because each state replaces the previous one.
  * \see ObserverInterf
+ * \see QThread
  * \author Antonio Jose da Cunha Rodrigues
  * \file observerTCPSender.h
  */
-class ObserverTCPSender : public QObject, public ObserverInterf
+class ObserverTCPSender : public QThread, public ObserverInterf
 {
-    Q_OBJECT
 public:
-    ObserverTCPSender(Subject *subj, QObject *parent = 0) {}
-    virtual ~ObserverTCPSender() {}
+    /**
+     * Constructor
+     * \param subj a pointer to a Subject
+     * \see Subject
+     */
+    ObserverTCPSender(Subject *subj);
 
-    bool connectTo(quint16 port);
-    void disconnectFromHost();
-    void addHost(const QString & host);
+    /**
+     * Destructor
+     */
+    virtual ~ObserverTCPSender();
 
     /**
      * \copydoc Observer::draw
@@ -73,15 +94,45 @@ public:
     /**
      * \copydoc Observer::getAttributes
      */
-    const TypesOfObservers getType() const;
+    const TypesOfObservers getType();
 
     /**
-     * \copydoc SenderTask::setCompress
+     * Sets the use of compression for the frames
+     * \param on boolean, if \a true sends compressed frames.
      */
     void setCompress(bool on);
 
     /**
-     * Closes the window and stops the thread execution
+     * Sets the communication port
+     * \param port the number of port
+     */
+    void setPort(int port);
+
+    /**
+     * Gets the communication port
+     */
+    int getPort();
+
+    /**
+     * Adds a host that receives the frames
+     * \param host the host name or ip
+     * \see QString
+     */
+    void addHost(const QString & host);
+
+    /**
+     * Sets the maximum number of states waiting to be sent
+     * \param size the queue size, at least one
+     */
+    void setQueueSize(int size = DEFAULT_TCP_QUEUE_SIZE);
+
+    /**
+     * Gets the number of states discarded because the queue was full
+     */
+    int getDropped();
+
+    /**
+     * Sends the remaining frames and the end of the simulation, then stops the thread
      */
     int close();
 
@@ -90,38 +141,60 @@ public:
      */
     void show();
 
-signals:
-    void addState(const QByteArray &);
-    void setModelTimeSignal(double t1);
-    void abort();
-
-public slots:
-    void connected();
-
 protected:
+    /**
+     * Runs the thread that sends the frames
+     * \see QThread
+     */
+    void run();
+
     /**
      * \copydoc Observer::setModelTime
      */
     void setModelTime(double time);
 
 private:
-    quint16 port;
-    int stateCount, msgCount;
-    int datagramSize;
-    double datagramRatio;
-    bool compressed;
+    /**
+     * Adds a state to the queue, discarding the oldest state if it is full
+     * \param data the state
+     * \param flags the frame flags
+     */
+    void enqueue(const QByteArray &data, quint8 flags);
+
+    /**
+     * Writes a frame in every socket, connecting them if necessary
+     * \param targets copy of the hosts taken under the mutex
+     * \param targetPort copy of the port taken under the mutex
+     * \return boolean, \a true if the frame was sent to all the hosts
+     */
+    bool send(QList<QTcpSocket *> &sockets, const QStringList &targets, int targetPort,
+        const QByteArray &data, quint8 flags);
+
+    struct Frame
+    {
+        QByteArray data;
+        quint8 flags;
+    };
 
     TypesOfObservers observerType;
     TypesOfSubjects subjectType;
 
-    TcpSocketTask *tcpSocketTask;
+    QStringList hosts;
+    int port;
+    bool compress;
+
+    QMutex mutex;
+    QWaitCondition pending;
+    QList<Frame> queue;
+    int queueSize;
+    int dropped, stateCount, sentCount;
+    bool closing, finished;
 
     QStringList attribList;
-    QList<QHostAddress> *addresses;
 
-    SenderGUI *senderGUI;
+    UdpSenderGUI *senderGUI;
 };
 
 } // namespace TerraMEObserver
 
-#endif // OBSERVERTCPSENDER_H
+#endif // OBSERVER_TCPSENDER_H
@@ -22,8 +22,10 @@ of this software and its documentation.
 *************************************************************************************/
 
 #include "observerUDPSender.h"
+#include "udpSender/udpFrame.h"
 
 #include <QtNetwork/QUdpSocket>
+#include <QtNetwork/QHostInfo>
 #include <QApplication>
 #include <QLabel>
 #include <QList>
@@ -37,10 +39,11 @@ extern ExecutionModes execModes;
 // Debug method for check state data
 void saveInFile(QString & msg);
 
-// Datagram default size
-static const int MINIMUM_DATAGRAM_SIZE = 1024;
 static const int COMPRESS_RATIO = 6;
 
+// Number of frames kept for resending lost chunks
+static const int UDP_HISTORY_SIZE = 4;
+
 ObserverUDPSender::ObserverUDPSender()
     : QThread()
 {
@@ -71,22 +74,21 @@ void ObserverUDPSender::init()
     subjectType = TObsUnknown;
 
     paused = false;
+    finished = false;
     failureToSend = false;
     compressDatagram = true;   //  //  false;
 
     // default port
     port = DEFAULT_PORT;
 
-    if (compressDatagram)
-        datagramRatio = 50.0;
-    else
-        datagramRatio = 6.0;
-
-    datagramSize = MINIMUM_DATAGRAM_SIZE * datagramRatio;
+    datagramSize = UDP_CHUNK_DATA_SIZE;
     stateCount = 0;
     msgCount = 0;
+    sequence = 0;
 
+    // binds to an ephemeral port to receive the requests for lost chunks
     udpSocket = new QUdpSocket();
+    udpSocket->bind();
     hosts = new QList<QHostAddress>();
 
     udpGUI = new UdpSenderGUI();
@@ -109,22 +111,13 @@ bool ObserverUDPSender::draw(QDataStream &state)
     QString msg;
     state >> msg;
 
-    if (!sendDatagram(msg))
-    {
-        datagramRatio *= 0.5;
-        datagramSize = MINIMUM_DATAGRAM_SIZE * datagramRatio;
-        QString str;
+    processNacks();
 
-        if (datagramSize < 32)
-        {
-            str = "Warning: The datagram's size is low that 32 bytes. "
-                "The Udp Sender will stop to send datagrams.";
-            udpGUI->appendMessage(str);
-            failureToSend = true;
-            return false;
-        }
-        str = QString("Warning: Reducing the datagram's size for %1 bytes.").arg(datagramSize);
+    if (!sendFrame(msg.toLatin1(), 0))
+    {
+        QString str = "Warning: The Udp Sender will stop to send datagrams.";
         udpGUI->appendMessage(str);
+        failureToSend = true;
 
         if (execModes != Quiet){
             lua_getglobal(L, "customWarning");
@@ -132,6 +125,7 @@ bool ObserverUDPSender::draw(QDataStream &state)
             lua_pushnumber(L, 4);
             lua_call(L, 2, 0);
         }
+        return false;
     }
     qApp->processEvents();
     return true;
@@ -165,43 +159,45 @@ void ObserverUDPSender::setAttributes(QStringList& attribs)
     //sendDatagram(msg);
 }
 
-bool ObserverUDPSender::sendDatagram(QString& msg)
+bool ObserverUDPSender::sendFrame(const QByteArray &data, quint8 flags)
 {
-    QByteArray data(msg.toLatin1().constData(), msg.size());
+    QList<QByteArray> chunks;
 
-    qint64 bytesWritten = 0, bytesRead = data.size();
-    int pos = 0;
+    if (compressDatagram)
+        chunks = UdpFrameEncoder::split(sequence, qCompress(data, COMPRESS_RATIO),
+                                        flags | UDP_FRAME_COMPRESSED, datagramSize);
+    else
+        chunks = UdpFrameEncoder::split(sequence, data, flags, datagramSize);
 
-    while (bytesRead > 0)
+    if (chunks.isEmpty())
     {
-        QByteArray datagram;
-
-        QDataStream out(&datagram, QIODevice::WriteOnly);
-        out.setVersion(QDataStream::Qt_4_6);
+        QString error;
+        error = tr("Warning: State with %1 bytes is too large to be sent, it will be discarded.")
+            .arg(data.size());
+        udpGUI->appendMessage(error);
 
-        out <<(qint64) data.size();
-        out <<(qint64) datagramSize;
-        out <<(qint64) pos;
-        out << compressDatagram; // flag formato do datagrama transmitido
-
-        if (compressDatagram)
-        {
-            out << qCompress(data.mid(pos, datagramSize), COMPRESS_RATIO);
+#ifdef TME_LUA_5_2
+        if (execModes != Quiet){
+            lua_getglobal(L, "customWarning");
+            lua_pushstring(L, error.toLatin1().constData());
+            lua_pushnumber(L, 4);
+            lua_call(L, 2, 0);
         }
-        else
-        {
-            out << data.mid(pos, datagramSize);
+#else
+
+        if (execModes != Quiet){
+            qWarning("%s", qPrintable(error));
         }
+#endif
 
+        return false;
+    }
+
+    for (int c = 0; c < chunks.size(); c++)
+    {
         for (int i = 0; i < hosts->size(); i++)
         {
-            bytesWritten = udpSocket->writeDatagram(datagram, hosts->at(i), port);
-
-            udpSocket->flush();
-
-            udpGUI->appendMessage(QLabel::tr("Datagram sent for %1").arg(hosts->at(i).toString()));
-
-            if (bytesWritten == -1)
+            if (udpSocket->writeDatagram(chunks.at(c), hosts->at(i), port) == -1)
             {
                 QString error;
                 error = tr("Warning: Failed on send message. Socket Error: %1")
@@ -225,43 +221,52 @@ bool ObserverUDPSender::sendDatagram(QString& msg)
                 return false;
             }
         }
-
-        if (compressDatagram)
-        {
-            bytesRead -= datagramSize;
-            pos += datagramSize;
-        }
-        else
-        {
-            bytesRead -= bytesWritten;
-            pos += bytesWritten;
-        }
-        msgCount++;
-
-        // faz um pausa antes de continuar a enviar
-        // delay((float) 0.01); // 0.0125);
-        // delay((float) 0.0125);
-        qApp->processEvents();
     }
 
-    completeState(COMPLETE_STATE.toLatin1());
+    history.insert(sequence, chunks);
+    history.remove(sequence - UDP_HISTORY_SIZE);
+    sequence++;
 
-    msgCount++;
+    msgCount += chunks.size();
     stateCount++;
 
     udpGUI->setMessagesSent(msgCount);
     udpGUI->setStateSent(stateCount);
-
-    //udpGUI->appendMessage(tr("compressionSum: %1 / %2 = %3")
-    //    .arg(compressionSum).arg(compressionCount).arg(compressionSum / compressionCount));
-    //udpGUI->appendMessage(tr("renderingSum: %1 / %2 = %3")
-    //    .arg(renderingSum).arg(renderingCount).arg(renderingSum / renderingCount));
-
     udpGUI->appendMessage(tr("States sent: %1.\n").arg(stateCount));
 
     return true;
 }
 
+void ObserverUDPSender::processNacks()
+{
+    while (udpSocket->hasPendingDatagrams())
+    {
+        QByteArray datagram;
+        QHostAddress host;
+        quint16 hostPort;
+
+        datagram.resize(udpSocket->pendingDatagramSize());
+        udpSocket->readDatagram(datagram.data(), datagram.size(), &host, &hostPort);
+
+        quint32 frame;
+        QVector<quint16> missing;
+
+        if (!UdpFrameEncoder::readNack(datagram, frame, missing) || !history.contains(frame))
+            continue;
+
+        const QList<QByteArray> &chunks = history[frame];
+
+        for (int i = 0; i < missing.size(); i++)
+        {
+            if (missing.at(i) < chunks.size())
+            {
+                udpSocket->writeDatagram(chunks.at(missing.at(i)), host, port);
+                msgCount++;
+            }
+        }
+    }
+}
+
 void ObserverUDPSender::setPort(int prt)
 {
     port = prt;
@@ -275,20 +280,24 @@ int ObserverUDPSender::getPort()
 
 void ObserverUDPSender::addHost(const QString & host)
 {
-    QHostAddress hostAddress(host);
+    QHostAddress hostAddress;
+
+    // names such as "localhost" are resolved, as QHostAddress only parses addresses
+    if (!hostAddress.setAddress(host))
+    {
+        QList<QHostAddress> addresses = QHostInfo::fromName(host).addresses();
+        for (int i = 0; i < addresses.size() && hostAddress.isNull(); i++)
+        {
+            if (addresses.at(i).protocol() == QAbstractSocket::IPv4Protocol)
+                hostAddress = addresses.at(i);
+        }
+    }
     hosts->push_back(hostAddress);
 }
 
 void ObserverUDPSender::setCompressDatagram(bool on)
 {
     compressDatagram = on;
-
-    if (compressDatagram)
-        datagramRatio = 50.0;
-    else
-        datagramRatio = 6.0;
-
-    datagramSize = MINIMUM_DATAGRAM_SIZE * datagramRatio;
     udpGUI->setCompressDatagram(compressDatagram);
 }
 
@@ -297,44 +306,17 @@ bool ObserverUDPSender::getCompressDatagram()
     return compressDatagram;
 }
 
-bool ObserverUDPSender::completeState(const QByteArray & flag)
-{
-    qint64 bytesWritten = 0;
-    QByteArray datagram, data;
-    data = QByteArray(flag);
-
-    QDataStream out(&datagram, QIODevice::WriteOnly);
-    // out.setVersion(QDataStream::Qt_4_6);
-
-    out <<(qint64) data.size();
-    out <<(qint64) datagramSize;
-    out <<(qint64) -1;
-    out << compressDatagram;
-
-    if (compressDatagram)
-       out << qCompress(data, 1);
-    else
-        out << data;
-
-    for (int i = 0; i < hosts->size(); i++)
-    {
-        bytesWritten = udpSocket->writeDatagram(datagram, hosts->at(i), port);
-        udpSocket->flush();
-
-        if (bytesWritten == -1)
-            return false;
-    }
-    return true;
-}
-
 void ObserverUDPSender::setModelTime(double time)
 {
-    if (time == -1)
-        completeState(COMPLETE_SIMULATION.toLatin1());
+    if ((time == -1) && !finished)
+        finished = sendFrame(COMPLETE_SIMULATION.toLatin1(), UDP_FRAME_END);
 }
 
 int ObserverUDPSender::close()
 {
+    // the receivers learn that the simulation finished even if the observer is killed before
+    setModelTime(-1);
+
     udpSocket->abort();
     QThread::exit(0);
     return 0;
@@ -36,6 +36,7 @@ extern "C"
 #include <QDialog>
 #include <QThread>
 #include <QHostAddress>
+#include <QHash>
 
 class QUdpSocket;
 
@@ -43,6 +44,9 @@ namespace TerraMEObserver {
 
 /**
  * \brief Sends the attributes observed via UDP Protocol
+ * Each state is a frame with a sequence number, compressed as a whole and
+ * split in chunks that fit in a datagram (see UdpFrameEncoder). The last
+ * frames are kept so that the chunks lost by a receiver can be sent again.
  * \see ObserverInterf
  * \see QThread,
  * \author Antonio Jos? da Cunha Rodrigues
@@ -156,21 +160,19 @@ private:
     void init();
 
     /**
-     * Sends the datagram
-     * \param msg a reference to the datagram composes of the subject internal state
-     * \return boolean, \a true if the datagram could be sent.
+     * Sends a frame split in chunks that fit in a datagram
+     * \param data the frame content
+     * \param flags the frame flags
+     * \return boolean, \a true if the frame could be sent.
      * Otherwise, returns \a false.
+     * \see QByteArray
      */
-    bool sendDatagram(QString & msg);
+    bool sendFrame(const QByteArray &data, quint8 flags);
 
     /**
-     *  Sends the informations that indicates that complete state was sent
-     * \param flag a reference to the QByteArray \a flag
-     * \return boolean, \a true if the complete state could be sent.
-     * Otherwise, returns \a false.
-     * \see QByteArray
+     * Resends the chunks requested by the receivers
      */
-    bool completeState(const QByteArray &flag);
+    void processNacks();
 
     TypesOfObservers observerType;
     TypesOfSubjects subjectType;
@@ -178,7 +180,9 @@ private:
     QList<QHostAddress> *hosts;
     int port, stateCount, msgCount;
     int datagramSize;
-    float datagramRatio;
+
+    quint32 sequence;
+    QHash<quint32, QList<QByteArray> > history;
 
     QUdpSocket *udpSocket;
 
@@ -188,6 +192,7 @@ private:
 
     bool failureToSend, compressDatagram;
     bool paused;
+    bool finished; ///< true after the end of the simulation was sent
 };
 
 } // namespace TerraMEObserver
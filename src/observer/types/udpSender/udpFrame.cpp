@@ -0,0 +1,235 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "udpFrame.h"
+
+#include <QtEndian>
+
+#include <string.h>
+
+using namespace TerraMEObserver;
+
+QList<QByteArray> UdpFrameEncoder::split(quint32 sequence, const QByteArray &frame,
+                                         quint8 flags, int chunkSize)
+{
+    QList<QByteArray> datagrams;
+    int count = frame.isEmpty() ? 1 : (frame.size() + chunkSize - 1) / chunkSize;
+
+    if (count > UDP_MAX_CHUNKS)
+        return datagrams;
+
+    for (int i = 0; i < count; i++)
+    {
+        int pos = i * chunkSize;
+        int size = qMin(chunkSize, frame.size() - pos);
+
+        QByteArray datagram(UDP_CHUNK_HEADER_SIZE + size, '\0');
+        uchar *header = (uchar *) datagram.data();
+
+        qToBigEndian<quint32>(UDP_CHUNK_MAGIC, header);
+        qToBigEndian<quint32>(sequence, header + 4);
+        qToBigEndian<quint16>(i, header + 8);
+        qToBigEndian<quint16>(count, header + 10);
+        qToBigEndian<quint32>(frame.size(), header + 12);
+        header[16] = flags;
+
+        if (size > 0)
+            memcpy(datagram.data() + UDP_CHUNK_HEADER_SIZE, frame.constData() + pos, size);
+
+        datagrams.append(datagram);
+    }
+    return datagrams;
+}
+
+QByteArray UdpFrameEncoder::nack(quint32 sequence, const QVector<quint16> &missing)
+{
+    QByteArray datagram(10 + 2 * missing.size(), '\0');
+    uchar *data = (uchar *) datagram.data();
+
+    qToBigEndian<quint32>(UDP_NACK_MAGIC, data);
+    qToBigEndian<quint32>(sequence, data + 4);
+    qToBigEndian<quint16>(missing.size(), data + 8);
+
+    for (int i = 0; i < missing.size(); i++)
+        qToBigEndian<quint16>(missing.at(i), data + 10 + 2 * i);
+
+    return datagram;
+}
+
+bool UdpFrameEncoder::readNack(const QByteArray &datagram, quint32 &sequence, QVector<quint16> &missing)
+{
+    const uchar *data = (const uchar *) datagram.constData();
+
+    if ((datagram.size() < 10) || (qFromBigEndian<quint32>(data) != UDP_NACK_MAGIC))
+        return false;
+
+    sequence = qFromBigEndian<quint32>(data + 4);
+    int count = qFromBigEndian<quint16>(data + 8);
+
+    if (datagram.size() < 10 + 2 * count)
+        return false;
+
+    missing.resize(count);
+    for (int i = 0; i < count; i++)
+        missing[i] = qFromBigEndian<quint16>(data + 10 + 2 * i);
+
+    return true;
+}
+
+UdpFrameAssembler::UdpFrameAssembler(int window)
+    : last(0), started(false), delivered(0), anyDelivered(false),
+      window(window < 1 ? 1 : window), lostFrames(0)
+{
+}
+
+bool UdpFrameAssembler::add(const QByteArray &datagram, QByteArray &frame, quint8 &flags)
+{
+    const uchar *header = (const uchar *) datagram.constData();
+
+    if ((datagram.size() < UDP_CHUNK_HEADER_SIZE)
+        || (qFromBigEndian<quint32>(header) != UDP_CHUNK_MAGIC))
+        return false;
+
+    quint32 sequence = qFromBigEndian<quint32>(header + 4);
+    int index = qFromBigEndian<quint16>(header + 8);
+    int count = qFromBigEndian<quint16>(header + 10);
+    quint32 size = qFromBigEndian<quint32>(header + 12);
+
+    if ((count == 0) || (index >= count))
+        return false;
+
+    if (started && ((qint32) (last - sequence) >= window))
+        return false; // the frame already left the window
+
+    if (anyDelivered && ((qint32) (sequence - delivered) <= 0))
+        return false; // a newer frame was already delivered
+
+    if (!started || ((qint32) (sequence - last) > 0))
+    {
+        last = sequence;
+        started = true;
+
+        QMutableHashIterator<quint32, Pending> it(pending);
+        while (it.hasNext())
+        {
+            it.next();
+            if ((qint32) (last - it.key()) >= window)
+            {
+                if (it.value().received < it.value().chunks.size())
+                    lostFrames++;
+                it.remove();
+            }
+        }
+    }
+
+    if (!pending.contains(sequence))
+    {
+        Pending p;
+        p.chunks.resize(count);
+        p.arrived.fill(false, count);
+        p.received = 0;
+        p.size = size;
+        p.flags = header[16];
+        pending.insert(sequence, p);
+    }
+
+    Pending &p = pending[sequence];
+
+    if ((p.arrived.size() != count) || (p.received == count) || p.arrived.at(index))
+        return false; // duplicated or inconsistent chunk
+
+    p.chunks[index] = datagram.mid(UDP_CHUNK_HEADER_SIZE);
+    p.arrived[index] = true;
+    p.received++;
+
+    if (p.received < count)
+        return false;
+
+    frame.clear();
+    frame.reserve(p.size);
+    for (int i = 0; i < count; i++)
+        frame.append(p.chunks.at(i));
+
+    flags = p.flags;
+    bool valid = (quint32) frame.size() == p.size;
+
+    // the older frames still waiting for chunks will never be delivered
+    delivered = sequence;
+    anyDelivered = true;
+
+    QMutableHashIterator<quint32, Pending> it(pending);
+    while (it.hasNext())
+    {
+        it.next();
+        if ((qint32) (delivered - it.key()) > 0)
+        {
+            if (it.value().received < it.value().chunks.size())
+                lostFrames++;
+            it.remove();
+        }
+    }
+    pending.remove(sequence);
+
+    return valid;
+}
+
+QList<quint32> UdpFrameAssembler::incomplete() const
+{
+    QList<quint32> frames;
+
+    for (QHash<quint32, Pending>::const_iterator it = pending.constBegin();
+         it != pending.constEnd(); ++it)
+    {
+        if ((it.key() != last) && (it.value().received < it.value().arrived.size()))
+            frames.append(it.key());
+    }
+    return frames;
+}
+
+QVector<quint16> UdpFrameAssembler::missing(quint32 sequence) const
+{
+    QVector<quint16> chunks;
+
+    QHash<quint32, Pending>::const_iterator it = pending.constFind(sequence);
+    if (it == pending.constEnd())
+        return chunks;
+
+    for (int i = 0; i < it.value().arrived.size(); i++)
+    {
+        if (!it.value().arrived.at(i))
+            chunks.append(i);
+    }
+    return chunks;
+}
+
+int UdpFrameAssembler::lost() const
+{
+    return lostFrames;
+}
+
+void UdpFrameAssembler::clear()
+{
+    pending.clear();
+    started = false;
+    anyDelivered = false;
+}
@@ -0,0 +1,163 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#ifndef UDP_FRAME_H
+#define UDP_FRAME_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+namespace TerraMEObserver {
+
+/// Identifies a chunk of a frame sent by ObserverUDPSender
+static const quint32 UDP_CHUNK_MAGIC = 0x544d5543; // "TMUC"
+
+/// Identifies a request for the chunks that did not arrive
+static const quint32 UDP_NACK_MAGIC = 0x544d554e; // "TMUN"
+
+/// Number of bytes of the chunk header
+static const int UDP_CHUNK_HEADER_SIZE = 17;
+
+/// Maximum size of the data of a chunk, so that a datagram fits in an Ethernet MTU
+static const int UDP_CHUNK_DATA_SIZE = 1400;
+
+/// Maximum number of chunks of a frame, as the chunk count is a 16-bit field
+static const int UDP_MAX_CHUNKS = 65535;
+
+/// Flag of a frame whose content was compressed with qCompress
+static const quint8 UDP_FRAME_COMPRESSED = 0x01;
+
+/// Flag of the frame sent at the end of the simulation
+static const quint8 UDP_FRAME_END = 0x02;
+
+/**
+ * \brief Splits frames in chunks that fit in a datagram.
+ * Each chunk starts with a header composed by UDP_CHUNK_MAGIC, the frame
+ * sequence number, the chunk index, the number of chunks, the frame size
+ * (all of them big-endian) and one byte of flags, followed by the data.
+ * The frame is compressed as a whole before being split.
+ * \file udpFrame.h
+ */
+class UdpFrameEncoder
+{
+public:
+    /**
+     * Splits a frame
+     * \param sequence the frame sequence number
+     * \param frame the frame content
+     * \param flags the frame flags
+     * \param chunkSize the maximum size of the data of each chunk
+     * \return the datagrams of the frame, or an empty list if the frame
+     * needs more than UDP_MAX_CHUNKS chunks
+     */
+    static QList<QByteArray> split(quint32 sequence, const QByteArray &frame,
+                                   quint8 flags, int chunkSize = UDP_CHUNK_DATA_SIZE);
+
+    /**
+     * Builds a request for the missing chunks of a frame
+     * \param sequence the frame sequence number
+     * \param missing the indexes of the missing chunks
+     */
+    static QByteArray nack(quint32 sequence, const QVector<quint16> &missing);
+
+    /**
+     * Reads a request built by nack()
+     * \return \a false if the datagram is not a request
+     */
+    static bool readNack(const QByteArray &datagram, quint32 &sequence, QVector<quint16> &missing);
+};
+
+/**
+ * \brief Reassembles the frames split by UdpFrameEncoder.
+ * Chunks can arrive in any order. A frame is delivered once all its
+ * chunks have arrived and the incomplete frames that fall out of the
+ * window are counted as lost. Frames are delivered in order: once a
+ * frame is delivered, the older ones are discarded, as they would take
+ * the observer back in time.
+ * \file udpFrame.h
+ */
+class UdpFrameAssembler
+{
+public:
+    /**
+     * Constructor
+     * \param window the number of incomplete frames kept waiting for chunks
+     */
+    UdpFrameAssembler(int window = 4);
+
+    /**
+     * Adds a datagram
+     * \param datagram the received datagram
+     * \param frame receives the frame if it was completed by this datagram
+     * \param flags receives the flags of the completed frame
+     * \return \a true if a frame was completed
+     */
+    bool add(const QByteArray &datagram, QByteArray &frame, quint8 &flags);
+
+    /**
+     * Gets the incomplete frames older than the last frame with some
+     * chunk received, which probably lost some of their chunks
+     * \return the sequence numbers
+     */
+    QList<quint32> incomplete() const;
+
+    /**
+     * Gets the indexes of the chunks of a frame that did not arrive
+     * \param sequence the frame sequence number
+     */
+    QVector<quint16> missing(quint32 sequence) const;
+
+    /**
+     * Gets the number of frames discarded without all their chunks
+     */
+    int lost() const;
+
+    /**
+     * Removes all the incomplete frames
+     */
+    void clear();
+
+private:
+    struct Pending
+    {
+        QVector<QByteArray> chunks;
+        QVector<bool> arrived;
+        int received;
+        quint32 size;
+        quint8 flags;
+    };
+
+    QHash<quint32, Pending> pending;
+    quint32 last;
+    bool started;
+    quint32 delivered; ///< sequence number of the last frame delivered
+    bool anyDelivered;
+    int window;
+    int lostFrames;
+};
+
+} // namespace TerraMEObserver
+
+#endif // UDP_FRAME_H